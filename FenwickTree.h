@@ -0,0 +1,71 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include <vector>
+
+// 树状数组：单点修改、前缀和、按前缀和定位均为 O(log n)
+class FenwickTree
+{
+public:
+    explicit FenwickTree(int n = 0)
+    {
+        resize(n);
+    }
+
+    int size() const { return static_cast<int>(values.size()); }
+
+    // 扩容并按现有值重建：每个节点先放自身的值，再按下标顺序累加到父节点，O(n)
+    void resize(int n)
+    {
+        values.resize(n, 0);
+        tree.assign(n + 1, 0);
+        total = 0;
+        for (int i = 1; i <= n; ++i)
+        {
+            tree[i] += values[i - 1];
+            total += values[i - 1];
+            int parent = i + (i & -i);
+            if (parent <= n)
+                tree[parent] += tree[i];
+        }
+    }
+
+    long long get(int index) const { return values[index]; }
+    long long sum() const { return total; }
+
+    void set(int index, long long value)
+    {
+        long long delta = value - values[index];
+        if (delta == 0)
+            return;
+        values[index] = value;
+        total += delta;
+        for (int j = index + 1; j < static_cast<int>(tree.size()); j += j & -j)
+            tree[j] += delta;
+    }
+
+    // 返回满足 prefix(index) > target 的最小下标（0 <= target < sum()）
+    int find(long long target) const
+    {
+        int position = 0;
+        int step = 1;
+        while (step * 2 < static_cast<int>(tree.size()))
+            step *= 2;
+        for (; step > 0; step /= 2)
+        {
+            if (position + step < static_cast<int>(tree.size()) && tree[position + step] <= target)
+            {
+                position += step;
+                target -= tree[position];
+            }
+        }
+        return position;
+    }
+
+private:
+    std::vector<long long> values; // 各下标的当前值
+    std::vector<long long> tree;   // 从 1 开始编号的树状数组
+    long long total = 0;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <queue>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// 固定大小的线程池，任务先进先出；析构时执行完所有已提交的任务再退出
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::condition_variable idle;
+    size_t running = 0;
+    bool stopping = false;
+
+    void workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this]()
+                        { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop();
+                running++;
+            }
+            task();
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                running--;
+                if (tasks.empty() && running == 0)
+                    idle.notify_all();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads)
+    {
+        if (threads == 0)
+            threads = 1;
+        for (size_t i = 0; i < threads; ++i)
+            workers.emplace_back([this]()
+                                 { workerLoop(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    // 提交任务
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push(std::move(task));
+        }
+        cv.notify_one();
+    }
+
+    // 等待所有已提交的任务执行完毕
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        idle.wait(lock, [this]()
+                  { return tasks.empty() && running == 0; });
+    }
+
+    size_t size() const { return workers.size(); }
+};
+
+#endif
@@ -0,0 +1,167 @@
+// address_space.h
+#ifndef ADDRESS_SPACE_H
+#define ADDRESS_SPACE_H
+
+#include "checkpoint.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+// 进程的数据地址空间，按字（int）寻址。页表是 64 叉的基数树，叶子是 64 字的页，
+// 树的各级节点与页都以引用计数共享。复制地址空间（fork）只复制根指针，是 O(1) 的；
+// 写入时沿根到页的路径把仍被共享的节点和页各复制一份（写时复制，每级只复制 64 个指针），
+// 因此 fork 的代价与之后实际写入的页数成正比，而不是与地址空间大小成正比。
+// 从未写过的页不分配，读出为 0
+class AddressSpace
+{
+public:
+    static constexpr int PAGE_WORDS = 64;
+    static constexpr int FANOUT = 64; // 页表节点的分支数
+
+    explicit AddressSpace(int _words = 0) : words(std::max(0, _words))
+    {
+        for (long long capacity = FANOUT; capacity < pageCount(); capacity *= FANOUT)
+            levels++;
+    }
+
+    int size() const { return words; }
+    int pageCount() const { return (words + PAGE_WORDS - 1) / PAGE_WORDS; }
+
+    // 写时复制的页数（不含首次写入时分配的零页），复制地址空间时不随之复制
+    long long copiedPages() const { return pageCopies; }
+
+    // 地址越界时返回 false
+    bool read(int address, int &value) const
+    {
+        if (address < 0 || address >= words)
+            return false;
+        const Page *page = pageAt(address / PAGE_WORDS);
+        value = page ? (*page)[address % PAGE_WORDS] : 0;
+        return true;
+    }
+
+    bool write(int address, int value)
+    {
+        if (address < 0 || address >= words)
+            return false;
+        int index = address / PAGE_WORDS;
+        if (!root)
+            root = std::make_shared<Node>();
+        else if (root.use_count() > 1)
+            root = std::make_shared<Node>(*root);
+
+        Node *node = root.get();
+        for (int level = levels - 1; level > 0; --level)
+        {
+            std::shared_ptr<void> &slot = node->slots[slotOf(index, level)];
+            if (!slot)
+                slot = std::make_shared<Node>();
+            else if (slot.use_count() > 1)
+                slot = std::make_shared<Node>(*static_cast<Node *>(slot.get()));
+            node = static_cast<Node *>(slot.get());
+        }
+
+        std::shared_ptr<void> &leaf = node->slots[slotOf(index, 0)];
+        if (!leaf)
+            leaf = std::make_shared<Page>();
+        else if (leaf.use_count() > 1)
+        {
+            leaf = std::make_shared<Page>(*static_cast<Page *>(leaf.get()));
+            pageCopies++;
+        }
+        (*static_cast<Page *>(leaf.get()))[address % PAGE_WORDS] = value;
+        return true;
+    }
+
+    // 按页号顺序访问已分配的页：visit(页号, 指向该页 PAGE_WORDS 个字的指针)
+    template <typename Visitor>
+    void forEachPage(Visitor &&visit) const
+    {
+        for (int index = 0; index < pageCount(); ++index)
+            if (const Page *page = pageAt(index))
+                visit(index, page->data());
+    }
+
+    // 写入整页（换入时使用），页号越界时返回 false
+    bool writePage(int index, const int *data)
+    {
+        if (index < 0 || index >= pageCount())
+            return false;
+        for (int offset = 0; offset < PAGE_WORDS && index * PAGE_WORDS + offset < words; ++offset)
+            write(index * PAGE_WORDS + offset, data[offset]);
+        return true;
+    }
+
+    // 复制出一个与本地址空间共享全部页面的副本
+    AddressSpace fork() const
+    {
+        AddressSpace copy(words);
+        copy.root = root;
+        return copy;
+    }
+
+    // 只保存已分配的页；恢复后各地址空间的页面各自独立，不再共享
+    void save(CheckpointWriter &out) const
+    {
+        out.write(words);
+        std::vector<int> used;
+        for (int index = 0; index < pageCount(); ++index)
+            if (pageAt(index))
+                used.push_back(index);
+        out.write(static_cast<uint32_t>(used.size()));
+        for (int index : used)
+        {
+            out.write(index);
+            out.write(*pageAt(index));
+        }
+    }
+
+    void restore(CheckpointReader &in)
+    {
+        *this = AddressSpace(in.read<int>());
+        uint32_t count = in.readCount(static_cast<uint32_t>(pageCount()));
+        for (uint32_t i = 0; i < count && in.ok(); ++i)
+        {
+            int index = in.read<int>();
+            Page page = in.read<Page>();
+            if (!writePage(index, page.data()))
+            {
+                in.fail();
+                return;
+            }
+        }
+        pageCopies = 0;
+    }
+
+private:
+    using Page = std::array<int, PAGE_WORDS>;
+
+    // 页表节点；最底层节点的槽指向 Page，其余指向下一级 Node
+    struct Node
+    {
+        std::shared_ptr<void> slots[FANOUT];
+    };
+
+    static int slotOf(int index, int level)
+    {
+        for (int i = 0; i < level; ++i)
+            index /= FANOUT;
+        return index % FANOUT;
+    }
+
+    const Page *pageAt(int index) const
+    {
+        const Node *node = root.get();
+        for (int level = levels - 1; node != nullptr && level > 0; --level)
+            node = static_cast<const Node *>(node->slots[slotOf(index, level)].get());
+        return node ? static_cast<const Page *>(node->slots[slotOf(index, 0)].get()) : nullptr;
+    }
+
+    std::shared_ptr<Node> root; // 为空表示还没有写过任何页
+    int words;
+    int levels = 1; // 页表的层数
+    long long pageCopies = 0;
+};
+
+#endif // ADDRESS_SPACE_H
@@ -0,0 +1,177 @@
+// bench.cpp
+// 调度策略基准：对同一组随机生成的进程依次运行各内置策略，比较每个模拟 tick 的宿主机耗时
+#include "cpu.h"
+#include "allhead.h"
+#include "pcb.h"
+#include "workload.h"
+#include "program.h"
+#include <cstdlib>
+#include <random>
+
+template <typename Policy>
+void runBenchmark(const char *label, Policy &policy, const std::vector<ProcessSpec> &workload, int timeSlice)
+{
+    CPU cpu(timeSlice);
+    cpu.setSimulatedDelays(0, 0);
+    cpu.setVerbose(false);
+
+    std::vector<std::unique_ptr<PCB>> processes;
+    for (const auto &spec : workload)
+    {
+        processes.emplace_back(spec.createPCB());
+        processes.back()->setCodeInfo(0, 0);
+        cpu.addProcess(processes.back().get());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    cpu.manageTimeAndSchedule(policy);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    int ticks = std::max(1, cpu.getCurrentTime());
+    std::cout << label << ": " << ticks << " ticks, " << elapsed.count() / 1e6 << " ms, "
+              << elapsed.count() / ticks << " ns/tick" << std::endl;
+#ifdef OSSIM_PHASE_TIMERS
+    cpu.displayPhaseProfile();
+#endif
+}
+
+// 协程进程：交替进行 CPU 区间与 I/O
+static Program ioBoundWorker(int rounds, int burst, int io)
+{
+    for (int i = 0; i < rounds; ++i)
+    {
+        co_await computeFor(burst);
+        co_await ioWait(io);
+    }
+}
+
+static Program producer(Channel &channel, int rounds)
+{
+    for (int i = 0; i < rounds; ++i)
+    {
+        co_await computeFor(1);
+        co_await sendTo(channel, i);
+    }
+}
+
+static Program consumer(Channel &channel, int rounds)
+{
+    for (int i = 0; i < rounds; ++i)
+    {
+        int job = co_await receiveFrom(channel);
+        co_await computeFor(1 + job % 3);
+    }
+}
+
+// 协程进程模型：一半进程做计算与 I/O，另一半两两组成生产者/消费者，统计每秒的进程切换次数
+void runProgramBenchmark(int count, unsigned long long seed, int timeSlice)
+{
+    CPU cpu(timeSlice);
+    cpu.setSimulatedDelays(0, 0);
+    cpu.setVerbose(false);
+
+    std::mt19937_64 random(seed);
+    const int rounds = 50;
+    std::vector<std::unique_ptr<PCB>> processes;
+    std::vector<std::unique_ptr<Channel>> channels;
+    for (int i = 0; i < count; ++i)
+    {
+        processes.emplace_back(new PCB(i + 1, 1, static_cast<int>(random() % 100)));
+        if (i % 4 < 2)
+            cpu.addProgram(processes.back().get(), ioBoundWorker(rounds, 1 + random() % 4, 1 + random() % 8));
+        else if (i % 4 == 2)
+        {
+            channels.emplace_back(new Channel());
+            cpu.addProgram(processes.back().get(), producer(*channels.back(), rounds));
+        }
+        else
+            cpu.addProgram(processes.back().get(), consumer(*channels.back(), rounds));
+    }
+
+    RoundRobinPolicy policy(timeSlice);
+    auto start = std::chrono::steady_clock::now();
+    cpu.manageTimeAndSchedule(policy);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    long long switches = cpu.getContextSwitches();
+    std::cout << "Coroutine processes (Round Robin): " << count << " programs, " << cpu.getCurrentTime() << " ticks, "
+              << switches << " switches, " << elapsed.count() * 1e3 << " ms, "
+              << switches / std::max(elapsed.count(), 1e-9) / 1e6 << " M switches/s" << std::endl;
+}
+
+// 预派生服务器：父进程先写入地址空间中分散的页面，再派生 workers 个子进程并逐个回收；
+// 每个子进程只写 touches 个页面。地址空间写时复制，派生的代价应与地址空间大小无关
+static Program forkedWorker(int id, int touches)
+{
+    for (int i = 0; i < touches; ++i)
+        co_await storeWord(i * AddressSpace::PAGE_WORDS, id);
+    co_await computeFor(1);
+    co_await exitProcess(id % 256);
+}
+
+static Program preforkServer(int workers, int touches, int memoryWords)
+{
+    for (int address = 0; address < memoryWords; address += AddressSpace::PAGE_WORDS * AddressSpace::FANOUT)
+        co_await storeWord(address, 1);
+    for (int i = 0; i < workers; ++i)
+        co_await forkProcess(forkedWorker(i, touches));
+    while ((co_await waitChild()).pid >= 0)
+    {
+    }
+}
+
+void runForkBenchmark(int workers, int memoryWords, int timeSlice)
+{
+    CPU cpu(timeSlice);
+    cpu.setSimulatedDelays(0, 0);
+    cpu.setVerbose(false);
+
+    PCB server(1, 1, 0, 0, PCB::READY, nullptr, memoryWords);
+    cpu.addProgram(&server, preforkServer(workers, 4, memoryWords));
+    RoundRobinPolicy policy(timeSlice);
+    auto start = std::chrono::steady_clock::now();
+    cpu.manageTimeAndSchedule(policy);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Fork/exit/wait (" << memoryWords << "-word address space): " << workers << " children, "
+              << elapsed.count() * 1e3 << " ms, " << workers / std::max(elapsed.count(), 1e-9) / 1e3 << " K forks/s" << std::endl;
+}
+
+// 用法：sched_bench [进程数] [随机种子] [时间片]
+int main(int argc, char *argv[])
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 2000;
+    unsigned long long seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+    int timeSlice = argc > 3 ? std::atoi(argv[3]) : 4;
+
+    std::vector<ProcessSpec> workload = Workload::generate(count, seed);
+    std::cout << "Workload: " << count << " processes, seed " << seed << ", time slice " << timeSlice << std::endl;
+
+    RoundRobinPolicy roundRobin(timeSlice);
+    runBenchmark("Round Robin", roundRobin, workload, timeSlice);
+    FcfsPolicy fcfs;
+    runBenchmark("FCFS", fcfs, workload, timeSlice);
+    PriorityPolicy priority;
+    runBenchmark("Highest Priority First", priority, workload, timeSlice);
+    ShortestJobPolicy sjf(false);
+    runBenchmark("SJF", sjf, workload, timeSlice);
+    ShortestJobPolicy srtf(true);
+    runBenchmark("SRTF", srtf, workload, timeSlice);
+    RealTimePolicy edf(false);
+    runBenchmark("EDF", edf, workload, timeSlice);
+    CfsPolicy cfs;
+    runBenchmark("CFS", cfs, workload, timeSlice);
+    LotteryPolicy lottery(timeSlice);
+    runBenchmark("Lottery", lottery, workload, timeSlice);
+    StridePolicy stride(timeSlice);
+    runBenchmark("Stride", stride, workload, timeSlice);
+
+    // 同一策略经虚函数分派运行，对比静态绑定的开销差异
+    std::unique_ptr<SchedulerPolicy> plugin(new RoundRobinPolicy(timeSlice));
+    runBenchmark("Round Robin (virtual)", *plugin, workload, timeSlice);
+
+    runProgramBenchmark(count, seed, timeSlice);
+    runForkBenchmark(count, 1 << 10, timeSlice);
+    runForkBenchmark(count, 1 << 24, timeSlice);
+    return 0;
+}
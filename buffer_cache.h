@@ -0,0 +1,202 @@
+// buffer_cache.h
+#ifndef BUFFER_CACHE_H
+#define BUFFER_CACHE_H
+
+#include "intrusive_list.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// 模拟的块设备：每块 BLOCK_WORDS 个字，内容保存在内存中。请求按提交顺序串行完成：
+// 与上一次访问的块不相邻时先花 seekTicks 寻道，每块再花 transferTicks 传输，因此顺序访问比随机访问快得多。
+// 数据在提交时即已复制，返回的完成时刻只决定请求者要等待多久
+class BlockDevice
+{
+public:
+    static constexpr int BLOCK_WORDS = 64;
+    using Block = std::array<int, BLOCK_WORDS>;
+
+    BlockDevice(int _blocks, int _seekTicks, int _transferTicks)
+        : blocks(std::max(1, _blocks)), seekTicks(_seekTicks), transferTicks(std::max(1, _transferTicks)) {}
+
+    int size() const { return static_cast<int>(blocks.size()); }
+
+    Block &block(int index) { return blocks[index]; }
+
+    // 提交一次读或写，返回完成时刻
+    long long submit(int index, bool write, long long now)
+    {
+        long long start = std::max(now, busyUntil);
+        busyUntil = start + (index == lastBlock + 1 ? 0 : seekTicks) + transferTicks;
+        lastBlock = index;
+        (write ? writes : reads)++;
+        return busyUntil;
+    }
+
+    long long readCount() const { return reads; }
+    long long writeCount() const { return writes; }
+
+private:
+    std::vector<Block> blocks;
+    int seekTicks;
+    int transferTicks;
+    long long busyUntil = 0; // 设备忙到的时刻
+    int lastBlock = -2;      // 上一次访问的块，用于判断是否需要寻道
+    long long reads = 0;
+    long long writes = 0;
+};
+
+// 块缓冲区缓存：哈希表按块号查找，缓冲区按最近使用顺序挂在侵入式 LRU 链表上，
+// 命中、淘汰都是 O(1)。写操作只修改缓冲区并标记为脏（写回），淘汰脏缓冲区或后台回写时才写盘。
+// 缓冲区在发起读盘时就已填好内容，readyAt 之前访问它的进程仍要等到读盘完成
+class BufferCache
+{
+public:
+    struct Buffer
+    {
+        int block = -1;
+        BlockDevice::Block data;
+        bool dirty = false;
+        bool prefetched = false;  // 由预读读入、尚未被访问
+        long long readyAt = 0;    // 读盘完成的时刻
+        long long dirtySince = 0; // 最早一次未写回的修改时刻
+        ListHook<Buffer> lruLink;
+    };
+
+    BufferCache(BlockDevice &_device, int capacity) : device(_device)
+    {
+        for (int i = 0; i < std::max(4, capacity); ++i)
+        {
+            pool.emplace_back(new Buffer());
+            lru.push_back(pool.back().get()); // 空闲缓冲区在链表头部，最先被使用
+        }
+    }
+
+    BufferCache(const BufferCache &) = delete;
+    BufferCache &operator=(const BufferCache &) = delete;
+
+    int capacity() const { return static_cast<int>(pool.size()); }
+
+    // 取得块的缓冲区并设为最近使用，hit 表示块已在缓存中。未命中时淘汰最久未用的缓冲区，
+    // load 为真时从设备读入，否则内容未定义（调用者将整块覆盖）。只有需要块内容的访问计入命中率
+    Buffer *get(int block, bool load, long long now, bool &hit)
+    {
+        auto it = index.find(block);
+        hit = it != index.end();
+        if (hit)
+        {
+            Buffer *buffer = it->second;
+            if (buffer->prefetched)
+            {
+                buffer->prefetched = false;
+                prefetchHits++;
+            }
+            lru.push_back(buffer);
+            if (load)
+                hits++;
+            return buffer;
+        }
+        if (load)
+            misses++;
+        return fill(block, load, now);
+    }
+
+    // 预读：块不在缓存中时发起读盘，调用者不等待
+    void prefetch(int block, long long now)
+    {
+        if (index.count(block))
+            return;
+        fill(block, true, now)->prefetched = true;
+        prefetches++;
+    }
+
+    void markDirty(Buffer *buffer, long long now)
+    {
+        if (!buffer->dirty)
+        {
+            buffer->dirty = true;
+            buffer->dirtySince = now;
+        }
+    }
+
+    // 写回最早修改时刻不晚于 before 的脏缓冲区，返回写回的块数
+    int flush(long long before, long long now)
+    {
+        int written = 0;
+        for (Buffer *buffer : lru)
+        {
+            if (buffer->dirty && buffer->dirtySince <= before)
+            {
+                writeBack(buffer, now);
+                written++;
+            }
+        }
+        return written;
+    }
+
+    int dirtyCount() const
+    {
+        return static_cast<int>(std::count_if(pool.begin(), pool.end(), [](const std::unique_ptr<Buffer> &buffer)
+                                              { return buffer->dirty; }));
+    }
+
+    long long hitCount() const { return hits; }
+    long long missCount() const { return misses; }
+    long long prefetchCount() const { return prefetches; }
+    long long prefetchHitCount() const { return prefetchHits; }
+    long long evictionCount() const { return evictions; }
+    long long writeBackCount() const { return writeBacks; }
+
+private:
+    struct LruHook
+    {
+        static ListHook<Buffer> &of(Buffer *buffer) { return buffer->lruLink; }
+    };
+
+    // 淘汰最久未用的缓冲区（脏的先写回），改为存放 block
+    Buffer *fill(int block, bool load, long long now)
+    {
+        Buffer *buffer = lru.front();
+        if (buffer->block >= 0)
+        {
+            if (buffer->dirty)
+                writeBack(buffer, now);
+            index.erase(buffer->block);
+            evictions++;
+        }
+        buffer->block = block;
+        buffer->prefetched = false;
+        buffer->readyAt = now;
+        if (load)
+        {
+            buffer->data = device.block(block);
+            buffer->readyAt = device.submit(block, false, now);
+        }
+        index[block] = buffer;
+        lru.push_back(buffer);
+        return buffer;
+    }
+
+    void writeBack(Buffer *buffer, long long now)
+    {
+        device.block(buffer->block) = buffer->data;
+        device.submit(buffer->block, true, now);
+        buffer->dirty = false;
+        writeBacks++;
+    }
+
+    BlockDevice &device;
+    std::vector<std::unique_ptr<Buffer>> pool;
+    std::unordered_map<int, Buffer *> index;
+    IntrusiveList<Buffer, LruHook> lru; // 表头最久未用
+    long long hits = 0;
+    long long misses = 0;
+    long long prefetches = 0;
+    long long prefetchHits = 0;
+    long long evictions = 0;
+    long long writeBacks = 0;
+};
+
+#endif // BUFFER_CACHE_H
@@ -0,0 +1,197 @@
+// cache_model.h
+#ifndef CACHE_MODEL_H
+#define CACHE_MODEL_H
+
+#include "checkpoint.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// 组相联缓存的一级：lines 行分为 lines / ways 组，组内按 LRU 替换。
+// 每行记录行地址与最近访问序号，命中时更新序号，未命中时替换组内序号最小的行
+class CacheLevel
+{
+public:
+    CacheLevel(int lines, int _ways)
+        : ways(std::max(1, std::min(_ways, std::max(1, lines)))),
+          sets(std::max(1, lines / ways)),
+          tags(static_cast<size_t>(sets) * ways, EMPTY),
+          stamps(tags.size(), 0) {}
+
+    // 访问行地址为 line 的行，未命中时装入。返回是否命中
+    bool access(uint64_t line)
+    {
+        size_t base = static_cast<size_t>(line % sets) * ways;
+        size_t victim = base;
+        for (size_t way = base; way < base + ways; ++way)
+        {
+            if (tags[way] == line)
+            {
+                stamps[way] = ++clock;
+                hits++;
+                return true;
+            }
+            if (stamps[way] < stamps[victim])
+                victim = way;
+        }
+        tags[victim] = line;
+        stamps[victim] = ++clock;
+        misses++;
+        return false;
+    }
+
+    int lineCount() const { return static_cast<int>(tags.size()); }
+    long long hitCount() const { return hits; }
+    long long missCount() const { return misses; }
+
+    void save(CheckpointWriter &out) const
+    {
+        out.write(static_cast<uint32_t>(tags.size()));
+        for (size_t i = 0; i < tags.size(); ++i)
+        {
+            out.write(tags[i]);
+            out.write(stamps[i]);
+        }
+        out.write(clock);
+        out.write(hits);
+        out.write(misses);
+    }
+
+    // 行数须与保存时相同（同样的配置），否则标记检查点损坏
+    void restore(CheckpointReader &in)
+    {
+        if (in.read<uint32_t>() != tags.size())
+        {
+            in.fail();
+            return;
+        }
+        for (size_t i = 0; i < tags.size() && in.ok(); ++i)
+        {
+            tags[i] = in.read<uint64_t>();
+            stamps[i] = in.read<uint64_t>();
+        }
+        clock = in.read<uint64_t>();
+        hits = in.read<long long>();
+        misses = in.read<long long>();
+    }
+
+private:
+    static constexpr uint64_t EMPTY = ~uint64_t(0);
+
+    int ways;
+    int sets;
+    std::vector<uint64_t> tags;
+    std::vector<uint64_t> stamps; // 0 表示空行，总是最先被替换
+    uint64_t clock = 0;
+    long long hits = 0;
+    long long misses = 0;
+};
+
+// 单个 CPU 的 L1/L2/LLC 缓存层次，地址以字为单位。访问从 L1 起逐级查找，未命中的级别都装入该行（非包含式）。
+// 不同进程的地址空间互不重叠（地址带上进程号），因此进程切换后新进程会逐渐挤掉旧进程的行；
+// 内核切换代码本身也占用 switchFootprintLines 行。
+// 每个 tick 代表 cyclesPerTick 个周期的工作，其中包括 accessesPerTick 次 L1 命中的访存；
+// 比 L1 慢的部分累计为停顿周期，由 CPU 折算为不推进进程的 tick
+class CacheHierarchy
+{
+public:
+    struct Config
+    {
+        int lineWords = 16;            // 行大小（字），64 字节
+        int l1Words = 8192;            // 32 KiB
+        int l1Ways = 8;
+        int l2Words = 65536;           // 256 KiB
+        int l2Ways = 8;
+        int llcWords = 524288;         // 2 MiB
+        int llcWays = 16;
+        int l1Latency = 4;             // 各级命中及访问内存的延迟（周期）
+        int l2Latency = 12;
+        int llcLatency = 40;
+        int memoryLatency = 200;
+        int cyclesPerTick = 2000;
+        int accessesPerTick = 20;      // 每个计算 tick 在工作集中随机访存的次数
+        int workingSetWords = 4096;    // 没有地址空间的进程的工作集大小
+        int switchFootprintLines = 64; // 一次进程切换时内核访问的行数
+    };
+
+    CacheHierarchy() : CacheHierarchy(Config()) {}
+    explicit CacheHierarchy(const Config &_config)
+        : config(_config),
+          l1(lines(_config.l1Words), _config.l1Ways),
+          l2(lines(_config.l2Words), _config.l2Ways),
+          llc(lines(_config.llcWords), _config.llcWays) {}
+
+    const Config &getConfig() const { return config; }
+    int lineWords() const { return std::max(1, config.lineWords); }
+
+    // 进程 owner 访问地址 address 处的字，返回比 L1 命中多出的周期数
+    int access(long long owner, long long address)
+    {
+        uint64_t line = (static_cast<uint64_t>(owner) << 40 | static_cast<uint64_t>(address & ((1LL << 40) - 1))) / lineWords();
+        int latency = config.l1Latency;
+        if (!l1.access(line))
+        {
+            latency = config.l2Latency;
+            if (!l2.access(line))
+                latency = llc.access(line) ? config.llcLatency : config.memoryLatency;
+        }
+        return latency - config.l1Latency;
+    }
+
+    // 计算时第 sequence 次访存的地址：由进程号与序号散列到工作集中，同一进程反复访问同一批行
+    static long long workingSetAddress(long long owner, long long sequence, int words)
+    {
+        uint64_t x = static_cast<uint64_t>(owner) * 0x9e3779b97f4a7c15ULL + static_cast<uint64_t>(sequence);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<long long>((x ^ (x >> 31)) % static_cast<uint64_t>(std::max(1, words)));
+    }
+
+    // 进程切换：内核的切换代码与数据占用若干行，返回其停顿周期
+    int contextSwitch()
+    {
+        int stall = 0;
+        for (int i = 0; i < config.switchFootprintLines; ++i)
+            stall += access(KERNEL, static_cast<long long>(i) * lineWords());
+        switches++;
+        switchStallCycles += stall;
+        return stall;
+    }
+
+    const CacheLevel &level(int index) const { return index == 0 ? l1 : index == 1 ? l2 : llc; }
+    long long switchCount() const { return switches; }
+    long long switchStall() const { return switchStallCycles; }
+
+    // 各级缓存的内容与统计，恢复到同样配置的缓存层次
+    void save(CheckpointWriter &out) const
+    {
+        l1.save(out);
+        l2.save(out);
+        llc.save(out);
+        out.write(switches);
+        out.write(switchStallCycles);
+    }
+
+    void restore(CheckpointReader &in)
+    {
+        l1.restore(in);
+        l2.restore(in);
+        llc.restore(in);
+        switches = in.read<long long>();
+        switchStallCycles = in.read<long long>();
+    }
+
+private:
+    static constexpr long long KERNEL = (1LL << 23) - 1; // 内核地址空间使用的进程号
+
+    int lines(int words) const { return std::max(1, words / lineWords()); }
+
+    Config config;
+    CacheLevel l1;
+    CacheLevel l2;
+    CacheLevel llc;
+    long long switches = 0;
+    long long switchStallCycles = 0;
+};
+
+#endif // CACHE_MODEL_H
@@ -0,0 +1,96 @@
+// checkpoint.h
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+// 检查点文件的二进制编码。数值按本机字节序原样写入，字符串为 32 位长度加内容；
+// 检查点只用于同一构建的暂停/恢复与分支实验，不考虑跨平台移植
+const char CHECKPOINT_MAGIC[8] = {'O', 'S', 'S', 'I', 'M', 'C', 'K', 'P'};
+const uint32_t CHECKPOINT_VERSION = 8;
+
+class CheckpointWriter
+{
+public:
+    explicit CheckpointWriter(std::ostream &_out) : out(_out) {}
+
+    template <typename T>
+    void write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be written directly");
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void writeString(const std::string &value)
+    {
+        write(static_cast<uint32_t>(value.size()));
+        out.write(value.data(), value.size());
+    }
+
+    bool ok() const { return static_cast<bool>(out); }
+
+private:
+    std::ostream &out;
+};
+
+// 读取失败（数据截断或长度字段越界）后所有读取都返回零值，由调用者在最后统一检查 ok()
+class CheckpointReader
+{
+public:
+    explicit CheckpointReader(std::istream &_in) : in(_in) {}
+
+    template <typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be read directly");
+        T value{};
+        if (failed)
+            return value;
+        if (!in.read(reinterpret_cast<char *>(&value), sizeof(T)))
+        {
+            failed = true;
+            return T{};
+        }
+        return value;
+    }
+
+    std::string readString()
+    {
+        uint32_t length = read<uint32_t>();
+        if (failed || length > MAX_STRING)
+        {
+            failed = true;
+            return std::string();
+        }
+        std::string value(length, '\0');
+        if (!in.read(&value[0], length))
+            failed = true;
+        return value;
+    }
+
+    // 读取元素个数，超过 limit 视为损坏的检查点
+    uint32_t readCount(uint32_t limit)
+    {
+        uint32_t count = read<uint32_t>();
+        if (count > limit)
+        {
+            failed = true;
+            return 0;
+        }
+        return count;
+    }
+
+    void fail() { failed = true; }
+    bool ok() const { return !failed; }
+
+private:
+    static const uint32_t MAX_STRING = 1 << 20;
+
+    std::istream &in;
+    bool failed = false;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,304 @@
+// cluster.cpp
+#include "cluster.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <queue>
+
+Cluster::Cluster(const Options &_options)
+    : options(_options),
+      clock(std::max(1, _options.nodes)),
+      nodes(std::max(1, _options.nodes)),
+      rng(_options.seed)
+{
+    options.nodes = static_cast<int>(nodes.size());
+    options.network.nodesPerRack = std::max(1, options.network.nodesPerRack);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        nodes[i].cpu = std::make_unique<CPU>(options.timeSlice, &clock, static_cast<int>(i));
+        nodes[i].cpu->setSimulatedDelays(0, 0);
+        nodes[i].cpu->setVerbose(false);
+        // 彩票调度各节点用不同的种子，避免抽出同一串签
+        nodes[i].cpu->setLotterySeed(options.seed ^ (static_cast<unsigned long long>(i) << 32));
+        nodes[i].policy = nodes[i].cpu->makePolicy(options.policy);
+        if (!nodes[i].policy)
+        {
+            if (i == 0)
+                std::cerr << "Invalid scheduling policy " << options.policy << ", using Round Robin." << std::endl;
+            nodes[i].policy = nodes[i].cpu->makePolicy(0);
+        }
+        byLoad.insert({0, static_cast<int>(i)});
+    }
+}
+
+bool Cluster::parseBalancer(const char *name, Balancer &balancer)
+{
+    static const char *names[] = {"round-robin", "random", "least-loaded", "power-of-two"};
+    for (int i = 0; i < 4; ++i)
+    {
+        if (std::strcmp(name, names[i]) == 0)
+        {
+            balancer = static_cast<Balancer>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Cluster::submit(const ProcessSpec &spec, std::string &error)
+{
+    if (spec.period > 0)
+    {
+        error = "process " + std::to_string(spec.pid) + ": periodic tasks are not supported in cluster mode";
+        return false;
+    }
+    Job job;
+    job.pcb.reset(spec.createPCB());
+    job.submitTime = spec.arrivalTime;
+    job.code = spec.code;
+    jobs.push_back(std::move(job));
+    return true;
+}
+
+void Cluster::setLoad(int node, int load)
+{
+    if (options.balancer == LeastLoaded)
+    {
+        byLoad.erase({nodes[node].load, node});
+        byLoad.insert({load, node});
+    }
+    nodes[node].load = load;
+}
+
+int Cluster::chooseNode()
+{
+    int count = static_cast<int>(nodes.size());
+    switch (options.balancer)
+    {
+    case RoundRobin:
+    {
+        int node = nextNode;
+        nextNode = (nextNode + 1) % count;
+        return node;
+    }
+    case Random:
+        return std::uniform_int_distribution<int>(0, count - 1)(rng);
+    case LeastLoaded:
+        return byLoad.begin()->second;
+    case PowerOfTwo:
+    default:
+    {
+        std::uniform_int_distribution<int> pick(0, count - 1);
+        int a = pick(rng);
+        int b = pick(rng);
+        if (nodes[b].load < nodes[a].load || (nodes[b].load == nodes[a].load && b < a))
+            return b;
+        return a;
+    }
+    }
+}
+
+// 作业在 arrival 时刻到达节点 node；调用时节点的时钟都早于 arrival，作业先以“未到达”挂在节点上
+void Cluster::place(Job &job, int node, int arrival)
+{
+    CPU &cpu = *nodes[node].cpu;
+    job.pcb->setArrivalTime(arrival);
+    if (!job.code.empty() && !cpu.loadProgram(job.pcb.get(), job.code))
+        std::cerr << "Node " << node << ": no instruction memory left for process " << job.pcb->getPid() << "." << std::endl;
+    cpu.addProcess(job.pcb.get());
+    setLoad(node, nodes[node].load + 1);
+    dispatched++;
+}
+
+// 有未完成作业的节点并行运行到 end，其余节点直接把本地时钟推进到 end。
+// 节点按小块动态分给线程，各节点的运行时间差别很大；每个节点的本地时钟只由运行它的线程写入
+void Cluster::runWindow(ThreadPool &pool, int end)
+{
+    constexpr size_t CHUNK = 16;
+    std::atomic<size_t> nextChunk{0};
+    for (size_t worker = 0; worker < pool.size(); ++worker)
+    {
+        pool.submit([this, &nextChunk, end]()
+                    {
+            size_t first;
+            while ((first = nextChunk.fetch_add(CHUNK, std::memory_order_relaxed)) < nodes.size())
+            {
+                for (size_t i = first; i < std::min(first + CHUNK, nodes.size()); ++i)
+                {
+                    CPU &cpu = *nodes[i].cpu;
+                    if (nodes[i].load > 0)
+                    {
+                        cpu.pauseAt(end, true);
+                        cpu.manageTimeAndSchedule(*nodes[i].policy);
+                    }
+                    // 没有作业或作业在窗口内全部结束的节点空闲到 end；死锁的节点停在原处，由 collectLoads 发现
+                    if (cpu.isFinished())
+                        clock.advanceTo(static_cast<int>(i), end);
+                }
+            } });
+    }
+    pool.wait();
+}
+
+// 屏障处更新各节点的负载；有未完成作业却停在 end 之前的节点已死锁，返回 false
+bool Cluster::collectLoads(int end)
+{
+    completed = 0;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const CPU &cpu = *nodes[i].cpu;
+        int unfinished = cpu.getProcessCount() - cpu.getTerminatedCount();
+        if (unfinished > 0 && cpu.getCurrentTime() < end)
+        {
+            std::cerr << "Node " << i << " is deadlocked at time " << cpu.getCurrentTime() << "." << std::endl;
+            return false;
+        }
+        setLoad(static_cast<int>(i), unfinished);
+        completed += cpu.getTerminatedCount();
+    }
+    return true;
+}
+
+// 空闲节点（按编号顺序）各从当前积压最多的节点取走其一半的作业，只有尚未运行过的就绪作业可以迁移
+void Cluster::migrate(int now)
+{
+    if (options.migrateThreshold <= 0)
+        return;
+    std::priority_queue<std::pair<int, int>> donors; // (负载, -节点)，负载相同时编号小的优先
+    for (size_t i = 0; i < nodes.size(); ++i)
+        if (nodes[i].load > options.migrateThreshold)
+            donors.push({nodes[i].load, -static_cast<int>(i)});
+
+    for (size_t i = 0; i < nodes.size() && !donors.empty(); ++i)
+    {
+        if (nodes[i].load != 0)
+            continue;
+        int from = -donors.top().second;
+        donors.pop();
+        std::vector<PCB *> moved = nodes[from].cpu->detachUnstartedProcesses(nodes[from].load / 2);
+        if (moved.empty())
+            continue; // 积压的都已运行过或在阻塞，不再作为迁出节点
+        int arrival = now + options.network.latency(from, static_cast<int>(i));
+        for (PCB *pcb : moved)
+        {
+            pcb->setArrivalTime(arrival);
+            nodes[i].cpu->addProcess(pcb);
+        }
+        int count = static_cast<int>(moved.size());
+        setLoad(from, nodes[from].load - count);
+        setLoad(static_cast<int>(i), count);
+        migrated += count;
+        migrationBatches++;
+        if (nodes[from].load > options.migrateThreshold)
+            donors.push({nodes[from].load, -from});
+    }
+}
+
+bool Cluster::run()
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b)
+                     { return jobs[a].submitTime < jobs[b].submitTime; });
+
+    int window = options.network.lookahead();
+    ThreadPool pool(options.threads);
+    bool ok = true;
+    size_t next = 0;
+    int time = 0;
+    while (true)
+    {
+        // 集群中没有未完成的作业时直接跳到下一个作业提交所在的窗口
+        bool idle = std::all_of(nodes.begin(), nodes.end(), [](const Node &node)
+                                { return node.load == 0; });
+        if (idle)
+        {
+            if (next == order.size())
+                break;
+            time = std::max(time, jobs[order[next]].submitTime / window * window);
+        }
+        int end = time + window;
+
+        // 本窗口内提交的作业按屏障处的负载分配，到达节点时已在 end 之后
+        for (; next < order.size() && jobs[order[next]].submitTime < end; ++next)
+        {
+            Job &job = jobs[order[next]];
+            int node = chooseNode();
+            place(job, node, std::max(job.submitTime, time) + options.network.latency(-1, node));
+        }
+
+        runWindow(pool, end);
+        windows++;
+        if (!collectLoads(end))
+        {
+            ok = false;
+            break;
+        }
+        // 屏障：所有节点都已停在 end，发布本地时钟的最小值作为集群时间
+        time = static_cast<int>(clock.synchronize());
+        migrate(time);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    wallMs = elapsed.count();
+
+    turnaround.reset();
+    response.reset();
+    for (const Job &job : jobs)
+    {
+        if (job.pcb->finishTime >= 0)
+            turnaround.record(job.pcb->finishTime - job.submitTime);
+        if (job.pcb->firstRunTime >= 0)
+            response.record(job.pcb->firstRunTime - job.submitTime);
+    }
+    return ok;
+}
+
+long long Cluster::makespan() const
+{
+    long long last = 0;
+    for (const Job &job : jobs)
+        last = std::max<long long>(last, job.pcb->finishTime);
+    return last;
+}
+
+void Cluster::displayReport(std::ostream &out) const
+{
+    static const char *balancerNames[] = {"round-robin", "random", "least-loaded", "power-of-two"};
+    long long span = makespan();
+    int racks = (options.nodes + options.network.nodesPerRack - 1) / options.network.nodesPerRack;
+
+    double minimum = 1, maximum = 0, sum = 0, squareSum = 0;
+    int fewest = std::numeric_limits<int>::max(), most = 0;
+    for (const Node &node : nodes)
+    {
+        double utilization = span > 0 ? static_cast<double>(node.cpu->getStats().busyTime()) / span : 0;
+        minimum = std::min(minimum, utilization);
+        maximum = std::max(maximum, utilization);
+        sum += utilization;
+        squareSum += utilization * utilization;
+        fewest = std::min(fewest, node.cpu->getTerminatedCount());
+        most = std::max(most, node.cpu->getTerminatedCount());
+    }
+    double mean = sum / nodes.size();
+    double deviation = std::sqrt(std::max(0.0, squareSum / nodes.size() - mean * mean));
+
+    out << "Cluster: " << options.nodes << " nodes in " << racks << " racks, policy " << options.policy << ", slice "
+        << options.timeSlice << ", balancer " << balancerNames[options.balancer] << ", lookahead " << options.network.lookahead()
+        << " ticks, " << options.threads << " threads" << std::endl;
+    out << "Jobs: " << completed << "/" << jobs.size() << " completed, makespan " << span << ", " << windows << " windows, wall "
+        << std::fixed << std::setprecision(1) << wallMs << " ms" << std::endl;
+    out << "Messages: " << dispatched << " dispatched from the front end, " << migrated << " jobs migrated in " << migrationBatches
+        << " batches" << std::endl;
+    out << "  " << std::left << std::setw(12) << "metric" << std::right << std::setw(10) << "mean" << std::setw(8) << "p50"
+        << std::setw(8) << "p90" << std::setw(8) << "p99" << std::setw(8) << "max" << std::endl;
+    for (const auto &row : {std::make_pair("turnaround", &turnaround), std::make_pair("response", &response)})
+        out << "  " << std::left << std::setw(12) << row.first << std::right << std::setw(10) << std::setprecision(2) << row.second->mean()
+            << std::setw(8) << row.second->percentile(50) << std::setw(8) << row.second->percentile(90) << std::setw(8)
+            << row.second->percentile(99) << std::setw(8) << row.second->max() << std::endl;
+    out << "Node utilization: mean " << std::setprecision(1) << 100 * mean << "%, min " << 100 * minimum << "%, max "
+        << 100 * maximum << "%, stddev " << 100 * deviation << "%; jobs per node " << fewest << "-" << most << std::endl;
+    out << std::defaultfloat << std::setprecision(6);
+}
@@ -0,0 +1,125 @@
+// cluster.h
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include "cpu.h"
+#include "workload.h"
+#include <random>
+#include <set>
+
+class ThreadPool;
+
+// 集群网络的延迟模型（tick）：作业从前端发到节点，或在节点之间迁移。节点按编号顺序每 nodesPerRack 个一个机架
+struct NetworkModel
+{
+    int frontEndLatency = 4;  // 前端到任一节点
+    int rackLatency = 2;      // 同一机架内的节点之间
+    int crossRackLatency = 6; // 不同机架的节点之间
+    int nodesPerRack = 40;
+
+    // 从 from 到 to 的延迟，from 为 -1 表示前端
+    int latency(int from, int to) const
+    {
+        if (from < 0)
+            return frontEndLatency;
+        return from / nodesPerRack == to / nodesPerRack ? rackLatency : crossRackLatency;
+    }
+
+    // 所有消息延迟的下界，即并行模拟的同步窗口
+    int lookahead() const { return std::max(1, std::min({frontEndLatency, rackLatency, crossRackLatency})); }
+};
+
+// 多节点集群模拟：每个节点是一个独立的 CPU（自己的队列与调度策略，在共享时钟中占一个核的本地时钟），作业由前端的全局负载均衡器
+// 分配到节点；空闲的节点从积压最多的节点迁移尚未运行过的作业。两种消息都经过网络延迟才到达。
+// 采用保守的并行离散事件同步：任何消息的延迟都不小于 lookahead，因此按长度为 lookahead 的窗口推进，
+// 窗口内节点之间互不影响，在宿主机线程上并行运行到窗口终点（运行中的进程停在终点，下个窗口原样继续，
+// 调度策略对象在窗口之间保留，窗口边界对节点上的调度没有影响）；
+// 窗口之间的屏障处取所有节点本地时钟的最小值发布为集群时间，按节点编号的固定顺序采集负载、分配作业并发出迁移，消息总是落在之后的窗口里，
+// 因此结果与线程数无关。负载均衡器看到的是上一个屏障处的负载，与真实系统一样有延迟
+class Cluster
+{
+public:
+    enum Balancer
+    {
+        RoundRobin,  // 轮流分配
+        Random,      // 随机分配
+        LeastLoaded, // 未完成作业最少的节点
+        PowerOfTwo   // 随机取两个节点，选未完成作业少的
+    };
+
+    struct Options
+    {
+        int nodes = 64;
+        int policy = 0; // 各节点的调度策略编号，同 CPU::makePolicy，无效时使用轮转调度
+        int timeSlice = 2;
+        Balancer balancer = PowerOfTwo;
+        NetworkModel network;
+        int migrateThreshold = 4; // 空闲节点只从未完成作业多于此数的节点迁移，0 表示不迁移
+        size_t threads = 1;       // 并行运行节点的宿主机线程数
+        unsigned long long seed = 1;
+    };
+
+    explicit Cluster(const Options &options);
+
+    Cluster(const Cluster &) = delete;
+    Cluster &operator=(const Cluster &) = delete;
+
+    // 按名称解析负载均衡策略，未知名称时返回 false
+    static bool parseBalancer(const char *name, Balancer &balancer);
+
+    // 提交一个作业，arrivalTime 为到达前端的时刻。进程号须在集群内唯一；
+    // 周期任务不受支持。带指令的作业在分配到的节点上装入，spec.code 引用的工作负载须在运行结束前保持有效
+    bool submit(const ProcessSpec &spec, std::string &error);
+
+    // 运行到所有作业结束；某个节点死锁时返回 false
+    bool run();
+
+    void displayReport(std::ostream &out = std::cout) const;
+
+    long long makespan() const;
+    // 各节点的本地时钟；全局时间为最近一次屏障处所有本地时钟的最小值
+    const SimClock &getClock() const { return clock; }
+    long long completedJobs() const { return completed; }
+    const LogHistogram &turnaroundTimes() const { return turnaround; }
+
+private:
+    struct Node
+    {
+        std::unique_ptr<CPU> cpu;
+        std::unique_ptr<SchedulerPolicy> policy; // 在各窗口之间保留，就绪进程与运行中的进程跨窗口不变
+        int load = 0; // 未完成的作业数（含在途的），屏障处更新，分配时递增
+    };
+
+    struct Job
+    {
+        std::unique_ptr<PCB> pcb;
+        int submitTime;
+        std::vector<std::string_view> code;
+    };
+
+    void setLoad(int node, int load);
+    int chooseNode();
+    void place(Job &job, int node, int arrival);
+    void runWindow(ThreadPool &pool, int end);
+    bool collectLoads(int end);
+    void migrate(int now);
+
+    Options options;
+    SimClock clock; // 每个节点一个核，先于节点构造、晚于节点析构
+    std::vector<Node> nodes;
+    std::vector<Job> jobs;
+    std::set<std::pair<int, int>> byLoad; // (负载, 节点)，用于 LeastLoaded
+    std::mt19937_64 rng;
+    int nextNode = 0;
+
+    long long windows = 0;
+    long long completed = 0;
+    long long dispatched = 0;
+    long long migrated = 0;
+    long long migrationBatches = 0;
+    double wallMs = 0;
+    LogHistogram turnaround; // 从到达前端到完成
+    LogHistogram response;   // 从到达前端到首次运行
+};
+
+#endif // CLUSTER_H
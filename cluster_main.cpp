@@ -0,0 +1,132 @@
+// cluster_main.cpp
+// 多节点集群模拟驱动：把工作负载提交给集群的前端，各节点在多个宿主机线程上并行模拟，最后输出集群报告
+#include "cluster.h"
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+
+void usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [-N nodes] [-w workload | -n jobs -u utilization] [-s seed] [-p policy] [-q slice]\n"
+              << "       [-b balancer] [-l front,rack,cross] [-r nodes-per-rack] [-m threshold] [-j threads]\n"
+              << "  -N  simulated nodes (default 1024)\n"
+              << "  -w  workload file, arrival times are front-end submission times; without it a random workload is generated\n"
+              << "  -n  jobs in the random workload (default 100 per node)\n"
+              << "  -u  offered load of the random workload as a fraction of cluster capacity (default 0.7)\n"
+              << "  -p  scheduling policy on every node (0=RR 1=FCFS 2=HPF 3=SJF 4=SRTF 7=CFS 8=Lottery 9=Stride, default 0)\n"
+              << "  -b  load balancer: round-robin, random, least-loaded, power-of-two (default)\n"
+              << "  -l  network latencies in ticks: front end to node, within a rack, across racks (default 4,2,6)\n"
+              << "  -r  nodes per rack (default 40)\n"
+              << "  -m  idle nodes take half the backlog of nodes with more than this many jobs, 0 disables migration (default 4)\n"
+              << "  -j  host threads (default: hardware concurrency)" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    Cluster::Options options;
+    options.nodes = 1024;
+    options.threads = std::thread::hardware_concurrency();
+    std::string workloadPath;
+    int count = -1;
+    double utilization = 0.7;
+
+    int option;
+    while ((option = getopt(argc, argv, "N:w:n:u:s:p:q:b:l:r:m:j:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'N':
+            options.nodes = std::atoi(optarg);
+            break;
+        case 'w':
+            workloadPath = optarg;
+            break;
+        case 'n':
+            count = std::atoi(optarg);
+            break;
+        case 'u':
+            utilization = std::atof(optarg);
+            break;
+        case 's':
+            options.seed = std::strtoull(optarg, nullptr, 10);
+            break;
+        case 'p':
+            options.policy = std::atoi(optarg);
+            break;
+        case 'q':
+            options.timeSlice = std::atoi(optarg);
+            break;
+        case 'b':
+            if (!Cluster::parseBalancer(optarg, options.balancer))
+            {
+                std::cerr << "Unknown balancer " << optarg << "." << std::endl;
+                return 1;
+            }
+            break;
+        case 'l':
+            if (std::sscanf(optarg, "%d,%d,%d", &options.network.frontEndLatency, &options.network.rackLatency,
+                            &options.network.crossRackLatency) != 3)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'r':
+            options.network.nodesPerRack = std::atoi(optarg);
+            break;
+        case 'm':
+            options.migrateThreshold = std::atoi(optarg);
+            break;
+        case 'j':
+            options.threads = std::strtoul(optarg, nullptr, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? 0 : 1;
+        }
+    }
+    if (options.nodes < 1 || options.timeSlice < 1 || options.policy < 0 || options.policy > 9 || options.policy == 5 ||
+        options.policy == 6 || utilization <= 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Workload workload;
+    std::vector<ProcessSpec> generated;
+    const std::vector<ProcessSpec> *specs = &generated;
+    if (workloadPath.empty())
+    {
+        // 随机工作负载的到达时刻压缩到使提交的工作量约为集群容量的 utilization 倍（运行时间平均 25.5 tick）
+        if (count < 0)
+            count = 100 * options.nodes;
+        generated = Workload::generate(count, options.seed);
+        double span = count * 25.5 / (options.nodes * utilization);
+        for (ProcessSpec &spec : generated)
+            spec.arrivalTime = static_cast<int>(spec.arrivalTime * span / std::max(1, count));
+    }
+    else
+    {
+        std::string error;
+        if (!workload.load(workloadPath, error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        specs = &workload.processes();
+    }
+
+    Cluster cluster(options);
+    for (const ProcessSpec &spec : *specs)
+    {
+        std::string error;
+        if (!cluster.submit(spec, error))
+        {
+            std::cerr << error << "." << std::endl;
+            return 1;
+        }
+    }
+    bool finished = cluster.run();
+    cluster.displayReport();
+    return finished ? 0 : 1;
+}
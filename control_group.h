@@ -0,0 +1,129 @@
+// control_group.h
+#ifndef CONTROL_GROUP_H
+#define CONTROL_GROUP_H
+
+#include "pcb.h"
+#include <string>
+
+// 类似 cgroup 的 CPU 控制组，组成一棵树，进程属于其中一个组。
+// 份额（shares，默认 1024）沿路径相乘后折算进组内进程的 CFS 权重与彩票/步长票数；
+// 带宽限制 quota/period 表示每个周期（从时刻 0 起对齐）内本组及其子组合计最多运行 quota 个 tick。
+// 用完配额的组被限流，组内进程在当前时间片结束时被挂起，直到下一个周期开始补充配额。
+// 每个 tick 沿进程所在组到根的路径记账，开销为 O(深度)
+class ControlGroup
+{
+public:
+    static constexpr int DEFAULT_SHARES = 1024;
+
+    explicit ControlGroup(const std::string &_name, ControlGroup *_parent = nullptr, int _shares = DEFAULT_SHARES)
+        : name(_name), parent(_parent), shares(std::max(2, _shares)) {}
+
+    ControlGroup(const ControlGroup &) = delete;
+    ControlGroup &operator=(const ControlGroup &) = delete;
+
+    // 每 period 个 tick 最多运行 quota 个 tick；quota 不大于 0 表示不限
+    void setBandwidth(int _quota, int _period)
+    {
+        quota = _quota;
+        period = std::max(1, _period);
+    }
+
+    // 把进程加入本组；须在进程交给 CPU 之前调用
+    void attach(PCB *process)
+    {
+        process->group = this;
+        process->shareScale = shareScale();
+    }
+
+    // 本组相对于根的份额比例
+    double shareScale() const { return (parent ? parent->shareScale() : 1.0) * shares / DEFAULT_SHARES; }
+
+    // 本组及各祖先计入截至 now 的一个 tick 的运行时间，返回路径上是否有组处于限流状态
+    bool charge(long long now)
+    {
+        bool throttledPath = false;
+        for (ControlGroup *group = this; group; group = group->parent)
+        {
+            group->refill(now - 1); // 这个 tick 属于它开始时所在的周期
+            group->usage++;
+            if (group->quota > 0 && ++group->runtime >= group->quota && !group->throttled)
+            {
+                group->throttled = true;
+                group->throttledSince = now;
+                group->throttleCount++;
+            }
+            throttledPath = throttledPath || group->throttled;
+        }
+        return throttledPath;
+    }
+
+    // 路径上离进程最近的限流中的组，都未限流时返回空
+    ControlGroup *throttledAncestor(long long now)
+    {
+        for (ControlGroup *group = this; group; group = group->parent)
+        {
+            group->refill(now);
+            if (group->throttled)
+                return group;
+        }
+        return nullptr;
+    }
+
+    // 按 now 补充配额，返回是否仍在限流
+    bool isThrottled(long long now)
+    {
+        refill(now);
+        return throttled;
+    }
+
+    // 限流解除（下一个周期开始）的时刻
+    long long unthrottleTime() const { return periodStart + period; }
+
+    // 从根开始以 / 分隔的组名
+    std::string path() const { return parent ? parent->path() + "/" + name : name; }
+    const std::string &getName() const { return name; }
+    ControlGroup *getParent() const { return parent; }
+    int getShares() const { return shares; }
+    int getQuota() const { return quota; }
+    int getPeriod() const { return period; }
+    long long usageTicks() const { return usage; }
+    long long periodCount() const { return periods; }
+    long long throttledPeriods() const { return throttleCount; }
+    long long throttledTicks() const { return throttledTime; }
+
+    // 因本组限流而挂起的进程，由 CPU 维护
+    ProcessList held;
+
+private:
+    // 跨过周期边界时清零已用时间并解除限流
+    void refill(long long now)
+    {
+        if (quota <= 0 || now < periodStart + period)
+            return;
+        long long start = now - now % period;
+        periods += (start - periodStart) / period;
+        if (throttled)
+        {
+            throttled = false;
+            throttledTime += periodStart + period - throttledSince;
+        }
+        periodStart = start;
+        runtime = 0;
+    }
+
+    std::string name;
+    ControlGroup *parent;
+    int shares;
+    int quota = 0;
+    int period = 100;
+    long long periodStart = 0;    // 当前周期的开始时刻
+    long long runtime = 0;        // 当前周期内已运行的 tick
+    bool throttled = false;
+    long long throttledSince = 0; // 最近一次开始限流的时刻
+    long long usage = 0;          // 累计运行的 tick
+    long long periods = 0;        // 已经过的完整周期数（nr_periods）
+    long long throttleCount = 0;  // 发生限流的周期数（nr_throttled）
+    long long throttledTime = 0;  // 累计限流时间（throttled_time）
+};
+
+#endif // CONTROL_GROUP_H
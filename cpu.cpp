@@ -0,0 +1,39 @@
+// cpu.cpp
+#include "cpu.h"
+
+// 辅助函数，用于移除末尾的逗号
+std::string stripComma(const std::string &str)
+{
+    if (!str.empty() && str.back() == ',')
+        return str.substr(0, str.size() - 1);
+    return str;
+}
+
+// 解析从终端读入变量的指令，返回依次读入的变量名：支持 "std::cin >> a >> b;" 与 "read a, b" 两种写法，
+// 不是读指令时返回空
+std::vector<std::string> parseReadTargets(const std::string &instruction)
+{
+    std::vector<std::string> targets;
+    std::istringstream iss(instruction);
+    std::string cmd, var;
+    iss >> cmd;
+    if (cmd == "read")
+    {
+        while (iss >> var)
+            targets.push_back(stripComma(var));
+        return targets;
+    }
+    if (cmd != "cin" && cmd != "std::cin")
+        return targets;
+    while (iss >> cmd >> var && cmd == ">>")
+    {
+        bool last = var.back() == ';';
+        if (last)
+            var.pop_back();
+        if (!var.empty())
+            targets.push_back(var);
+        if (last)
+            break;
+    }
+    return targets;
+}
@@ -3,6 +3,19 @@
 #define CPU_H
 
 #include "pcb.h"
+#include "program.h"
+#include "scheduler.h"
+#include "phase_timer.h"
+#include "sim_clock.h"
+#include "checkpoint.h"
+#include "sched_stats.h"
+#include "seqlock.h"
+#include "terminal.h"
+#include "swap_device.h"
+#include "filesystem.h"
+#include "cache_model.h"
+#include "control_group.h"
+#include "power_model.h"
 #include "allhead.h" // 包含 allhead.h 获取 ALL_MEMORY_SIZE
 #include <unordered_map>
 #include <chrono>
@@ -10,310 +23,2059 @@
 #include <algorithm>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
 #include <iostream>
 #include <sstream>
 #include <limits>
+#include <numeric>
+#include <cmath>
+#include <type_traits>
+#include <optional>
+#include <memory>
+#include <tuple>
+#include <map>
 
 
-// 假设 code 是全局变量，用于存储所有进程的指令
-extern std::vector<std::string> code;
-
 // 辅助函数，用于移除末尾的逗号
-std::string stripComma(const std::string &str)
+std::string stripComma(const std::string &str);
+
+// 从终端读入变量的指令依次读入的变量名，不是读指令时为空
+std::vector<std::string> parseReadTargets(const std::string &instruction);
+
+class CPU
 {
-    if (!str.empty() && str.back() == ',')
-        return str.substr(0, str.size() - 1);
-    return str;
-}
+public:
+    // sharedClock 为空时 CPU 使用自己的单核时钟；多核/多节点模式下传入共享时钟和本 CPU 的核号
+    CPU(int _timeSlice, SimClock *sharedClock = nullptr, int _core = 0)
+        : clock(sharedClock ? sharedClock : &ownClock),
+          core(_core),
+          timeSlice(_timeSlice),
+          currentProcess(nullptr),
+          code(ALL_MEMORY_SIZE),
+          lastInstructionTime(std::chrono::steady_clock::now()) // 初始化上一次指令执行时间为当前时间
+    {
+        timers.reset(now() - 1); // 当前时刻的定时器尚未处理
+    }
+
+    void addProcess(PCB *process)
+    {
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        process->schedIndex = static_cast<int>(processes.size());
+        process->numOfpro = nextSequence++;
+        processes.push_back(process);
+        nextPid = std::max(nextPid, process->getPid() + 1);
+        if (process->isPeriodic())
+        {
+            // 周期任务的作业由 releasePeriodicJobs 按周期释放；周期任务常驻内存，不受准入控制
+            chargeMemory(process);
+            process->setCurrentState(PCB::BLOCKED);
+            log() << "Current time: " << now() << " Periodic task(" << process->getPid() << ") registered, period "
+                      << process->getPeriod() << ", deadline " << process->getRelativeDeadline() << ", WCET " << process->getWcet() << "." << std::endl;
+            periodicTasks.push_back(process);
+            armTimer(process, ReleaseTimer, process->nextRelease);
+            return;
+        }
+        // 初始状态为 READY 或 BLOCKED，根据 arrivalTime
+        if (process->getArrivalTime() <= now())
+        {
+            if (!admit(process))
+                return;
+            process->setCurrentState(PCB::READY);
+            stats.onReady(process, now());
+            log() << "Current time: " << now() << " Process(" << process->getPid() << ") is in READY state." << std::endl;
+            readyQueue.push_back(process);
+        }
+        else
+        {
+            // 使用 BLOCKED 表示进程尚未到达
+            process->setCurrentState(PCB::BLOCKED);
+            log() << "Current time: " << now() << " Process(" << process->getPid() << ") is in BLOCKED state (Not Arrived)." << std::endl;
+            waitingQueue.push_back(process);
+            armTimer(process, ArrivalTimer, process->getArrivalTime());
+        }
+    }
+
+    // 加入以协程编写的进程，CPU 持有其协程帧；帧须在创建它的线程上销毁，因此 CPU 也应在该线程上析构
+    void addProgram(PCB *process, Program program)
+    {
+        process->program = program.get();
+        programs[process] = std::move(program);
+        addProcess(process);
+    }
+
+    // 将进程的指令装入本 CPU 的指令内存，按装入顺序连续存放；空间不足时返回 false
+    template <typename Lines>
+    bool loadProgram(PCB *process, const Lines &instructions)
+    {
+        if (nextCodeOffset + instructions.size() > code.size())
+        {
+            std::cerr << "Not enough instruction memory for process " << process->getPid() << "." << std::endl;
+            return false;
+        }
+        int offset = nextCodeOffset;
+        for (const auto &line : instructions)
+            code[nextCodeOffset++] = std::string(line);
+        process->setCodeInfo(offset, static_cast<int>(instructions.size()));
+        return true;
+    }
+
+    // 启用 CPU 区间指数平均预测，用于进程总运行时间未知时的 SJF/SRTF
+    void enableBurstPrediction(double alpha, double initialEstimate)
+    {
+        useBurstPrediction = true;
+        burstAlpha = alpha;
+        initialBurstEstimate = initialEstimate;
+    }
+
+    // 连接终端：进程执行 std::cin 时从终端读取，没有输入时阻塞等待，不再占用 CPU。
+    // 未连接终端时读指令与其它指令一样只占用一个 tick
+    void attachTerminal(Terminal *_terminal)
+    {
+        terminal = _terminal;
+    }
+
+    // 启用准入控制：进程占用的内存（地址空间大小）之和不超过 words 个字，放不下的新进程挂起等待内存。
+    // 占用超过 words * threshold 时中级调度把阻塞的进程换出到交换设备（需先 attachSwap），超过 words 时也换出就绪进程
+    void setMemoryLimit(long long words, double threshold = 0.9)
+    {
+        memoryLimit = words;
+        swapThreshold = threshold;
+    }
+
+    // 连接交换设备。换入一个进程耗时 latencyTicks 加上每 pagesPerTick 页 1 个 tick
+    void attachSwap(SwapDevice *device, int latencyTicks = 1, int pagesPerTick = 64)
+    {
+        swapDevice = device;
+        swapLatency = std::max(1, latencyTicks);
+        swapPagesPerTick = std::max(1, pagesPerTick);
+    }
+
+    // 连接文件系统：协程进程可以打开、读写其中的文件，缓冲区缓存未命中时阻塞到读盘完成，
+    // 调度循环定期调用文件系统的后台回写
+    void attachFileSystem(FileSystem *_fileSystem)
+    {
+        fileSystem = _fileSystem;
+    }
+
+    // 连接缓存模型：计算、访存与文件读写的访问经过 L1/L2/LLC，比 L1 慢的部分累计为停顿，
+    // 每满 cyclesPerTick 个周期进程多占用一个不推进执行的 tick；进程切换时内核代码污染缓存
+    void attachCacheModel(CacheHierarchy *model)
+    {
+        cacheModel = model;
+    }
+
+    // 连接功耗模型：运行速度随调频器选择的频率变化，空闲时进入空闲态，唤醒有延迟；统计能量
+    void attachPowerModel(PowerModel *model)
+    {
+        powerModel = model;
+    }
+
+    // 设置周期任务的仿真终止时刻；未设置时取最晚到达时间加上超周期
+    void setRealTimeHorizon(int horizon)
+    {
+        realTimeHorizon = horizon;
+    }
+
+    // 设置 CFS 的目标调度延迟与最小粒度（单位：tick）
+    void setCfsParams(int targetLatency, int minGranularity)
+    {
+        cfsTargetLatency = targetLatency;
+        cfsMinGranularity = minGranularity;
+    }
+
+    void setLotterySeed(unsigned long long seed)
+    {
+        lotterySeed = seed;
+    }
+
+    // 模拟的指令执行耗时与空闲等待耗时（毫秒），基准测试时设为 0
+    void setSimulatedDelays(int instructionMs, int idleMs)
+    {
+        instructionDelayMs = instructionMs;
+        idleDelayMs = idleMs;
+    }
+
+    // 关闭后不再输出逐条调度日志
+    void setVerbose(bool enabled)
+    {
+        verbose = enabled;
+    }
+
+    // 累计的上下文切换次数（分派的进程与上一个不同才算），暂停与恢复之间连续计数
+    long long getContextSwitches() const { return stats.contextSwitches(); }
+
+    // 中级调度完成的换入次数
+    long long getSwapIns() const { return swapIns; }
+
+    // 因访存停顿而消耗的 tick 数（需连接缓存模型）
+    long long getStallTicks() const { return stallTicks; }
+
+    // 总能量（mJ，需连接功耗模型）
+    double getEnergy() const { return powerModel ? powerModel->activeEnergyUsed() + powerModel->idleEnergyUsed() : 0; }
+
+    // 增量维护的调度统计（等待/周转/响应时间分布、利用率、吞吐量、公平性）
+    const SchedStats &getStats() const { return stats; }
+
+    void displayStats(std::ostream &out = std::cout) const
+    {
+        stats.display(out, now());
+        if (memoryLimit > 0)
+            displayMemoryReport(out);
+        if (fileSystem)
+            fileSystem->displayStats(out);
+        if (cacheModel)
+            displayCacheReport(out);
+        displayGroupReport(out);
+        if (powerModel)
+            displayPowerReport(out);
+    }
+
+    // 能量、各频率档与空闲态的驻留比例、唤醒开销与每个作业的能量
+    void displayPowerReport(std::ostream &out = std::cout) const
+    {
+        const PowerModel::Config &config = powerModel->getConfig();
+        double energy = getEnergy();
+        out << "Energy: " << energy << " mJ (active " << powerModel->activeEnergyUsed() << ", idle " << powerModel->idleEnergyUsed()
+            << "), average power " << (now() > 0 ? energy / (now() * config.tickMs) : 0) << " W, " << powerModel->frequencyChanges()
+            << " frequency changes, " << powerModel->wakeupCount() << " wake-ups costing " << powerModel->wakeLatencyTicks() << " ticks" << std::endl;
+        long long busy = 0, idle = 0;
+        for (size_t i = 0; i < config.pstates.size(); ++i)
+            busy += powerModel->pstateResidency(static_cast<int>(i));
+        for (size_t i = 0; i < config.cstates.size(); ++i)
+            idle += powerModel->cstateResidency(static_cast<int>(i));
+        out << "P-states:";
+        for (size_t i = 0; i < config.pstates.size(); ++i)
+            out << " " << config.pstates[i].frequencyMHz << " MHz " << (busy ? 100.0 * powerModel->pstateResidency(static_cast<int>(i)) / busy : 0) << "%";
+        out << std::endl
+            << "C-states:";
+        for (size_t i = 0; i < config.cstates.size(); ++i)
+            out << " " << config.cstates[i].name << " " << (idle ? 100.0 * powerModel->cstateResidency(static_cast<int>(i)) / idle : 0) << "%";
+        out << std::endl;
+
+        double jobEnergy = 0, maxJobEnergy = 0;
+        int jobs = 0;
+        for (const PCB *pcb : processes)
+        {
+            if (pcb->getCurrentState() != PCB::TERMINATED)
+                continue;
+            jobEnergy += pcb->energy;
+            maxJobEnergy = std::max(maxJobEnergy, pcb->energy);
+            jobs++;
+        }
+        out << "Energy per job: mean " << (jobs ? jobEnergy / jobs : 0) << " mJ, max " << maxJobEnergy << " mJ over " << jobs << " finished processes" << std::endl;
+    }
+
+    // 进程所在的控制组及其祖先的用量与限流统计，按路径排序；没有进程属于控制组时不输出
+    void displayGroupReport(std::ostream &out = std::cout) const
+    {
+        std::map<std::string, const ControlGroup *> groups;
+        for (const PCB *pcb : processes)
+            for (const ControlGroup *group = pcb->group; group; group = group->getParent())
+                groups.emplace(group->path(), group);
+        for (const auto &entry : groups)
+        {
+            const ControlGroup *group = entry.second;
+            out << "Group " << entry.first << ": shares " << group->getShares() << ", quota ";
+            if (group->getQuota() > 0)
+                out << group->getQuota() << "/" << group->getPeriod();
+            else
+                out << "unlimited";
+            out << ", used " << group->usageTicks() << " ticks, throttled in " << group->throttledPeriods() << " of "
+                << group->periodCount() << " periods for " << group->throttledTicks() << " ticks" << std::endl;
+        }
+    }
+
+    // 各级缓存的命中率与访存停顿
+    void displayCacheReport(std::ostream &out = std::cout) const
+    {
+        static const char *names[] = {"L1", "L2", "LLC"};
+        out << "CPU caches:";
+        for (int i = 0; i < 3; ++i)
+        {
+            const CacheLevel &level = cacheModel->level(i);
+            long long accesses = level.hitCount() + level.missCount();
+            out << (i ? ", " : " ") << names[i] << " hit ratio " << (accesses ? static_cast<double>(level.hitCount()) / accesses : 0)
+                << " (" << level.hitCount() << "/" << accesses << ")";
+        }
+        out << std::endl;
+        out << "Memory stalls: " << stallTicks << " ticks (" << (now() > 0 ? 100.0 * stallTicks / now() : 0) << "% of time), "
+            << cacheModel->switchCount() << " context switches cost " << cacheModel->switchStall() << " stall cycles" << std::endl;
+    }
+
+    // 准入控制与交换的统计
+    void displayMemoryReport(std::ostream &out = std::cout) const
+    {
+        out << "Memory: limit " << memoryLimit << " words, peak resident " << peakResidentWords << " words, "
+            << arrivalsHeld << " arrivals held by admission control" << std::endl;
+        out << "Swapping: " << swapOuts << " swap-outs (" << pagesSwappedOut << " pages), " << swapIns << " swap-ins ("
+            << pagesSwappedIn << " pages), " << (now() > 0 ? 1000.0 * swapIns / now() : 0) << " swap-ins per 1000 ticks" << std::endl;
+    }
+
+    // 最近一次发布的统计快照，可从任意线程无锁读取
+    StatsSnapshot readSnapshot() const { return published.load(); }
+
+    // 调度线程每隔 ticks 个模拟 tick 发布一次快照（调度暂停或结束时也会发布）
+    void setSnapshotInterval(int ticks)
+    {
+        snapshotInterval = std::max(1, ticks);
+    }
+
+    // 所有进程（按加入顺序），恢复检查点后为 CPU 自己创建的进程
+    const std::vector<PCB *> &getProcesses() const { return processes; }
+
+    bool isFinished() const { return areAllProcessesTerminated(); }
+
+    // 队列查询接口：原地遍历，不复制队列。visit 在持有队列锁时调用，不能再调用 CPU 的其它接口；
+    // 调度运行期间只能在调度线程（如策略或日志回调）中使用
+    template <typename Visitor>
+    void forEachReady(Visitor &&visit) const
+    {
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        if (SchedulerPolicy *policy = activePolicy ? activePolicy : heldPolicy)
+            policy->forEachReady(visit);
+        for (PCB *pcb : readyQueue)
+            visit(pcb);
+    }
+
+    template <typename Visitor>
+    void forEachWaiting(Visitor &&visit) const
+    {
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        for (PCB *pcb : waitingQueue)
+            visit(pcb);
+    }
+
+    // 按终止的先后（完成时刻，同一时刻按进程表顺序）遍历已终止的进程
+    template <typename Visitor>
+    void forEachTerminated(Visitor &&visit) const
+    {
+        std::vector<PCB *> terminated;
+        {
+            std::lock_guard<std::mutex> guard(mutexForQueues);
+            for (PCB *pcb : processes)
+                if (pcb->getCurrentState() == PCB::TERMINATED)
+                    terminated.push_back(pcb);
+        }
+        std::stable_sort(terminated.begin(), terminated.end(), [](const PCB *a, const PCB *b)
+                         { return a->finishTime < b->finishTime; });
+        for (PCB *pcb : terminated)
+            visit(pcb);
+    }
+
+    int getReadyCount() const { return stats.readyProcesses(); }
+    int getTerminatedCount() const { return terminatedCount; }
+
+    // 模拟时间到达 time 后，manageTimeAndSchedule 在下一次调度决策前返回（只生效一次）。
+    // 暂停时调度策略中的就绪进程按策略顺序移回 CPU 的就绪队列，
+    // 因此再次调用 manageTimeAndSchedule（可换用其它策略）即可从暂停点继续。
+    // hold 为真时（集群按窗口同步）时钟恰好停在 time：运行中的进程停在时间片中途，仍是当前进程，
+    // 就绪进程留在策略中。之后须以同一个策略对象继续，调度结果与没有暂停时完全相同
+    void pauseAt(int time, bool hold = false)
+    {
+        pauseTime = time;
+        pauseHolds = hold;
+    }
+
+    int getProcessCount() const { return static_cast<int>(processes.size()); }
+
+    // 暂停时从就绪进程（就绪队列与保留的策略中）取出至多 count 个尚未运行过的进程（取最后加入的），
+    // 它们从此不属于本 CPU，由调用者交给别的 CPU（集群在节点间迁移作业）。周期任务、协程或带指令的进程、
+    // 属于控制组或进程树的进程以及占用交换区的进程与本 CPU 的状态相关，不会被取出
+    std::vector<PCB *> detachUnstartedProcesses(int count)
+    {
+        std::vector<PCB *> detached;
+        if (activePolicy != nullptr || count <= 0)
+            return detached;
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        auto movable = [&](PCB *pcb)
+        {
+            if (pcb->firstRunTime < 0 && !pcb->isPeriodic() && !pcb->program && pcb->getCodeLength() == 0 && !pcb->group &&
+                !pcb->parent && pcb->children.empty() && pcb->swapSlots.empty())
+                detached.push_back(pcb);
+        };
+        for (PCB *pcb : readyQueue)
+            movable(pcb);
+        if (heldPolicy)
+            heldPolicy->forEachReady(movable);
+        if (static_cast<int>(detached.size()) > count)
+        {
+            std::sort(detached.begin(), detached.end(), [](const PCB *a, const PCB *b)
+                      { return a->numOfpro < b->numOfpro; });
+            detached.erase(detached.begin(), detached.end() - count);
+        }
+        for (PCB *pcb : detached)
+        {
+            if (readyQueue.contains(pcb))
+                readyQueue.remove(pcb);
+            else
+                heldPolicy->onSuspend(pcb, now());
+            stats.onMigrate(pcb, now());
+            uncharge(pcb);
+            // 进程表中用最后一个进程填补空位
+            PCB *last = processes.back();
+            processes[pcb->schedIndex] = last;
+            last->schedIndex = pcb->schedIndex;
+            processes.pop_back();
+            pcb->schedIndex = -1;
+            log() << "Current time: " << now() << " Process " << pcb->getPid() << " is migrated away." << std::endl;
+        }
+        if (heldPolicy && !detached.empty())
+            heldPolicy->dropRemoved();
+        return detached;
+    }
+
+    // 将暂停（或尚未开始）时的完整模拟状态写入检查点：时钟、进程表、各队列与指令内存，
+    // 以及连接了的缓存模型与功耗模型的状态。调度策略的参数不属于检查点，恢复后由目标 CPU 的配置决定，以便从同一时刻分出多个实验分支
+    bool saveCheckpoint(std::ostream &out) const
+    {
+        if (activePolicy != nullptr || heldPolicy != nullptr)
+        {
+            std::cerr << "Cannot checkpoint while scheduling is running or held in a policy; use pauseAt first." << std::endl;
+            return false;
+        }
+        if (!programs.empty())
+        {
+            std::cerr << "Cannot checkpoint coroutine processes." << std::endl;
+            return false;
+        }
+        if (terminal && !terminal->readers.empty())
+        {
+            std::cerr << "Cannot checkpoint while processes wait for terminal input." << std::endl;
+            return false;
+        }
+        if (!admissionQueue.empty() || std::any_of(processes.begin(), processes.end(), [](const PCB *pcb)
+                                                   { return pcb->getCurrentState() >= PCB::SUSPENDED_READY; }))
+        {
+            std::cerr << "Cannot checkpoint while processes are swapped out or held by admission control." << std::endl;
+            return false;
+        }
+        if (std::any_of(processes.begin(), processes.end(), [](const PCB *pcb)
+                        { return pcb->group != nullptr; }))
+        {
+            std::cerr << "Cannot checkpoint processes in control groups." << std::endl;
+            return false;
+        }
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        CheckpointWriter writer(out);
+        out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        writer.write(CHECKPOINT_VERSION);
+        writer.write(clock->localNow(core));
+        stats.save(writer);
+        writer.write(lastRunPid);
+        writer.write(realTimeHorizon);
+        writer.write(stallTicks);
+        writer.write(cacheModel != nullptr);
+        if (cacheModel)
+            cacheModel->save(writer);
+        writer.write(powerModel != nullptr);
+        if (powerModel)
+            powerModel->save(writer);
+
+        writer.write(static_cast<uint32_t>(nextCodeOffset));
+        for (int i = 0; i < nextCodeOffset; ++i)
+            writer.writeString(code[i]);
+
+        writer.write(static_cast<uint32_t>(processes.size()));
+        for (const PCB *pcb : processes)
+            pcb->saveState(writer);
+
+        // 进程树：各进程父进程的下标，-1 表示没有父进程
+        for (const PCB *pcb : processes)
+            writer.write(pcb->parent ? pcb->parent->schedIndex : -1);
+
+        saveList(writer, readyQueue);
+        saveList(writer, waitingQueue);
+        saveList(writer, wokenProcesses);
+        saveList(writer, updatedProcesses);
+        return writer.ok();
+    }
+
+    // 从检查点恢复到一个尚未加入任何进程的 CPU；进程由 CPU 创建并持有。
+    // 同一份检查点可恢复到多个 CPU，各自独立继续运行。检查点中的缓存与功耗模型状态写入本 CPU 连接的模型
+    // （配置须与保存时相同），本 CPU 未连接时按默认配置读出后丢弃。失败时返回 false 并在 error 中说明原因
+    bool restoreCheckpoint(std::istream &in, std::string &error)
+    {
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        if (!processes.empty() || activePolicy != nullptr || heldPolicy != nullptr)
+        {
+            error = "checkpoint must be restored into an idle CPU without processes";
+            return false;
+        }
+
+        char magic[sizeof(CHECKPOINT_MAGIC)];
+        if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC))
+        {
+            error = "not a simulator checkpoint";
+            return false;
+        }
+        CheckpointReader reader(in);
+        if (reader.read<uint32_t>() != CHECKPOINT_VERSION)
+        {
+            error = "unsupported checkpoint version";
+            return false;
+        }
+        long long time = reader.read<long long>();
+        SchedStats restoredStats;
+        restoredStats.restore(reader);
+        long long lastPid = reader.read<long long>();
+        int horizon = reader.read<int>();
+        long long stalls = reader.read<long long>();
+        std::optional<CacheHierarchy> cacheState;
+        if (reader.read<bool>())
+        {
+            cacheState.emplace(cacheModel ? cacheModel->getConfig() : CacheHierarchy::Config());
+            cacheState->restore(reader);
+        }
+        std::optional<PowerModel> powerState;
+        if (reader.read<bool>())
+        {
+            powerState.emplace(powerModel ? powerModel->getConfig() : PowerModel::Config());
+            powerState->restore(reader);
+        }
+
+        uint32_t codeLines = reader.readCount(static_cast<uint32_t>(code.size()));
+        std::vector<std::string> restoredCode(codeLines);
+        for (auto &line : restoredCode)
+            line = reader.readString();
+
+        uint32_t count = reader.readCount(1 << 24);
+        std::vector<std::unique_ptr<PCB>> restored;
+        for (uint32_t i = 0; i < count && reader.ok(); ++i)
+        {
+            restored.emplace_back(new PCB());
+            restored.back()->restoreState(reader);
+            if (restored.back()->schedIndex != static_cast<int>(i) ||
+                restored.back()->getCodeStartIndex() + restored.back()->getCodeLength() > static_cast<int>(codeLines))
+                reader.fail();
+        }
+        std::vector<PCB *> table;
+        for (const auto &pcb : restored)
+            table.push_back(pcb.get());
+        for (PCB *pcb : table)
+        {
+            int parent = reader.read<int>();
+            if (parent < -1 || parent >= static_cast<int>(table.size()) || parent == pcb->schedIndex)
+                reader.fail();
+            else if (parent >= 0)
+            {
+                pcb->parent = table[parent];
+                table[parent]->children.push_back(pcb);
+            }
+        }
+
+        std::vector<PCB *> ready = restoreList(reader, table);
+        std::vector<PCB *> waiting = restoreList(reader, table);
+        std::vector<PCB *> woken = restoreList(reader, table);
+        std::vector<PCB *> updated = restoreList(reader, table);
+        if (!reader.ok())
+        {
+            error = "truncated or corrupt checkpoint";
+            return false;
+        }
+
+        // 全部读取成功后才修改 CPU 状态
+        if (clock == &ownClock)
+            ownClock.reset(time);
+        else
+            clock->advanceTo(core, time);
+        stats = restoredStats;
+        lastRunPid = lastPid;
+        realTimeHorizon = horizon;
+        stallTicks = stalls;
+        if (cacheModel && cacheState)
+            *cacheModel = std::move(*cacheState);
+        if (powerModel && powerState)
+            *powerModel = std::move(*powerState);
+        std::copy(restoredCode.begin(), restoredCode.end(), code.begin());
+        nextCodeOffset = static_cast<int>(codeLines);
+        processes = table;
+        ownedProcesses = std::move(restored);
+        for (PCB *pcb : processes)
+        {
+            nextPid = std::max(nextPid, pcb->getPid() + 1);
+            nextSequence = std::max(nextSequence, pcb->numOfpro + 1);
+        }
+        for (PCB *pcb : processes)
+            if (pcb->isPeriodic())
+                periodicTasks.push_back(pcb);
+        for (PCB *pcb : ready)
+            readyQueue.push_back(pcb);
+        for (PCB *pcb : waiting)
+            waitingQueue.push_back(pcb);
+        terminatedCount = static_cast<int>(std::count_if(processes.begin(), processes.end(), [](const PCB *pcb)
+                                                         { return pcb->getCurrentState() == PCB::TERMINATED; }));
+        // 检查点中没有换出或挂起准入的进程：已到达且未终止的进程都在内存中
+        residentWords = 0;
+        for (PCB *pcb : processes)
+            if (pcb->getCurrentState() != PCB::TERMINATED && !waitingQueue.contains(pcb))
+                chargeMemory(pcb);
+        wokenProcesses = woken;
+        updatedProcesses = updated;
+        // 暂停发生在处理时刻 time 的定时器之前或之后都有可能，定时器从 time 开始重新安放；
+        // 已经处理过的到达与释放不会再有定时器（进程已不在等待队列、nextRelease 已后移）
+        timers.reset(time - 1);
+        dueReleases.clear();
+        for (PCB *pcb : waitingQueue)
+            armTimer(pcb, ArrivalTimer, pcb->getArrivalTime());
+        for (PCB *task : periodicTasks)
+            if (task->getCurrentState() != PCB::TERMINATED)
+                armTimer(task, ReleaseTimer, task->nextRelease);
+        log() << "Current time: " << now() << " Restored checkpoint with " << processes.size() << " processes." << std::endl;
+        return true;
+    }
+
+    // 当前模拟时间，可从任意线程无锁读取
+    int getCurrentTime() const { return static_cast<int>(clock->localNow(core)); }
+
+    // 输出自上次调度开始以来各阶段的耗时分解（需以 OSSIM_PHASE_TIMERS 编译）
+    void displayPhaseProfile(std::ostream &out = std::cout) const
+    {
+        phaseProfile.display(out, now() - phaseStartTime);
+    }
+
+    // 按编号选择内置调度策略，策略对象在栈上构造并以静态类型运行
+    void manageTimeAndSchedule(int selectedScheduleAlgorithm)
+    {
+        switch (selectedScheduleAlgorithm)
+        {
+        case 0: // 轮转调度
+        {
+            RoundRobinPolicy policy(timeSlice);
+            manageTimeAndSchedule(policy);
+            break;
+        }
+        case 1: // 先来先服务 (FCFS)
+        {
+            FcfsPolicy policy;
+            manageTimeAndSchedule(policy);
+            break;
+        }
+        case 2: // 最高优先级优先
+        {
+            PriorityPolicy policy;
+            manageTimeAndSchedule(policy);
+            break;
+        }
+        case 3: // 最短作业优先 (SJF，非抢占)
+        case 4: // 最短剩余时间优先 (SRTF，抢占)
+        {
+            ShortestJobPolicy policy(selectedScheduleAlgorithm == 4);
+            if (useBurstPrediction)
+                policy.enableBurstPrediction(burstAlpha, initialBurstEstimate);
+            manageTimeAndSchedule(policy);
+            break;
+        }
+        case 5: // 最早截止期优先 (EDF)
+        case 6: // 速率单调 (RM)
+        {
+            RealTimePolicy policy(selectedScheduleAlgorithm == 6);
+            displaySchedulabilityTest(selectedScheduleAlgorithm == 6);
+            manageTimeAndSchedule(policy);
+            break;
+        }
+        case 7: // 完全公平调度 (CFS)
+        {
+            CfsPolicy policy(cfsTargetLatency, cfsMinGranularity);
+            manageTimeAndSchedule(policy);
+            break;
+        }
+        case 8: // 彩票调度
+        {
+            LotteryPolicy policy(timeSlice, lotterySeed);
+            manageTimeAndSchedule(policy);
+            break;
+        }
+        case 9: // 步长调度
+        {
+            StridePolicy policy(timeSlice);
+            manageTimeAndSchedule(policy);
+            break;
+        }
+        default:
+            std::cerr << "Invalid scheduling algorithm selected." << std::endl;
+            return;
+        }
+    }
+
+    // 按编号构造内置调度策略，参数与 manageTimeAndSchedule(int) 相同，编号无效时返回空指针。
+    // 策略对象由调用者持有，可在多次暂停之间保留（集群的各节点按窗口运行时使用）
+    std::unique_ptr<SchedulerPolicy> makePolicy(int selectedScheduleAlgorithm) const
+    {
+        switch (selectedScheduleAlgorithm)
+        {
+        case 0:
+            return std::make_unique<RoundRobinPolicy>(timeSlice);
+        case 1:
+            return std::make_unique<FcfsPolicy>();
+        case 2:
+            return std::make_unique<PriorityPolicy>();
+        case 3:
+        case 4:
+        {
+            auto policy = std::make_unique<ShortestJobPolicy>(selectedScheduleAlgorithm == 4);
+            if (useBurstPrediction)
+                policy->enableBurstPrediction(burstAlpha, initialBurstEstimate);
+            return policy;
+        }
+        case 5:
+        case 6:
+            return std::make_unique<RealTimePolicy>(selectedScheduleAlgorithm == 6);
+        case 7:
+            return std::make_unique<CfsPolicy>(cfsTargetLatency, cfsMinGranularity);
+        case 8:
+            return std::make_unique<LotteryPolicy>(timeSlice, lotterySeed);
+        case 9:
+            return std::make_unique<StridePolicy>(timeSlice);
+        default:
+            return nullptr;
+        }
+    }
+
+    // 以任意调度策略运行。Policy 为具体的 final 类时调用全部静态绑定；
+    // Policy 为 SchedulerPolicy 时即为运行时插件
+    template <typename Policy>
+    void manageTimeAndSchedule(Policy &policy)
+    {
+        static_assert(std::is_base_of<SchedulerPolicy, Policy>::value, "Policy must derive from SchedulerPolicy");
+        if (heldPolicy != nullptr && heldPolicy != &policy)
+        {
+            std::cerr << "Scheduling was paused with a held policy; resume with the same policy object." << std::endl;
+            return;
+        }
+        heldPolicy = nullptr;
+        activePolicy = &policy;
+        phaseProfile.reset();
+        phaseStartTime = now();
+
+        while (true)
+        {
+            // 检查是否所有进程都已终止
+            if (areAllProcessesTerminated())
+            {
+                publishSnapshot(true);
+                log() << "All processes have terminated at time " << now() << "." << std::endl;
+                if (verbose)
+                    displayQueues();
+                if (!periodicTasks.empty())
+                    displayRealTimeReport();
+                break;
+            }
+
+            if (pauseTime >= 0 && now() >= pauseTime)
+            {
+                // 集群的同步窗口很短，按窗口暂停时只在到了发布间隔时才发布快照
+                bool hold = pauseHolds;
+                pauseTime = -1;
+                pauseHolds = false;
+                if (hold)
+                    heldPolicy = &policy;
+                else
+                    parkReadyProcesses(policy);
+                if (!hold || now() >= nextSnapshotTime)
+                    publishSnapshot(false);
+                log() << "Current time: " << now() << " Scheduling paused." << std::endl;
+                break;
+            }
+
+            if (now() >= nextSnapshotTime)
+                publishSnapshot(false);
+
+            // 按窗口暂停时停在时间片中途的进程从停下处继续，之间没有调度决策
+            if (currentProcess != nullptr)
+            {
+                continueProcess(policy, heldSlice);
+                continue;
+            }
+
+            // 检查并添加新到达的进程
+            checkAndAddNewArrivedProcesses();
+            releasePeriodicJobs();
+            // 唤醒等到终端输入的进程
+            recoverWaitingProcesses();
+            flushFileSystem();
+            releaseThrottledProcesses(policy);
+            dispatchPendingProcesses(policy);
+            balanceMemory(policy);
+
+            PCB *next;
+            {
+                ScopedPhaseTimer timer(phaseProfile, Phase::PickNext);
+                next = policy.pickNext(now());
+            }
+            // 策略中可能残留已在别处终止的进程（如周期任务到达仿真终点）
+            if (next != nullptr && next->getCurrentState() != PCB::READY)
+                continue;
+            // 所在控制组已用完本周期配额的进程挂起到限流解除
+            if (next != nullptr && next->group)
+            {
+                if (ControlGroup *holder = next->group->throttledAncestor(now()))
+                {
+                    holdThrottled(holder, next);
+                    continue;
+                }
+            }
+            // 如果没有就绪进程，CPU 处于空闲状态
+            if (next == nullptr)
+            {
+                if (isDeadlocked())
+                {
+                    publishSnapshot(false);
+                    std::cerr << "Deadlock at time " << now() << ": " << processes.size() - terminatedCount
+                              << " processes are blocked on channels or children that can never make progress." << std::endl;
+                    break;
+                }
+                log() << "Current time: " << now() << " CPU is idle." << std::endl;
+                idleTick();
+                // 当 CPU 空闲时推进时钟
+                clock->tick(core);
+                stats.onTick(false);
+                waitWhileIdle();
+                continue;
+            }
+
+            wakeFromIdle();
+            runProcess(policy, next);
+        }
+
+        activePolicy = nullptr;
+    }
+
+    // 可调度性分析：利用率界限与 RM 响应时间分析
+    void displaySchedulabilityTest(bool rateMonotonic) const
+    {
+        double utilization = 0;
+        double density = 0;
+        for (const auto &task : periodicTasks)
+        {
+            utilization += static_cast<double>(task->getWcet()) / task->getPeriod();
+            density += static_cast<double>(task->getWcet()) / std::min(task->getRelativeDeadline(), task->getPeriod());
+        }
+        size_t n = periodicTasks.size();
+        log() << "\nSchedulability Test (" << (rateMonotonic ? "RM" : "EDF") << "): " << n << " periodic tasks, U = " << utilization << std::endl;
+        if (n == 0)
+            return;
+
+        if (!rateMonotonic)
+        {
+            log() << "EDF: U <= 1 " << (utilization <= 1.0 ? "holds" : "fails")
+                      << ", density " << density << (density <= 1.0 ? " <= 1, schedulable." : " > 1, not guaranteed.") << std::endl;
+            return;
+        }
+
+        double bound = n * (std::pow(2.0, 1.0 / n) - 1);
+        log() << "RM: Liu-Layland bound " << bound << (utilization <= bound ? ", schedulable." : ", inconclusive.") << std::endl;
+
+        // 响应时间分析：R = C_i + sum_{j 优先级更高} ceil(R / T_j) * C_j
+        std::vector<PCB *> byRate(periodicTasks);
+        std::sort(byRate.begin(), byRate.end(), [](PCB *a, PCB *b)
+                  { return a->getPeriod() < b->getPeriod(); });
+        for (size_t i = 0; i < byRate.size(); ++i)
+        {
+            long long response = byRate[i]->getWcet();
+            long long previous = -1;
+            while (response != previous && response <= byRate[i]->getRelativeDeadline())
+            {
+                previous = response;
+                response = byRate[i]->getWcet();
+                for (size_t j = 0; j < i; ++j)
+                    response += (previous + byRate[j]->getPeriod() - 1) / byRate[j]->getPeriod() * byRate[j]->getWcet();
+            }
+            log() << "  Task " << byRate[i]->getPid() << ": worst-case response " << response << ", deadline "
+                      << byRate[i]->getRelativeDeadline() << (response <= byRate[i]->getRelativeDeadline() ? " (ok)" : " (miss)") << std::endl;
+        }
+    }
+
+    // 周期任务的截止期统计
+    void displayRealTimeReport() const
+    {
+        log() << "\nReal-Time Report:" << std::endl;
+        int totalMisses = 0;
+        for (const auto &task : periodicTasks)
+        {
+            totalMisses += task->deadlineMisses;
+            log() << "Task " << task->getPid() << ": released " << task->jobsReleased << ", completed " << task->jobsCompleted
+                      << ", deadline misses " << task->deadlineMisses;
+            if (task->jobsCompleted > 0)
+                log() << ", avg lateness " << static_cast<double>(task->totalLateness) / task->jobsCompleted
+                          << ", max lateness " << task->maxLateness;
+            log() << std::endl;
+        }
+        log() << "Total deadline misses: " << totalMisses << std::endl;
+    }
+
+    void displayQueues() const
+    {
+        log() << "\nFinal Queue Status:" << std::endl;
+
+        LogLine ready = log();
+        ready << "Ready Queue: ";
+        forEachReady([&ready](PCB *pcb)
+                     { ready << pcb->getPid() << " "; });
+        ready << std::endl;
+
+        LogLine terminated = log();
+        terminated << "Terminated Queue (" << terminatedCount << "): ";
+        forEachTerminated([&terminated](PCB *pcb)
+                          { terminated << pcb->getPid() << " "; });
+        terminated << std::endl;
+    }
+
+private:
+    SimClock ownClock;                                         // 独立运行时使用的时钟
+    SimClock *clock;                                           // 当前系统时间，读取无需加锁
+    int core;                                                  // 本 CPU 在时钟中的核号
+    int timeSlice;                                             // 轮转调度的时间片大小
+    PCB *currentProcess;                                       // 当前执行的进程
+    std::vector<PCB *> processes;                              // 所有进程
+    std::vector<std::string> code;                             // 指令内存，存放所有进程的指令
+    int nextCodeOffset = 0;                                    // 下一个空闲的指令内存位置
+    SchedStats stats;                                          // 调度统计
+    Seqlock<StatsSnapshot> published;                          // 供监控线程读取的统计快照
+    int snapshotInterval = 256;                                // 发布快照的间隔（tick）
+    long long nextSnapshotTime = 0;                            // 下一次发布快照的模拟时刻
+    ProcessList readyQueue;                                    // 就绪队列（新就绪、尚未交给调度策略的进程）
+    ProcessList waitingQueue;                                  // 等待队列（未到达或被阻塞的进程）
+    int terminatedCount = 0;                                   // 已终止的进程数
+    std::vector<PCB *> wokenProcesses;                         // 被唤醒、尚未通知调度策略的进程
+    std::vector<PCB *> updatedProcesses;                       // 调度参数变化、尚未通知调度策略的就绪进程
+    mutable std::mutex mutexForQueues;                         // 队列操作的互斥锁
+    std::chrono::steady_clock::time_point lastInstructionTime; // 记录上一次执行指令的时间
+    SchedulerPolicy *activePolicy = nullptr;                   // 正在运行的调度策略，仅用于显示
+    SchedulerPolicy *heldPolicy = nullptr;                     // 按窗口暂停时保留着就绪进程的策略
+    int phaseStartTime = 0;                                    // 本次调度开始时的模拟时间
+    int pauseTime = -1;                                        // 暂停时刻，-1 表示不暂停
+    bool pauseHolds = false;                                   // 暂停时是否保留运行中的进程与策略，见 pauseAt
+    int heldSlice = 0;                                         // 停在时间片中途的当前进程剩余的时间片
+    std::vector<std::unique_ptr<PCB>> ownedProcesses;          // 从检查点恢复的进程
+    std::unordered_map<const PCB *, Program> programs;         // 协程进程的程序
+    long long nextPid = 1;                                     // fork 分配的下一个进程号
+    int nextSequence = 0;                                      // 下一个加入的进程的序号（numOfpro），迁出进程后也不重复
+
+    // 进程定时器到期时的动作（PCB::timerEvent）
+    enum TimerEvent
+    {
+        ArrivalTimer,   // 进程到达
+        WakeTimer,      // 睡眠或 I/O 结束
+        ReceiveTimeout, // 限时接收超时
+        ReleaseTimer,   // 周期任务释放下一个作业
+        SwapInTimer     // 换入完成
+    };
+    ProcessTimers timers;             // 所有进程的定时器
+    std::vector<PCB *> expiredTimers; // 本次推进中到期的进程
+    std::vector<PCB *> dueReleases;   // 已到释放时刻、尚未释放作业的周期任务
+
+    Terminal *terminal = nullptr; // 进程读取输入的终端，为空表示未连接
+    FileSystem *fileSystem = nullptr; // 进程读写文件的文件系统，为空表示未连接
+    CacheHierarchy *cacheModel = nullptr; // 缓存模型，为空表示访存不计停顿
+    long long lastRunPid = -1;            // 上一个在本 CPU 上运行的进程，换成别的进程时计一次切换（统计与缓存模型共用）
+    long long stallTicks = 0;
+
+    std::vector<ControlGroup *> throttledGroups; // 限流中且挂起了进程的控制组
+
+    PowerModel *powerModel = nullptr; // 功耗模型，为空表示总以满速运行、不计能量
+
+    // 中级调度
+    long long memoryLimit = 0;          // 内存限额（字），0 表示不限
+    double swapThreshold = 0.9;         // 开始换出阻塞进程的占用比例
+    long long residentWords = 0;        // 在内存中的进程占用之和
+    SwapDevice *swapDevice = nullptr;   // 交换设备，为空时只做准入控制
+    int swapLatency = 1;                // 换入的固定耗时（tick）
+    int swapPagesPerTick = 64;          // 换入每 tick 传输的页数
+    ProcessList admissionQueue;         // 到达后等待内存的进程，按到达顺序
+    ProcessList swapInQueue;            // 等待换入的 SUSPENDED_READY 进程，按就绪顺序
+    long long peakResidentWords = 0;
+    long long arrivalsHeld = 0;
+    long long swapOuts = 0;
+    long long swapIns = 0;
+    long long pagesSwappedOut = 0;
+    long long pagesSwappedIn = 0;
+
+    int now() const { return static_cast<int>(clock->localNow(core)); }
+
+    int instructionDelayMs = 200; // 每条指令模拟耗时
+    int idleDelayMs = 500;        // 空闲时每个 tick 的模拟耗时
+    bool verbose = true;          // 是否输出调度日志
+
+    mutable PhaseProfile phaseProfile; // 调度循环各阶段的耗时
+
+    // 一条调度日志：生命周期覆盖整条输出语句，计入 logging 阶段
+    class LogLine
+    {
+    public:
+        LogLine(std::ostream &_out, PhaseProfile &profile) : out(_out), timer(profile, Phase::Logging) {}
+
+        template <typename T>
+        LogLine &operator<<(const T &value)
+        {
+            out << value;
+            return *this;
+        }
+
+        LogLine &operator<<(std::ostream &(*manipulator)(std::ostream &))
+        {
+            out << manipulator;
+            return *this;
+        }
+
+    private:
+        std::ostream &out;
+        ScopedPhaseTimer timer;
+    };
+
+    // 调度日志，关闭日志时写入一个丢弃所有输出的流
+    LogLine log() const
+    {
+        return LogLine(verbose ? std::cout : discard, phaseProfile);
+    }
+
+    mutable std::ostream discard{nullptr}; // 丢弃输出的流，每个 CPU 一个，避免并行模拟时共享流状态
+
+    std::vector<PCB *> periodicTasks; // 周期性实时任务
+    int realTimeHorizon = -1;         // 周期任务停止释放作业的时刻
+
+    // 内置策略的参数，由 manageTimeAndSchedule(int) 构造策略时使用
+    bool useBurstPrediction = false;
+    double burstAlpha = 0.5;
+    double initialBurstEstimate = 5.0;
+    int cfsTargetLatency = 12;
+    int cfsMinGranularity = 2;
+    unsigned long long lotterySeed = 20241019;
+
+    // 检查是否所有进程都已终止
+    bool areAllProcessesTerminated() const
+    {
+        return terminatedCount == static_cast<int>(processes.size());
+    }
+
+    void armTimer(PCB *process, TimerEvent event, long long expires)
+    {
+        process->timerEvent = event;
+        timers.schedule(process, expires);
+    }
+
+    // 检查并添加新到达的进程：推进时间轮，到达的进程进入就绪队列，睡眠、I/O 结束或接收超时的进程被唤醒，
+    // 到了释放时刻的周期任务交给 releasePeriodicJobs
+    void checkAndAddNewArrivedProcesses()
+    {
+        ScopedPhaseTimer timer(phaseProfile, Phase::CheckArrivals);
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        timers.advance(now(), [this](PCB *pcb)
+                       { expiredTimers.push_back(pcb); });
+        if (expiredTimers.empty())
+            return;
+        // 同一时刻到期的定时器按进程表顺序处理，与定时器加入的先后无关
+        std::sort(expiredTimers.begin(), expiredTimers.end(), [](const PCB *a, const PCB *b)
+                  { return a->schedIndex < b->schedIndex; });
+        for (PCB *pcb : expiredTimers)
+        {
+            switch (pcb->timerEvent)
+            {
+            case ArrivalTimer:
+                if (!admit(pcb))
+                    break;
+                pcb->setCurrentState(PCB::READY);
+                stats.onReady(pcb, now());
+                log() << "Current time: " << now() << " Process(" << pcb->getPid() << ") has arrived and is in READY state." << std::endl;
+                readyQueue.push_back(pcb); // 从等待队列移入就绪队列，只改指针
+                break;
+            case WakeTimer:
+                log() << "Current time: " << now() << " Process(" << pcb->getPid() << ") is woken up." << std::endl;
+                wakeProcess(pcb);
+                break;
+            case ReceiveTimeout:
+                ProcessList::unlink(pcb); // 离开通道的接收者队列
+                Program::from(pcb->program).promise().timedOut = true;
+                log() << "Current time: " << now() << " Process(" << pcb->getPid() << ") timed out waiting for a message." << std::endl;
+                wakeProcess(pcb);
+                break;
+            case ReleaseTimer:
+                dueReleases.push_back(pcb);
+                break;
+            case SwapInTimer:
+                completeSwapIn(pcb);
+                break;
+            }
+        }
+        expiredTimers.clear();
+    }
+
+    // 阻塞的进程重新就绪，由 dispatchPendingProcesses 通知调度策略；已被换出的进程等待换入。调用者持有队列锁
+    void wakeProcess(PCB *process)
+    {
+        if (process->getCurrentState() == PCB::SUSPENDED_BLOCKED)
+        {
+            process->setCurrentState(PCB::SUSPENDED_READY);
+            stats.onReady(process, now());
+            swapInQueue.push_back(process);
+            return;
+        }
+        process->setCurrentState(PCB::READY);
+        stats.onReady(process, now());
+        wokenProcesses.push_back(process);
+    }
+
+    bool isComplete(const PCB *process) const
+    {
+        if (process->exited)
+            return true;
+        if (process->program)
+            return false;
+        return !process->isPeriodic() && process->getUsedRunTime() >= process->getTotalRunTime();
+    }
+
+    // 没有进程就绪、也没有任何进程会在将来到达或被唤醒，剩余进程都阻塞在通道或 wait 上
+    bool isDeadlocked() const
+    {
+        if (programs.empty() || !timers.empty() || !waitingQueue.empty() || !throttledGroups.empty())
+            return false;
+        if (terminal && !terminal->readers.empty())
+            return false;
+        return std::all_of(periodicTasks.begin(), periodicTasks.end(), [](const PCB *task)
+                           { return task->getCurrentState() == PCB::TERMINATED; });
+    }
+
+    // 恢复协程进程，处理它提出的请求，直到它需要 CPU 时间、阻塞或结束。
+    // 通信、进程管理与访存请求不耗时，处理后继续恢复
+    void advanceProgram(PCB *process)
+    {
+        ScopedPhaseTimer timer(phaseProfile, Phase::Execute);
+        while (true)
+        {
+            // exec 会替换协程，每次恢复前重新取句柄
+            Program::Handle handle = Program::from(process->program);
+            Program::promise_type &promise = handle.promise();
+            promise.request = ProgramRequest();
+            handle.resume();
+            if (handle.done())
+            {
+                finishProgram(process, promise.error ? reportProgramError(process, promise.error) : 0);
+                return;
+            }
+
+            const ProgramRequest &request = promise.request;
+            switch (request.kind)
+            {
+            case ProgramRequest::Compute:
+                process->burstRemaining = request.ticks;
+                return;
+            case ProgramRequest::Io:
+            case ProgramRequest::Sleep:
+                process->setCurrentState(PCB::BLOCKED);
+                armTimer(process, WakeTimer, now() + request.ticks);
+                log() << "Current time: " << now() << " Process " << process->getPid() << (request.kind == ProgramRequest::Io ? " waits for I/O" : " sleeps")
+                      << " until " << now() + request.ticks << "." << std::endl;
+                return;
+            case ProgramRequest::Send:
+            {
+                std::lock_guard<std::mutex> guard(mutexForQueues);
+                if (PCB *receiver = request.channel->receivers.pop_front())
+                {
+                    timers.cancel(receiver);
+                    Program::from(receiver->program).promise().mailbox = request.value;
+                    log() << "Current time: " << now() << " Process " << process->getPid() << " sends " << request.value
+                          << " to process " << receiver->getPid() << "." << std::endl;
+                    wakeProcess(receiver);
+                }
+                else
+                    request.channel->put(request.value);
+                break;
+            }
+            case ProgramRequest::Receive:
+            {
+                std::lock_guard<std::mutex> guard(mutexForQueues);
+                process->setCurrentState(PCB::BLOCKED);
+                request.channel->receivers.push_back(process);
+                if (request.ticks > 0)
+                    armTimer(process, ReceiveTimeout, now() + request.ticks);
+                log() << "Current time: " << now() << " Process " << process->getPid() << " waits for a message." << std::endl;
+                return;
+            }
+            case ProgramRequest::Fork:
+                promise.childPid = forkProcess(process, std::move(*request.program));
+                break;
+            case ProgramRequest::Exec:
+                execProgram(process, std::move(*request.program), request.value);
+                break;
+            case ProgramRequest::Wait:
+                if (!waitForChild(process, promise))
+                    return;
+                break;
+            case ProgramRequest::Exit:
+                finishProgram(process, request.value);
+                return;
+            case ProgramRequest::Load:
+            case ProgramRequest::Store:
+            {
+                bool mapped = request.kind == ProgramRequest::Load ? process->addressSpace.read(request.address, promise.mailbox)
+                                                                   : process->addressSpace.write(request.address, request.value);
+                if (!mapped)
+                {
+                    segmentationFault(process, request.address);
+                    return;
+                }
+                chargeAccess(process, request.address);
+                break;
+            }
+            case ProgramRequest::Open:
+                promise.mailbox = fileSystem ? fileSystem->open(request.path, request.value != 0) : -1;
+                break;
+            case ProgramRequest::FileRead:
+            case ProgramRequest::FileWrite:
+                if (!transferFile(process, request, promise))
+                    return;
+                break;
+            case ProgramRequest::None:
+                break;
+            }
+        }
+    }
 
-class CPU
-{
-public:
-    CPU(int _timeSlice)
-        : timeSlice(_timeSlice),
-          currentProcess(nullptr),
-          inputAvailable(false),
-          lastInstructionTime(std::chrono::steady_clock::now()) // 初始化上一次指令执行时间为当前时间
+    void segmentationFault(PCB *process, int address)
     {
+        log() << "Current time: " << now() << " Process " << process->getPid() << " segmentation fault at address " << address << "." << std::endl;
+        finishProgram(process, 139); // 与 shell 中被 SIGSEGV 终止的状态一致
     }
 
-    void addProcess(PCB *process)
+    // 文件读写：结果写入 mailbox。数据不在缓冲区缓存中时进程阻塞到读盘完成，此时以及进程段错误终止时返回 false
+    bool transferFile(PCB *process, const ProgramRequest &request, Program::promise_type &promise)
     {
-        std::lock_guard<std::mutex> guard(mutexForQueues);
-        processes.push_back(process);
-        // 初始状态为 READY 或 BLOCKED，根据 arrivalTime
-        if (process->getArrivalTime() <= currentTime)
+        if (fileSystem == nullptr)
         {
-            process->setCurrentState(PCB::READY);
-            std::cout << "Current time: " << currentTime << " Process(" << process->getPid() << ") is in READY state." << std::endl;
-            readyQueue.push(process);
+            promise.mailbox = -1;
+            return true;
         }
-        else
+        if (request.count > 0 && (request.address < 0 || request.address > process->addressSpace.size() - request.count))
         {
-            // 使用 BLOCKED 表示进程尚未到达
-            process->setCurrentState(PCB::BLOCKED);
-            std::cout << "Current time: " << currentTime << " Process(" << process->getPid() << ") is in BLOCKED state (Not Arrived)." << std::endl;
-            waitingQueue.push(process);
+            segmentationFault(process, request.address < 0 ? request.address : std::max(request.address, process->addressSpace.size())); // 第一个越界的地址
+            return false;
         }
+        FileSystem::Transfer transfer = request.kind == ProgramRequest::FileRead
+                                            ? fileSystem->read(process->getPid(), request.value, request.offset, request.count, process->addressSpace, request.address, now())
+                                            : fileSystem->write(process->getPid(), request.value, request.offset, request.count, process->addressSpace, request.address, now());
+        promise.mailbox = transfer.words;
+        if (cacheModel)
+            for (int offset = 0; offset < transfer.words; offset += cacheModel->lineWords())
+                chargeAccess(process, request.address + offset);
+        if (transfer.readyAt <= now())
+            return true;
+        process->setCurrentState(PCB::BLOCKED);
+        armTimer(process, WakeTimer, transfer.readyAt);
+        log() << "Current time: " << now() << " Process " << process->getPid() << " waits for disk until " << transfer.readyAt << "." << std::endl;
+        return false;
     }
 
-    void manageTimeAndSchedule(int selectedScheduleAlgorithm)
+    // 进程访问 address 处的字，停顿周期记到进程上
+    void chargeAccess(PCB *process, long long address)
     {
-        while (true)
+        if (cacheModel)
+            process->stallCycles += cacheModel->access(process->getPid(), address);
+    }
+
+    // 计算一个 tick：在进程的工作集（地址空间，没有时取配置的大小）中随机访存
+    void touchWorkingSet(PCB *process)
+    {
+        const CacheHierarchy::Config &config = cacheModel->getConfig();
+        int words = process->addressSpace.size() > 0 ? process->addressSpace.size() : config.workingSetWords;
+        for (int i = 0; i < config.accessesPerTick; ++i)
+            chargeAccess(process, CacheHierarchy::workingSetAddress(process->getPid(), process->cacheAccesses++, words));
+    }
+
+    void flushFileSystem()
+    {
+        if (fileSystem)
+            fileSystem->flush(now());
+    }
+
+    // 输出协程体抛出的异常，返回进程的退出状态
+    static int reportProgramError(PCB *process, std::exception_ptr error)
+    {
+        try
         {
-            // 检查是否所有进程都已终止
-            if (areAllProcessesTerminated())
-            {
-                std::cout << "All processes have terminated at time " << currentTime << "." << std::endl;
-                break;
-            }
+            std::rethrow_exception(error);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Process " << process->getPid() << " terminated by exception: " << e.what() << std::endl;
+        }
+        catch (...)
+        {
+            std::cerr << "Process " << process->getPid() << " terminated by an unknown exception." << std::endl;
+        }
+        return 1;
+    }
 
-            // 检查并添加新到达的进程
-            checkAndAddNewArrivedProcesses();
+    // 协程进程结束：记录退出状态并立即释放协程帧，进程随后在 runProcess 中终止
+    void finishProgram(PCB *process, int status)
+    {
+        process->exitStatus = status;
+        process->exited = true;
+        process->program = nullptr;
+        programs.erase(process);
+    }
 
-            // 恢复等待队列中的进程
-            recoverWaitingProcesses();
+    // 创建子进程：继承优先级、票数与控制组，以写时复制方式共享父进程的地址空间，立即就绪
+    long long forkProcess(PCB *parent, Program program)
+    {
+        PCB *child = new PCB(nextPid, parent->getPriority(), now());
+        ownedProcesses.emplace_back(child);
+        child->tickets = parent->tickets;
+        if (parent->group)
+            parent->group->attach(child);
+        child->parent = parent;
+        parent->children.push_back(child);
+        child->addressSpace = parent->addressSpace.fork();
+        log() << "Current time: " << now() << " Process " << parent->getPid() << " forked process " << child->getPid() << "." << std::endl;
+        addProgram(child, std::move(program));
+        return child->getPid();
+    }
 
-            // 如果就绪队列为空，CPU 处于空闲状态
-            if (readyQueue.empty())
-            {
-                std::cout << "Current time: " << currentTime << " CPU is idle." << std::endl;
-                // 当 CPU 空闲时递增 currentTime
-                currentTime++;
-                std::this_thread::sleep_for(std::chrono::milliseconds(500)); // 模拟时间流逝，减少等待时间
-                continue;
-            }
+    // 以新程序替换进程的程序与地址空间，旧程序的协程帧在此销毁
+    void execProgram(PCB *process, Program image, int memoryWords)
+    {
+        process->program = image.get();
+        programs[process] = std::move(image);
+        uncharge(process);
+        process->addressSpace = AddressSpace(memoryWords);
+        chargeMemory(process);
+        log() << "Current time: " << now() << " Process " << process->getPid() << " exec'd a new program." << std::endl;
+    }
 
-            // 根据调度算法选择并执行进程
-            switch (selectedScheduleAlgorithm)
+    // 有已终止的子进程时回收第一个；没有子进程时结果为 -1。两种情况都返回 true，
+    // 否则阻塞直到某个子进程终止，返回 false
+    bool waitForChild(PCB *process, Program::promise_type &promise)
+    {
+        if (process->children.empty())
+        {
+            promise.childPid = -1;
+            promise.mailbox = 0;
+            return true;
+        }
+        for (PCB *child : process->children)
+        {
+            if (child->zombie)
             {
-            case 0: // 轮转调度
-                RoundRobin_Schedule();
-                break;
-            case 1: // 先来先服务 (FCFS)
-                FCFS_Schedule();
-                break;
-            case 2: // 最高优先级优先
-                HighestPriorityFirst_Schedule();
-                break;
-            default:
-                std::cerr << "Invalid scheduling algorithm selected." << std::endl;
-                return;
+                reapChild(process, child, promise);
+                return true;
             }
         }
+        process->waitingForChild = true;
+        process->setCurrentState(PCB::BLOCKED);
+        log() << "Current time: " << now() << " Process " << process->getPid() << " waits for a child." << std::endl;
+        return false;
     }
 
-    void displayQueues() const
+    void reapChild(PCB *parent, PCB *child, Program::promise_type &promise)
     {
-        std::lock_guard<std::mutex> guard(mutexForQueues); // 确保队列操作的线程安全
-        std::cout << "\nFinal Queue Status:" << std::endl;
+        child->zombie = false;
+        child->parent = nullptr;
+        parent->children.erase(std::find(parent->children.begin(), parent->children.end(), child));
+        promise.childPid = child->getPid();
+        promise.mailbox = child->exitStatus;
+        log() << "Current time: " << now() << " Process " << parent->getPid() << " reaped process " << child->getPid()
+              << " (status " << child->exitStatus << ")." << std::endl;
+    }
 
-        std::cout << "Ready Queue: ";
-        std::queue<PCB *> tempReady = readyQueue;
-        while (!tempReady.empty())
+    // 进程终止后的清理：释放地址空间，子进程交给 init（已终止的直接回收），
+    // 父进程正在 wait 时立即回收并唤醒它，否则成为僵尸进程等待回收
+    void releaseProcess(PCB *process)
+    {
+        uncharge(process);
+        process->addressSpace = AddressSpace();
+        for (PCB *child : process->children)
         {
-            std::cout << tempReady.front()->getPid() << " ";
-            tempReady.pop();
+            child->parent = nullptr;
+            child->zombie = false;
         }
-        std::cout << std::endl;
+        process->children.clear();
 
-        std::cout << "Terminated Queue: ";
-        std::queue<PCB *> tempTerminated = terminatedQueue;
-        while (!tempTerminated.empty())
+        PCB *parent = process->parent;
+        if (parent == nullptr)
+            return;
+        if (parent->waitingForChild && parent->program)
         {
-            std::cout << tempTerminated.front()->getPid() << " ";
-            tempTerminated.pop();
+            parent->waitingForChild = false;
+            reapChild(parent, process, Program::from(parent->program).promise());
+            std::lock_guard<std::mutex> guard(mutexForQueues);
+            wakeProcess(parent);
+            return;
         }
-        std::cout << std::endl;
+        process->zombie = true;
+        log() << "Current time: " << now() << " Process " << process->getPid() << " is a zombie until its parent waits." << std::endl;
     }
 
-private:
-    int currentTime = 0;                                       // 当前系统时间
-    int timeSlice;                                             // 轮转调度的时间片大小
-    PCB *currentProcess;                                       // 当前执行的进程
-    std::vector<PCB *> processes;                              // 所有进程
-    std::queue<PCB *> readyQueue;                              // 就绪队列
-    std::queue<PCB *> terminatedQueue;                         // 终止队列
-    std::queue<PCB *> waitingQueue;                            // 等待队列（未到达或被阻塞的进程）
-    mutable std::mutex mutexForQueues;                         // 队列操作的互斥锁
-    std::chrono::steady_clock::time_point lastInstructionTime; // 记录上一次执行指令的时间
+    void chargeMemory(PCB *process)
+    {
+        process->resident = true;
+        residentWords += process->addressSpace.size();
+        peakResidentWords = std::max(peakResidentWords, residentWords);
+    }
 
-    bool inputAvailable;
+    void uncharge(PCB *process)
+    {
+        if (!process->resident)
+            return;
+        process->resident = false;
+        residentWords -= process->addressSpace.size();
+    }
 
-    // 检查是否所有进程都已终止
-    bool areAllProcessesTerminated() const
+    // 进程放得进内存；内存中没有进程时即使超过限额也放得进，避免大进程永远等待
+    bool fitsInMemory(const PCB *process) const
+    {
+        return memoryLimit <= 0 || residentWords == 0 || residentWords + process->addressSpace.size() <= memoryLimit;
+    }
+
+    // 准入控制：内存足够且没有更早到达的进程在等时准入并计入内存占用，否则挂起等待，返回 false。调用者持有队列锁
+    bool admit(PCB *process)
     {
-        for (const auto &pcb : processes)
+        if (memoryLimit > 0 && (!admissionQueue.empty() || !fitsInMemory(process)))
         {
-            if (pcb->getCurrentState() != PCB::TERMINATED)
-                return false;
+            process->setCurrentState(PCB::BLOCKED);
+            admissionQueue.push_back(process);
+            arrivalsHeld++;
+            log() << "Current time: " << now() << " Process(" << process->getPid() << ") is held by admission control, needs "
+                  << process->addressSpace.size() << " words." << std::endl;
+            return false;
         }
+        chargeMemory(process);
         return true;
     }
 
-    // 检查并添加新到达的进程
-    void checkAndAddNewArrivedProcesses()
+    // 中级调度：内存占用超过阈值时换出阻塞的进程，超过限额时也换出就绪进程；
+    // 然后按顺序换入等待的 SUSPENDED_READY 进程、准入挂起的新进程，放不下时先换出阻塞的进程腾出内存。
+    // 已准入的进程优先于新进程，两个队列都不插队
+    template <typename Policy>
+    void balanceMemory(Policy &policy)
     {
+        if (memoryLimit <= 0)
+            return;
+        ScopedPhaseTimer timer(phaseProfile, Phase::CheckArrivals);
         std::lock_guard<std::mutex> guard(mutexForQueues);
-        std::vector<PCB *> newlyArrivedProcesses;
-        for (auto &pcb : processes)
-        {
-            // 如果进程处于 BLOCKED 并且 arrivalTime <= currentTime 且未被调度过
-            // 这里假设 BLOCKED 状态既用于等待输入也用于未到达
-            // 需要区分这两种情况，可以通过另一个标志或状态管理
-            // 为简单起见，这里假设 BLOCKED 且 arrivalTime <= current_time 表示已到达
-            if (pcb->getCurrentState() == PCB::BLOCKED && pcb->getArrivalTime() <= currentTime && pcb->getUsedRunTime() == 0 && pcb->programCounter == 0)
-            {
-                pcb->setCurrentState(PCB::READY);
-                std::cout << "Current time: " << currentTime << " Process(" << pcb->getPid() << ") has arrived and is in READY state." << std::endl;
-                readyQueue.push(pcb);
-                newlyArrivedProcesses.push_back(pcb);
-            }
+        while (residentWords > memoryLimit * swapThreshold && swapOutVictim(policy, false))
+            ;
+        while (residentWords > memoryLimit && swapOutVictim(policy, true))
+            ;
+
+        while (PCB *process = swapInQueue.front())
+        {
+            if (!makeRoom(policy, process))
+                return;
+            swapInQueue.pop_front();
+            startSwapIn(process);
+        }
+        while (PCB *process = admissionQueue.front())
+        {
+            if (!makeRoom(policy, process))
+                break;
+            admissionQueue.pop_front();
+            chargeMemory(process);
+            process->setCurrentState(PCB::READY);
+            stats.onReady(process, now());
+            log() << "Current time: " << now() << " Process(" << process->getPid() << ") is admitted and is in READY state." << std::endl;
+            policy.onEnqueue(process, now());
         }
+    }
+
+    // 换出阻塞的进程直到 process 放得进内存
+    template <typename Policy>
+    bool makeRoom(Policy &policy, const PCB *process)
+    {
+        while (!fitsInMemory(process))
+            if (!swapOutVictim(policy, false))
+                return false;
+        return true;
+    }
 
-        // 从等待队列中移除已到达的进程
-        for (auto pcb : newlyArrivedProcesses)
+    // 选择并换出一个进程：优先阻塞的进程，其次（allowReady 时）就绪进程；同类中优先级低、占用大的先换出。
+    // 周期任务常驻内存。没有可换出的进程或交换设备已满时返回 false
+    template <typename Policy>
+    bool swapOutVictim(Policy &policy, bool allowReady)
+    {
+        if (swapDevice == nullptr)
+            return false;
+        PCB *victim = nullptr;
+        auto rank = [](const PCB *pcb)
         {
-            // 创建一个临时队列，排除已到达的进程
-            std::queue<PCB *> tempQueue;
-            while (!waitingQueue.empty())
+            return std::make_tuple(pcb->getCurrentState() == PCB::READY, pcb->getPriority(), -static_cast<long long>(pcb->addressSpace.size()));
+        };
+        for (PCB *pcb : processes)
+        {
+            if (!pcb->resident || pcb->isPeriodic() || pcb->addressSpace.size() == 0)
+                continue;
+            PCB::State state = pcb->getCurrentState();
+            if (state != PCB::BLOCKED && !(allowReady && state == PCB::READY))
+                continue;
+            if (victim == nullptr || rank(pcb) < rank(victim))
+                victim = pcb;
+        }
+        return victim != nullptr && swapOut(policy, victim);
+    }
+
+    // 把进程已分配的页写入交换设备并释放其内存；设备放不下时放弃，进程保持原状
+    template <typename Policy>
+    bool swapOut(Policy &policy, PCB *process)
+    {
+        std::vector<std::pair<int, int>> slots;
+        bool full = false;
+        process->addressSpace.forEachPage([&](int index, const int *data)
+                                          {
+            int slot = full ? -1 : swapDevice->allocate();
+            if (slot < 0)
             {
-                PCB *proc = waitingQueue.front();
-                waitingQueue.pop();
-                if (proc != pcb)
-                {
-                    tempQueue.push(proc);
-                }
+                full = true;
+                return;
             }
-            waitingQueue = tempQueue;
+            std::copy(data, data + SwapDevice::PAGE_WORDS, swapDevice->page(slot));
+            slots.emplace_back(index, slot); });
+        if (full)
+        {
+            for (const auto &entry : slots)
+                swapDevice->release(entry.second);
+            return false;
+        }
+
+        uncharge(process);
+        process->swapSlots = std::move(slots);
+        process->addressSpace = AddressSpace(process->addressSpace.size());
+        if (process->getCurrentState() == PCB::READY)
+        {
+            policy.onSuspend(process, now());
+            process->setCurrentState(PCB::SUSPENDED_READY);
+            swapInQueue.push_back(process);
         }
+        else
+            process->setCurrentState(PCB::SUSPENDED_BLOCKED);
+        swapOuts++;
+        pagesSwappedOut += process->swapSlots.size();
+        log() << "Current time: " << now() << " Process " << process->getPid() << " is swapped out (" << process->swapSlots.size()
+              << " pages), " << residentWords << " words resident." << std::endl;
+        return true;
     }
 
-    // 恢复等待队列中的进程（现已不使用多线程输入，保留以备未来扩展）
-    void recoverWaitingProcesses()
+    // 为进程预留内存并开始换入，传输完成时由 SwapInTimer 调用 completeSwapIn
+    void startSwapIn(PCB *process)
     {
-        // 保留此函数以备未来使用多线程输入时恢复等待的进程
+        chargeMemory(process);
+        int ticks = swapLatency + static_cast<int>(process->swapSlots.size()) / swapPagesPerTick;
+        armTimer(process, SwapInTimer, now() + ticks);
+        log() << "Current time: " << now() << " Process " << process->getPid() << " is being swapped in ("
+              << process->swapSlots.size() << " pages, " << ticks << " ticks)." << std::endl;
     }
 
-    // 获取进程当前等待的变量名
-    std::string getCurrentReadVariable(PCB *process)
+    void completeSwapIn(PCB *process)
     {
-        if (process->programCounter >= process->getCodeLength())
-            return "";
-
-        std::string instruction = code[process->getCodeStartIndex() + process->programCounter];
-        std::istringstream iss(instruction);
-        std::string cmd, var;
-        iss >> cmd >> var;
-        var = stripComma(var);
-        return var;
+        for (const auto &entry : process->swapSlots)
+        {
+            process->addressSpace.writePage(entry.first, swapDevice->page(entry.second));
+            swapDevice->release(entry.second);
+        }
+        swapIns++;
+        pagesSwappedIn += process->swapSlots.size();
+        process->swapSlots.clear();
+        // 换出前已按就绪计入统计，这里只交给调度策略
+        process->setCurrentState(PCB::READY);
+        wokenProcesses.push_back(process);
+        log() << "Current time: " << now() << " Process(" << process->getPid() << ") is swapped in and is in READY state." << std::endl;
     }
 
-    // 轮转调度
-    void RoundRobin_Schedule()
+    // 将新就绪和被唤醒的进程交给调度策略
+    template <typename Policy>
+    void dispatchPendingProcesses(Policy &policy)
     {
-        if (readyQueue.empty())
-            return;
+        ScopedPhaseTimer timer(phaseProfile, Phase::CheckArrivals);
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        while (PCB *pcb = readyQueue.pop_front())
+            policy.onEnqueue(pcb, now());
+        for (PCB *pcb : wokenProcesses)
+            policy.onWake(pcb, now());
+        wokenProcesses.clear();
+        for (PCB *pcb : updatedProcesses)
+            policy.onUpdate(pcb, now());
+        updatedProcesses.clear();
+    }
 
+    void publishSnapshot(bool finished)
+    {
+        StatsSnapshot snapshot = stats.snapshot(now());
         {
             std::lock_guard<std::mutex> guard(mutexForQueues);
-            currentProcess = readyQueue.front();
-            readyQueue.pop();
+            snapshot.processes = static_cast<int>(processes.size());
+            snapshot.terminated = terminatedCount;
         }
+        snapshot.finished = finished;
+        published.store(snapshot);
+        nextSnapshotTime = now() + snapshotInterval;
+    }
+
+    // 暂停时按调度顺序取出策略中的全部就绪进程放回就绪队列，策略对象随之清空，CPU 不再依赖它
+    template <typename Policy>
+    void parkReadyProcesses(Policy &policy)
+    {
+        dispatchPendingProcesses(policy);
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        while (PCB *pcb = policy.pickNext(now()))
+            if (pcb->getCurrentState() == PCB::READY)
+                readyQueue.push_back(pcb);
+    }
+
+    template <typename List>
+    static void saveList(CheckpointWriter &writer, const List &list)
+    {
+        writer.write(static_cast<uint32_t>(list.size()));
+        for (const PCB *pcb : list)
+            writer.write(pcb->schedIndex);
+    }
 
-        currentProcess->setCurrentState(PCB::RUNNING);
-        std::cout << "Current time: " << currentTime << " Process " << currentProcess->getPid() << " is RUNNING (Round Robin)." << std::endl;
+    // 读取以进程表下标保存的队列，下标越界时标记检查点损坏
+    static std::vector<PCB *> restoreList(CheckpointReader &reader, const std::vector<PCB *> &table)
+    {
+        std::vector<PCB *> list;
+        uint32_t count = reader.readCount(static_cast<uint32_t>(table.size()));
+        for (uint32_t i = 0; i < count && reader.ok(); ++i)
+        {
+            int index = reader.read<int>();
+            if (index < 0 || index >= static_cast<int>(table.size()))
+                reader.fail();
+            else
+                list.push_back(table[index]);
+        }
+        return list;
+    }
 
-        int executeTime = std::min(timeSlice, currentProcess->getTotalRunTime() - currentProcess->getUsedRunTime());
+    // 运行选中的进程，直到时间片用完、被策略抢占、阻塞或终止
+    template <typename Policy>
+    void runProcess(Policy &policy, PCB *process)
+    {
+        int slice;
+        {
+            ScopedPhaseTimer switchTimer(phaseProfile, Phase::ContextSwitch);
+            currentProcess = process;
+            currentProcess->setCurrentState(PCB::RUNNING);
+            bool switched = currentProcess->getPid() != lastRunPid;
+            lastRunPid = currentProcess->getPid();
+            stats.onDispatch(currentProcess, now(), switched);
+            log() << "Current time: " << now() << " Process " << currentProcess->getPid() << " is RUNNING (" << policy.name() << ")." << std::endl;
+            if (cacheModel && switched)
+                currentProcess->stallCycles += cacheModel->contextSwitch();
+            slice = policy.timeSliceFor(currentProcess);
+        }
+        // 协程进程上次挂起时的 CPU 区间已完成，轮到它时先恢复执行到下一个请求
+        if (currentProcess->program && currentProcess->burstRemaining == 0)
+            advanceProgram(currentProcess);
+        continueProcess(policy, slice);
+    }
 
-        for (int i = 0; i < executeTime; ++i)
+    // 当前进程最多再运行 slice 个 tick，然后按其状态交还策略；按窗口暂停时停在中途，仍为当前进程
+    template <typename Policy>
+    void continueProcess(Policy &policy, int slice)
+    {
+        bool periodic = currentProcess->isPeriodic();
+        bool preempted = false;
+        bool throttled = false;
+        for (int ran = 0; ran < slice; ++ran)
         {
-            // 执行指令或占用CPU时间
-            executeInstruction(currentProcess);
+            if (currentProcess->getCurrentState() != PCB::RUNNING || isComplete(currentProcess))
+                break;
+
+            // 执行指令或占用CPU时间；访存停顿的 tick 不推进进程
+            bool progressed = executeInstruction(currentProcess);
+            // 本 tick 计入当前 CPU 区间，区间在本 tick 阻塞时也已包含它
+            currentProcess->currentBurst++;
+            // 控制组记账；组用完配额时在本 tick 结束后让出 CPU
+            if (currentProcess->group && currentProcess->group->charge(now()))
+                throttled = true;
 
             // 仅当进程处于 RUNNING 状态时递增 usedRunTime
-            if (currentProcess->getCurrentState() == PCB::RUNNING)
+            if (progressed && currentProcess->getCurrentState() == PCB::RUNNING)
             {
                 currentProcess->updateUsedRunTime(1);
+                if (periodic)
+                    completeJobIfDone(currentProcess);
+                else if (currentProcess->program && currentProcess->burstRemaining == 0)
+                    advanceProgram(currentProcess);
             }
 
             // 检查并添加新到达的进程
             checkAndAddNewArrivedProcesses();
+            recoverWaitingProcesses();
+            flushFileSystem();
 
             // 如果进程被设置为 BLOCKED 或 TERMINATED，提前退出
-            if (currentProcess->getCurrentState() == PCB::BLOCKED ||
-                currentProcess->getCurrentState() == PCB::TERMINATED)
+            if (currentProcess->getCurrentState() != PCB::RUNNING)
+                break;
+
+            releasePeriodicJobs();
+            dispatchPendingProcesses(policy);
+            ScopedPhaseTimer tickTimer(phaseProfile, Phase::PolicyTick);
+            if (policy.onTick(currentProcess, now()))
             {
+                preempted = true;
                 break;
             }
+            if (throttled)
+                break;
+            if (pauseHolds && now() >= pauseTime && ran + 1 < slice)
+            {
+                heldSlice = slice - ran - 1;
+                return;
+            }
         }
 
+        ScopedPhaseTimer switchTimer(phaseProfile, Phase::ContextSwitch);
         // 调度结束后，根据进程状态决定下一步
-        if (currentProcess->getUsedRunTime() >= currentProcess->getTotalRunTime())
+        if (isComplete(currentProcess))
         {
+            stats.onExit(currentProcess, now());
             currentProcess->setCurrentState(PCB::TERMINATED);
-            std::cout << "Current time: " << currentTime << " Process " << currentProcess->getPid() << " has TERMINATED." << std::endl;
-            {
-                std::lock_guard<std::mutex> lock(mutexForQueues);
-                terminatedQueue.push(currentProcess);
-            }
-            displayQueues();
+            policy.onExit(currentProcess, now());
+            log() << "Current time: " << now() << " Process " << currentProcess->getPid() << " has TERMINATED." << std::endl;
+            terminatedCount++;
+            releaseProcess(currentProcess);
         }
         else if (currentProcess->getCurrentState() == PCB::BLOCKED)
         {
             // 进程已进入 BLOCKED 状态，不重新加入就绪队列
-            std::cout << "Current time: " << currentTime << " Process " << currentProcess->getPid() << " is BLOCKED." << std::endl;
+            policy.onBlock(currentProcess, now());
+            log() << "Current time: " << now() << " Process " << currentProcess->getPid() << " is BLOCKED." << std::endl;
         }
-        else
+        else if (currentProcess->getCurrentState() == PCB::RUNNING)
         {
-            // 进程时间片用完但未完成，重新加入就绪队列
             currentProcess->setCurrentState(PCB::READY);
-            std::cout << "Current time: " << currentTime << " Process " << currentProcess->getPid() << " time slice expired, requeuing." << std::endl;
+            stats.onReady(currentProcess, now());
+            ControlGroup *holder = currentProcess->group ? currentProcess->group->throttledAncestor(now()) : nullptr;
+            if (holder)
+                holdThrottled(holder, currentProcess);
+            else if (preempted)
+                log() << "Current time: " << now() << " Process " << currentProcess->getPid() << " is preempted, requeuing." << std::endl;
+            else
+                log() << "Current time: " << now() << " Process " << currentProcess->getPid() << " time slice expired, requeuing." << std::endl;
+            if (!holder)
+                policy.onEnqueue(currentProcess, now());
+        }
+
+        currentProcess = nullptr;
+    }
+
+    // 就绪进程因控制组 group 限流而挂起，不在策略中排队
+    void holdThrottled(ControlGroup *group, PCB *process)
+    {
+        if (group->held.empty())
+            throttledGroups.push_back(group);
+        group->held.push_back(process);
+        log() << "Current time: " << now() << " Process " << process->getPid() << " is THROTTLED by group " << group->path()
+              << " until " << group->unthrottleTime() << "." << std::endl;
+    }
+
+    // 新周期补充配额后，把限流已解除的组挂起的进程按挂起顺序放回策略；路径上仍有限流的组时改挂到该组
+    template <typename Policy>
+    void releaseThrottledProcesses(Policy &policy)
+    {
+        for (size_t i = 0; i < throttledGroups.size();)
+        {
+            ControlGroup *group = throttledGroups[i];
+            if (group->isThrottled(now()))
+            {
+                ++i;
+                continue;
+            }
+            throttledGroups.erase(throttledGroups.begin() + i);
+            while (PCB *process = group->held.pop_front())
             {
-                std::lock_guard<std::mutex> lock(mutexForQueues);
-                readyQueue.push(currentProcess);
+                if (process->getCurrentState() != PCB::READY)
+                    continue;
+                if (ControlGroup *holder = process->group->throttledAncestor(now()))
+                {
+                    holdThrottled(holder, process);
+                    continue;
+                }
+                log() << "Current time: " << now() << " Process " << process->getPid() << " is unthrottled, requeuing." << std::endl;
+                policy.onEnqueue(process, now());
             }
         }
+    }
+
+    // 读取终端上已到达的输入，按阻塞顺序唤醒读请求得到满足的进程。输入结束后仍在等待的进程
+    // 读不到的变量置为 0（与 std::cin 读取失败时一致），随后被唤醒
+    void recoverWaitingProcesses()
+    {
+        if (terminal == nullptr || terminal->readers.empty())
+            return;
+        ScopedPhaseTimer timer(phaseProfile, Phase::CheckArrivals);
+        terminal->poll(0);
+        std::lock_guard<std::mutex> guard(mutexForQueues);
+        while (PCB *reader = terminal->readers.front())
+        {
+            std::vector<std::string> variables = getCurrentReadVariables(reader);
+            if (terminal->available() < variables.size() && !terminal->atEof())
+                break;
+            terminal->readers.pop_front();
+            completeRead(reader, variables);
+            log() << "Current time: " << now() << " Process(" << reader->getPid() << ") is woken up by terminal input." << std::endl;
+            wakeProcess(reader);
+        }
+    }
 
-        currentProcess = nullptr;
+    // 获取进程当前指令要读入的变量名
+    std::vector<std::string> getCurrentReadVariables(PCB *process)
+    {
+        if (process->programCounter >= process->getCodeLength())
+            return {};
+        return parseReadTargets(code[process->getCodeStartIndex() + process->programCounter]);
+    }
+
+    // 从终端缓冲中依次取出记号存入进程的变量，执行完读指令
+    void completeRead(PCB *process, const std::vector<std::string> &variables)
+    {
+        for (const std::string &variable : variables)
+        {
+            int value = 0;
+            if (terminal->available() > 0)
+            {
+                std::string token = terminal->take();
+                std::istringstream(token) >> value;
+            }
+            process->context.registers[variable] = value;
+            log() << "Current time: " << now() << " Process " << process->getPid() << " reads " << variable << " = " << value << "." << std::endl;
+        }
+        process->programCounter++;
+    }
+
+    // 空闲 tick 的模拟耗时。有进程在等终端时改为在终端上等待，输入到达即结束；
+    // 除终端输入外不会再有任何事件时（没有定时器）一直等到有输入或输入结束
+    void waitWhileIdle()
+    {
+        if (terminal == nullptr || terminal->readers.empty() || terminal->atEof())
+        {
+            if (idleDelayMs > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(idleDelayMs)); // 模拟时间流逝，减少等待时间
+            return;
+        }
+        terminal->poll(idleDelayMs > 0 ? idleDelayMs : (timers.empty() ? -1 : 0));
+    }
+
+    // 默认仿真终止时刻：最晚到达时间 + 所有周期的最小公倍数（超周期）
+    int defaultRealTimeHorizon() const
+    {
+        long long hyperPeriod = 1;
+        int latestArrival = 0;
+        for (const auto &task : periodicTasks)
+        {
+            hyperPeriod = std::min<long long>(std::lcm(hyperPeriod, static_cast<long long>(task->getPeriod())), 1000000);
+            latestArrival = std::max(latestArrival, task->getArrivalTime());
+        }
+        return latestArrival + static_cast<int>(hyperPeriod);
+    }
+
+    // 按周期释放作业；上一个作业未完成即视为错过截止期并被丢弃。
+    // 释放时刻由时间轮触发（见 checkAndAddNewArrivedProcesses），这里只处理到期的任务
+    void releasePeriodicJobs()
+    {
+        if (periodicTasks.empty())
+            return;
+        ScopedPhaseTimer timer(phaseProfile, Phase::CheckArrivals);
+        if (realTimeHorizon < 0)
+            realTimeHorizon = defaultRealTimeHorizon();
+
+        if (now() >= realTimeHorizon)
+        {
+            for (auto &task : periodicTasks)
+            {
+                if (task->getCurrentState() == PCB::TERMINATED)
+                    continue;
+                if (task->jobActive && now() > task->absoluteDeadline)
+                    task->deadlineMisses++;
+                task->jobActive = false;
+                stats.onExit(task, now());
+                task->setCurrentState(PCB::TERMINATED);
+                log() << "Current time: " << now() << " Periodic task " << task->getPid() << " reached the horizon and has TERMINATED." << std::endl;
+                terminatedCount++;
+                timers.cancel(task);
+                releaseProcess(task);
+            }
+            dueReleases.clear();
+            return;
+        }
+
+        for (PCB *task : dueReleases)
+        {
+            if (task->jobActive)
+            {
+                task->deadlineMisses++;
+                log() << "Current time: " << now() << " Task " << task->getPid() << " missed deadline "
+                          << task->absoluteDeadline << ", job aborted." << std::endl;
+            }
+
+            task->absoluteDeadline = task->nextRelease + task->getRelativeDeadline();
+            task->nextRelease += task->getPeriod();
+            task->jobExecuted = 0;
+            task->jobActive = true;
+            task->jobsReleased++;
+            log() << "Current time: " << now() << " Task " << task->getPid() << " released job " << task->jobsReleased
+                      << ", deadline " << task->absoluteDeadline << "." << std::endl;
+
+            // 正在运行的任务在下一个 tick 由策略按新截止期判断是否抢占；仍在就绪集合中的任务需要通知策略更新
+            std::lock_guard<std::mutex> lock(mutexForQueues);
+            armTimer(task, ReleaseTimer, task->nextRelease);
+            if (task->getCurrentState() == PCB::BLOCKED)
+            {
+                task->setCurrentState(PCB::READY);
+                stats.onReady(task, now());
+                wokenProcesses.push_back(task);
+            }
+            else if (task->getCurrentState() == PCB::READY)
+                updatedProcesses.push_back(task);
+        }
+        dueReleases.clear();
+    }
+
+    // 周期作业执行满 WCET 后完成，记录延迟并阻塞到下一次释放
+    void completeJobIfDone(PCB *task)
+    {
+        task->jobExecuted++;
+        if (!task->jobActive || task->jobExecuted < task->getWcet())
+            return;
+
+        int lateness = now() - task->absoluteDeadline;
+        task->jobActive = false;
+        task->jobsCompleted++;
+        task->totalLateness += lateness;
+        task->maxLateness = std::max(task->maxLateness, lateness);
+        if (lateness > 0)
+            task->deadlineMisses++;
+        log() << "Current time: " << now() << " Task " << task->getPid() << " completed job "
+                  << task->jobsReleased << ", lateness " << lateness << "." << std::endl;
+        task->setCurrentState(PCB::BLOCKED);
+    }
+
+    // 执行读指令：前面没有进程在等、缓冲中的输入也足够时立即读入，否则阻塞在终端上，
+    // 程序计数器停在读指令上，由 recoverWaitingProcesses 在输入到达后完成读取
+    void readFromTerminal(PCB *process, const std::vector<std::string> &variables)
+    {
+        if (terminal->readers.empty() && terminal->available() < variables.size())
+            terminal->poll(0);
+        if (terminal->readers.empty() && (terminal->available() >= variables.size() || terminal->atEof()))
+        {
+            completeRead(process, variables);
+            return;
+        }
+        process->setCurrentState(PCB::BLOCKED);
+        terminal->readers.push_back(process);
+        log() << "Current time: " << now() << " Process " << process->getPid() << " waits for terminal input." << std::endl;
+    }
+
+    // 运行一个 tick 的功耗记账，返回进程在当前频率下是否推进（没有功耗模型时总是推进）
+    bool runTick(PCB *process, bool stalled)
+    {
+        if (powerModel == nullptr)
+            return true;
+        process->energy += powerModel->activeTickEnergy();
+        int frequency = powerModel->frequency();
+        bool progress = powerModel->busyTick(stalled);
+        logFrequencyChange(frequency);
+        return progress;
+    }
+
+    void idleTick()
+    {
+        if (powerModel == nullptr)
+            return;
+        bool entering = !powerModel->isIdle();
+        int frequency = powerModel->frequency();
+        powerModel->idleTick();
+        if (entering)
+            log() << "Current time: " << now() << " CPU enters " << powerModel->idleState().name << "." << std::endl;
+        logFrequencyChange(frequency);
     }
 
-    // 先来先服务调度
-    void FCFS_Schedule()
+    // 空闲后第一次运行进程前从空闲态唤醒，唤醒期间 CPU 不执行
+    void wakeFromIdle()
     {
-        // 实现保持不变
+        if (powerModel == nullptr || !powerModel->isIdle())
+            return;
+        const std::string &state = powerModel->idleState().name;
+        int latency = powerModel->wake();
+        if (latency > 0)
+            log() << "Current time: " << now() << " CPU wakes up from " << state << " in " << latency << " ticks." << std::endl;
+        for (int i = 0; i < latency; ++i)
+        {
+            int frequency = powerModel->frequency();
+            powerModel->wakeTick();
+            logFrequencyChange(frequency);
+            clock->tick(core);
+            stats.onTick(false);
+        }
     }
 
-    // 最高优先级优先调度
-    void HighestPriorityFirst_Schedule()
+    void logFrequencyChange(int before)
     {
-        // 实现保持不变
+        if (powerModel->frequency() != before)
+            log() << "Current time: " << now() << " CPU frequency changes from " << before << " to " << powerModel->frequency() << " MHz." << std::endl;
     }
 
-    void executeInstruction(PCB *process)
+    // 执行一个 tick，返回进程是否有进展（累计的访存停顿满一个 tick 或低频运行未满一个 tick 的工作时不推进）
+    bool executeInstruction(PCB *process)
     {
-        if (process->getUsedRunTime() < process->getTotalRunTime())
+        ScopedPhaseTimer timer(phaseProfile, Phase::Execute);
+        if (cacheModel && process->stallCycles >= cacheModel->getConfig().cyclesPerTick)
+        {
+            process->stallCycles -= cacheModel->getConfig().cyclesPerTick;
+            stallTicks++;
+            log() << "Current time: " << now() << " Process " << process->getPid() << " stalls on memory." << std::endl;
+            runTick(process, true);
+            if (instructionDelayMs > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(instructionDelayMs));
+            clock->tick(core);
+            stats.onTick(true);
+            return false;
+        }
+        if (process->program || process->isPeriodic() || process->getUsedRunTime() < process->getTotalRunTime())
         {
-            if (process->programCounter < process->getCodeLength())
+            if (!runTick(process, false))
             {
-                std::string instruction = code[process->getCodeStartIndex() + process->programCounter];
-                process->programCounter++;
-                std::cout << "Current time: " << currentTime << " Process " << process->getPid()
+                log() << "Current time: " << now() << " Process " << process->getPid() << " runs at " << powerModel->frequency()
+                      << " MHz, no progress this tick." << std::endl;
+                if (instructionDelayMs > 0)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(instructionDelayMs));
+                clock->tick(core);
+                stats.onTick(true);
+                return false;
+            }
+            if (cacheModel)
+                touchWorkingSet(process);
+            if (process->program)
+            {
+                process->burstRemaining--;
+                log() << "Current time: " << now() << " Process " << process->getPid()
+                      << " is computing, " << process->burstRemaining << " ticks left in burst." << std::endl;
+            }
+            else if (process->programCounter < process->getCodeLength())
+            {
+                const std::string &instruction = code[process->getCodeStartIndex() + process->programCounter];
+                log() << "Current time: " << now() << " Process " << process->getPid()
                           << " is executing instruction: " << instruction << std::endl;
-                process->programCounter++;
+                std::vector<std::string> variables = terminal ? parseReadTargets(instruction) : std::vector<std::string>();
+                if (variables.empty())
+                    process->programCounter++;
+                else
+                    readFromTerminal(process, variables);
             }
             else
             {
-                std::cout << "Current time: " << currentTime << " Process " << process->getPid()
-                          << " is waiting for terminal..." << std::endl;
+                log() << "Current time: " << now() << " Process " << process->getPid()
+                          << " has no more instructions, computing." << std::endl;
             }
             // 模拟指令执行时间消耗
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            currentTime++;
+            if (instructionDelayMs > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(instructionDelayMs));
+            clock->tick(core);
+            stats.onTick(true);
         }
         else
-            std::cout << "a question!!!" << std::endl;
+        {
+            // continueProcess 不会分派已完成的进程，走到这里说明进程状态不一致；不推进时间也不计入运行时间
+            std::cerr << "Process " << process->getPid() << " dispatched at time " << now() << " with no run time left (used "
+                      << process->getUsedRunTime() << " of " << process->getTotalRunTime() << ", pc " << process->programCounter << ")." << std::endl;
+            return false;
+        }
+        return true;
     }
 };
 
@@ -0,0 +1,587 @@
+// experiment.cpp
+// 参数扫描实验驱动：同一工作负载在多种调度策略与时间片下并行运行，汇总为一张表。
+// 每个任务都是独立的 CPU 模拟（各自的 PCB、指令内存与时钟），只共享只读映射的工作负载文件
+#include "cpu.h"
+#include "workload.h"
+#include "trace_import.h"
+#include "ThreadPool.h"
+#include <cstdlib>
+#include <cstdio>
+#include <iomanip>
+#include <fstream>
+#include <unistd.h>
+
+struct RunResult
+{
+    int policy = 0;
+    int timeSlice = 0;
+    int makespan = 0;
+    double avgTurnaround = 0;
+    long long p99Turnaround = 0;
+    double avgWaiting = 0;
+    double avgResponse = 0;
+    long long contextSwitches = 0;
+    long long swapIns = 0;
+    long long stallTicks = 0;
+    double energy = 0;
+    long long throttledTicks = 0; // 各控制组累计的限流时间之和
+    double cacheHitRatio = 0;     // 文件系统缓冲区缓存的命中率
+    long long readAheadUsed = 0;  // 预读的块中被进程用到的块数
+    int finished = 0;
+    double fairness = 0;
+    double wallMs = 0;
+    std::string traceStats; // 回放轨迹时导入器的统计
+};
+
+// 内置策略的可调参数，每次运行（含预热）都以同样的参数构造策略
+struct PolicyParams
+{
+    int cfsTargetLatency = 12; // CFS 目标调度延迟（tick）
+    int cfsMinGranularity = 2; // CFS 最小粒度（tick）
+    double burstAlpha = 0;     // 大于 0 时 SJF/SRTF 以该系数的 CPU 区间指数平均预测代替真实剩余时间
+    double burstEstimate = 5;  // 初始预测值 tau(0)
+
+    void apply(CPU &cpu) const
+    {
+        cpu.setCfsParams(cfsTargetLatency, cfsMinGranularity);
+        if (burstAlpha > 0)
+            cpu.enableBurstPrediction(burstAlpha, burstEstimate);
+    }
+};
+
+static const char *policyNames[] = {"RR", "FCFS", "HPF", "SJF", "SRTF", "EDF", "RM", "CFS", "Lottery", "Stride"};
+static const int policyCount = sizeof(policyNames) / sizeof(policyNames[0]);
+
+// 将工作负载装入 CPU 并把进程加入各自的控制组，PCB 与控制组由调用者持有
+void loadWorkload(CPU &cpu, const Workload &workload, std::vector<std::unique_ptr<PCB>> &processes,
+                  const std::vector<std::unique_ptr<ControlGroup>> &groups)
+{
+    for (const auto &spec : workload.processes())
+    {
+        processes.emplace_back(spec.createPCB());
+        if (spec.group >= 0)
+            groups[spec.group]->attach(processes.back().get());
+        if (!spec.code.empty())
+            cpu.loadProgram(processes.back().get(), spec.code);
+        cpu.addProcess(processes.back().get());
+    }
+}
+
+// -f 时代替工作负载中的进程运行：运行时间平均分到输入文件的各块之间，
+// 每算完一段就顺序读入下一块并写到输出文件的相同位置
+static Program fileWorker(std::string input, std::string output, int runTime, int words)
+{
+    int in = co_await openFile(input.c_str());
+    int out = co_await openFile(output.c_str(), true);
+    int blocks = (words + FileSystem::BLOCK_WORDS - 1) / FileSystem::BLOCK_WORDS;
+    for (int i = 0; i < blocks; ++i)
+    {
+        int burst = runTime * (i + 1) / blocks - runTime * i / blocks;
+        if (burst > 0)
+            co_await computeFor(burst);
+        int offset = i * FileSystem::BLOCK_WORDS;
+        int count = co_await readFile(in, offset, 0, FileSystem::BLOCK_WORDS);
+        if (count > 0)
+            co_await writeFile(out, offset, 0, count);
+    }
+}
+
+// 为每个进程准备 words 个字的输入文件，设备按全部输入与输出文件（含间接块）的大小分配
+static FileSystem::Options fileSystemOptions(const Workload &workload, int words)
+{
+    int dataBlocks = (words + FileSystem::BLOCK_WORDS - 1) / FileSystem::BLOCK_WORDS;
+    long long perFile = dataBlocks + dataBlocks / FileSystem::POINTERS_PER_BLOCK + 2;
+    FileSystem::Options options;
+    options.blocks = static_cast<int>(std::min<long long>(2 * perFile * workload.processes().size() + 1, 1 << 30));
+    options.inodes = static_cast<int>(2 * workload.processes().size());
+    return options;
+}
+
+// 运行一次独立的模拟；checkpoint 非空时从该检查点恢复后继续，trace 非空时流式回放该调度轨迹，否则从头装入工作负载。
+// memoryLimit 大于 0 时启用准入控制，并为本次运行创建一个能容纳全部进程的交换设备；
+// cacheModel 为真时按默认配置模拟缓存，访存停顿计入运行时间；governor 非空时按默认功耗模型与该调频器统计能量；
+// fileWords 大于 0 时为本次运行创建文件系统，进程改为逐块读写各自的 fileWords 个字的文件（见 fileWorker）；params 为内置策略的参数
+RunResult runOnce(const Workload &workload, const std::string &checkpoint, int policy, int timeSlice, long long memoryLimit, bool cacheModel,
+                  const PowerModel::Governor *governor, int fileWords, const std::string &trace, const TraceImporter::Options &traceOptions,
+                  const PolicyParams &params, size_t index)
+{
+    // 回放的进程由导入器持有，导入器、控制组与文件系统须比 CPU 后析构
+    TraceImporter importer(traceOptions);
+    std::vector<std::unique_ptr<ControlGroup>> groups = Workload::createGroups(workload.groups());
+    std::unique_ptr<FileSystem> fileSystem;
+    if (fileWords > 0)
+        fileSystem.reset(new FileSystem(fileSystemOptions(workload, fileWords)));
+    CPU cpu(timeSlice);
+    cpu.setSimulatedDelays(0, 0);
+    cpu.setVerbose(false);
+    params.apply(cpu);
+
+    // 各进程的地址空间大小：读写文件的进程至少要容纳一块，交换设备按同样的大小分配
+    std::vector<int> memoryWords;
+    for (const auto &spec : workload.processes())
+        memoryWords.push_back(fileSystem ? std::max(spec.memoryWords, FileSystem::BLOCK_WORDS) : spec.memoryWords);
+
+    SwapDevice swap;
+    if (memoryLimit > 0)
+    {
+        long long pages = 1;
+        for (int words : memoryWords)
+            pages += (words + SwapDevice::PAGE_WORDS - 1) / SwapDevice::PAGE_WORDS;
+        std::string path = "/tmp/ossim-swap-" + std::to_string(getpid()) + "-" + std::to_string(index);
+        std::string error;
+        cpu.setMemoryLimit(memoryLimit);
+        if (swap.open(path, static_cast<int>(std::min<long long>(pages, 1 << 30)), error))
+            cpu.attachSwap(&swap);
+        else
+            std::cerr << "Swap disabled: " << error << std::endl;
+    }
+    CacheHierarchy caches;
+    if (cacheModel)
+        cpu.attachCacheModel(&caches);
+    PowerModel::Config powerConfig;
+    if (governor)
+        powerConfig.governor = *governor;
+    PowerModel power(powerConfig);
+    if (governor)
+        cpu.attachPowerModel(&power);
+    if (fileSystem)
+        cpu.attachFileSystem(fileSystem.get());
+
+    RunResult result;
+    result.policy = policy;
+    result.timeSlice = timeSlice;
+
+    std::vector<std::unique_ptr<PCB>> processes;
+    if (!trace.empty())
+    {
+        std::string error;
+        if (!importer.open(trace, error))
+        {
+            std::cerr << error << "." << std::endl;
+            return result;
+        }
+    }
+    else if (fileSystem)
+    {
+        // 输入文件由宿主机直接写入设备，运行开始时都不在缓存中
+        for (size_t i = 0; i < workload.processes().size(); ++i)
+        {
+            const ProcessSpec &spec = workload.processes()[i];
+            std::string input = "in/" + std::to_string(spec.pid);
+            std::vector<int> contents(fileWords);
+            for (int word = 0; word < fileWords; ++word)
+                contents[word] = static_cast<int>(spec.pid) + word;
+            if (fileSystem->createFile(input, contents) < 0)
+            {
+                std::cerr << "File system full while creating " << input << "." << std::endl;
+                return result;
+            }
+            ProcessSpec program = spec;
+            program.memoryWords = memoryWords[i];
+            processes.emplace_back(program.createPCB());
+            if (spec.group >= 0)
+                groups[spec.group]->attach(processes.back().get());
+            cpu.addProgram(processes.back().get(), fileWorker(input, "out/" + std::to_string(spec.pid), spec.totalRunTime, fileWords));
+        }
+    }
+    else if (checkpoint.empty())
+    {
+        loadWorkload(cpu, workload, processes, groups);
+    }
+    else
+    {
+        std::istringstream in(checkpoint);
+        std::string error;
+        if (!cpu.restoreCheckpoint(in, error))
+        {
+            std::cerr << "Restore failed: " << error << std::endl;
+            return result;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!trace.empty())
+        importer.replay(cpu, policy);
+    else
+        cpu.manageTimeAndSchedule(policy);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    result.makespan = cpu.getCurrentTime();
+    result.contextSwitches = cpu.getContextSwitches();
+    result.swapIns = cpu.getSwapIns();
+    result.stallTicks = cpu.getStallTicks();
+    result.energy = cpu.getEnergy();
+    result.finished = cpu.getTerminatedCount();
+    for (const auto &group : groups)
+        result.throttledTicks += group->throttledTicks();
+    if (fileSystem)
+    {
+        const BufferCache &cache = fileSystem->bufferCache();
+        long long lookups = cache.hitCount() + cache.missCount();
+        result.cacheHitRatio = lookups ? static_cast<double>(cache.hitCount()) / lookups : 0;
+        result.readAheadUsed = cache.prefetchHitCount();
+    }
+    result.wallMs = elapsed.count();
+    if (!trace.empty())
+    {
+        std::ostringstream out;
+        importer.displayStats(out);
+        result.traceStats = out.str();
+    }
+
+    const SchedStats &stats = cpu.getStats();
+    result.avgTurnaround = stats.turnaroundTimes().mean();
+    result.p99Turnaround = stats.turnaroundTimes().percentile(99);
+    result.avgWaiting = stats.waitingTimes().mean();
+    result.avgResponse = stats.responseTimes().mean();
+    result.fairness = stats.fairness();
+    return result;
+}
+
+// 以基准策略从头运行到 time 时刻暂停，返回此刻的检查点，作为各实验分支的共同起点
+std::string warmUp(const Workload &workload, int policy, int timeSlice, int time, const PolicyParams &params)
+{
+    CPU cpu(timeSlice);
+    cpu.setSimulatedDelays(0, 0);
+    cpu.setVerbose(false);
+    params.apply(cpu);
+    std::vector<std::unique_ptr<ControlGroup>> groups = Workload::createGroups(workload.groups());
+    std::vector<std::unique_ptr<PCB>> processes;
+    loadWorkload(cpu, workload, processes, groups);
+    cpu.pauseAt(time);
+    cpu.manageTimeAndSchedule(policy);
+
+    std::ostringstream out;
+    if (!cpu.saveCheckpoint(out))
+        return std::string();
+    return out.str();
+}
+
+// 解析逗号分隔的整数列表
+std::vector<int> parseList(const char *text)
+{
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            values.push_back(std::atoi(item.c_str()));
+    return values;
+}
+
+void usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [-w workload] [-n processes] [-s seed] [-p policies] [-q slices] [-j threads]\n"
+              << "       [-c time [-b policy] [-o checkpoint]] [-r checkpoint] [-t trace [-u us]] [-m words] [-k] [-g governor] [-f words]\n"
+              << "       [-l latency[,granularity]] [-a alpha[,estimate]]\n"
+              << "  -w  workload file; without it a random workload is generated and written to a temporary file\n"
+              << "      (group lines declare control groups with shares and quota/period; see workload.h)\n"
+              << "  -p  comma-separated policy numbers (default all: 0=RR 1=FCFS 2=HPF 3=SJF 4=SRTF 5=EDF 6=RM 7=CFS 8=Lottery 9=Stride)\n"
+              << "  -q  comma-separated time slices (default 1,2,4,8)\n"
+              << "  -l  CFS target latency and minimum granularity in ticks (default 12,2)\n"
+              << "  -a  SJF/SRTF order by exponentially averaged CPU bursts with this alpha in (0,1] and initial estimate (default 5)\n"
+              << "      instead of the true remaining run time\n"
+              << "  -j  worker threads (default: hardware concurrency)\n"
+              << "  -c  warm up under policy -b (default 0) with the first slice until this time, then branch every run from there\n"
+              << "  -o  also write the warm-up checkpoint to this file\n"
+              << "  -r  branch every run from a saved checkpoint instead of a workload\n"
+              << "  -t  replay a perf sched / ftrace text dump (sched_switch, sched_wakeup) instead of a workload, streamed per run\n"
+              << "  -u  trace microseconds per tick (default 1000)\n"
+              << "  -m  memory limit in words: hold arrivals that do not fit and swap processes out (see mem= in workload files)\n"
+              << "  -k  model L1/L2/LLC caches: memory stalls and cache pollution by context switches cost CPU time\n"
+              << "  -g  model DVFS and idle states under a governor (performance, powersave, ondemand, schedutil) and report energy\n"
+              << "  -f  attach a file system: every process reads its own input file of this many words one block per CPU burst,\n"
+              << "      writes it to an output file, and waits for the disk on buffer cache misses; reports the cache hit ratio" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string workloadPath;
+    int count = 2000;
+    unsigned long long seed = 1;
+    std::vector<int> policies;
+    std::vector<int> slices = {1, 2, 4, 8};
+    size_t threads = std::thread::hardware_concurrency();
+    int warmUpTime = -1;
+    int basePolicy = 0;
+    std::string checkpointOut;
+    std::string checkpointIn;
+    long long memoryLimit = 0;
+    bool cacheModel = false;
+    PowerModel::Governor governor;
+    bool powerModel = false;
+    int fileWords = 0;
+    std::string trace;
+    TraceImporter::Options traceOptions;
+    PolicyParams params;
+
+    int option;
+    while ((option = getopt(argc, argv, "w:n:s:p:q:j:c:b:o:r:t:u:m:kg:f:l:a:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'w':
+            workloadPath = optarg;
+            break;
+        case 'n':
+            count = std::atoi(optarg);
+            break;
+        case 's':
+            seed = std::strtoull(optarg, nullptr, 10);
+            break;
+        case 'p':
+            policies = parseList(optarg);
+            break;
+        case 'q':
+            slices = parseList(optarg);
+            break;
+        case 'j':
+            threads = std::strtoul(optarg, nullptr, 10);
+            break;
+        case 'c':
+            warmUpTime = std::atoi(optarg);
+            break;
+        case 'b':
+            basePolicy = std::atoi(optarg);
+            break;
+        case 'o':
+            checkpointOut = optarg;
+            break;
+        case 'r':
+            checkpointIn = optarg;
+            break;
+        case 't':
+            trace = optarg;
+            break;
+        case 'u':
+            traceOptions.tickUs = std::atoi(optarg);
+            break;
+        case 'm':
+            memoryLimit = std::atoll(optarg);
+            break;
+        case 'k':
+            cacheModel = true;
+            break;
+        case 'g':
+            if (!PowerModel::parseGovernor(optarg, governor))
+            {
+                std::cerr << "Unknown governor " << optarg << "." << std::endl;
+                return 1;
+            }
+            powerModel = true;
+            break;
+        case 'f':
+            fileWords = std::atoi(optarg);
+            break;
+        case 'l':
+        {
+            std::vector<int> values = parseList(optarg);
+            if (values.empty() || values[0] <= 0 || (values.size() > 1 && values[1] <= 0))
+            {
+                std::cerr << "Invalid CFS latency " << optarg << "." << std::endl;
+                return 1;
+            }
+            params.cfsTargetLatency = values[0];
+            if (values.size() > 1)
+                params.cfsMinGranularity = values[1];
+            break;
+        }
+        case 'a':
+        {
+            char *end = nullptr;
+            params.burstAlpha = std::strtod(optarg, &end);
+            if (*end == ',')
+                params.burstEstimate = std::strtod(end + 1, &end);
+            if (*end != '\0' || params.burstAlpha <= 0 || params.burstAlpha > 1 || params.burstEstimate < 0)
+            {
+                std::cerr << "Invalid burst prediction " << optarg << "." << std::endl;
+                return 1;
+            }
+            break;
+        }
+        default:
+            usage(argv[0]);
+            return option == 'h' ? 0 : 1;
+        }
+    }
+    if (policies.empty())
+        for (int i = 0; i < policyCount; ++i)
+            policies.push_back(i);
+    if (slices.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    for (int policy : policies)
+    {
+        if (policy < 0 || policy >= policyCount)
+        {
+            std::cerr << "Unknown policy " << policy << "." << std::endl;
+            return 1;
+        }
+    }
+    if (basePolicy < 0 || basePolicy >= policyCount)
+    {
+        std::cerr << "Unknown policy " << basePolicy << "." << std::endl;
+        return 1;
+    }
+
+    // 读写文件的进程是协程，不能写入检查点
+    if (fileWords > 0 && (!trace.empty() || !checkpointIn.empty() || warmUpTime >= 0))
+    {
+        std::cerr << "A file system run cannot be combined with a trace replay or checkpoints." << std::endl;
+        return 1;
+    }
+
+    // 各分支共同的起点：读入的检查点，或预热后生成的检查点；为空表示每次都从头运行
+    std::string checkpoint;
+    Workload workload;
+    if (!trace.empty())
+    {
+        // 轨迹中的进程是协程，不能写入检查点；每次运行各自流式读取轨迹，这里只检查能否打开
+        if (!checkpointIn.empty() || warmUpTime >= 0)
+        {
+            std::cerr << "A trace replay cannot be combined with checkpoints." << std::endl;
+            return 1;
+        }
+        TraceImporter probe(traceOptions);
+        std::string error;
+        if (!probe.open(trace, error))
+        {
+            std::cerr << error << "." << std::endl;
+            return 1;
+        }
+    }
+    else if (!checkpointIn.empty())
+    {
+        std::ifstream in(checkpointIn, std::ios::binary);
+        std::ostringstream content;
+        content << in.rdbuf();
+        if (!in)
+        {
+            std::cerr << "Cannot read checkpoint " << checkpointIn << "." << std::endl;
+            return 1;
+        }
+        checkpoint = content.str();
+
+        // 先试恢复一次，损坏的检查点在启动任务前报错
+        CPU probe(slices[0]);
+        probe.setVerbose(false);
+        std::istringstream check(checkpoint);
+        std::string error;
+        if (!probe.restoreCheckpoint(check, error))
+        {
+            std::cerr << checkpointIn << ": " << error << "." << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        // 没有给出工作负载时生成一份并写入临时文件，所有任务共享同一个只读映射
+        bool temporary = workloadPath.empty();
+        if (temporary)
+        {
+            char path[] = "/tmp/ossim-workload-XXXXXX";
+            int fd = mkstemp(path);
+            if (fd < 0)
+            {
+                std::perror("mkstemp");
+                return 1;
+            }
+            close(fd);
+            workloadPath = path;
+            Workload::write(workloadPath, Workload::generate(count, seed));
+        }
+
+        std::string error;
+        bool loaded = workload.load(workloadPath, error);
+        if (temporary)
+            unlink(workloadPath.c_str());
+        if (!loaded)
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+
+        if (warmUpTime >= 0)
+        {
+            checkpoint = warmUp(workload, basePolicy, slices[0], warmUpTime, params);
+            if (checkpoint.empty())
+                return 1;
+            std::cout << "Warm-up: " << policyNames[basePolicy] << " slice " << slices[0] << " until time "
+                      << warmUpTime << ", checkpoint " << checkpoint.size() << " bytes" << std::endl;
+            if (!checkpointOut.empty())
+            {
+                std::ofstream out(checkpointOut, std::ios::binary);
+                if (!out.write(checkpoint.data(), checkpoint.size()))
+                {
+                    std::cerr << "Cannot write checkpoint " << checkpointOut << "." << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    std::vector<RunResult> results(policies.size() * slices.size());
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        for (size_t i = 0; i < policies.size(); ++i)
+            for (size_t j = 0; j < slices.size(); ++j)
+            {
+                size_t index = i * slices.size() + j;
+                int policy = policies[i];
+                int slice = slices[j];
+                pool.submit([&workload, &checkpoint, &trace, &traceOptions, &results, &params, index, policy, slice, memoryLimit, cacheModel, powerModel, governor, fileWords]()
+                            { results[index] = runOnce(workload, checkpoint, policy, slice, memoryLimit, cacheModel, powerModel ? &governor : nullptr,
+                                                       fileWords, trace, traceOptions, params, index); });
+            }
+        pool.wait();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (!trace.empty())
+        std::cout << "Trace: " << trace << ", ";
+    else if (checkpointIn.empty())
+        std::cout << "Workload: " << workload.processes().size() << " processes, ";
+    else
+        std::cout << "Checkpoint: " << checkpointIn << ", ";
+    std::cout << results.size() << " runs on "
+              << threads << " threads, " << elapsed.count() << " ms" << std::endl;
+    if (!trace.empty())
+        std::cout << results[0].traceStats;
+    std::cout << std::left << std::setw(9) << "policy" << std::right << std::setw(7) << "slice" << std::setw(10) << "makespan"
+              << std::setw(12) << "turnaround" << std::setw(10) << "p99" << std::setw(10) << "waiting" << std::setw(10) << "response"
+              << std::setw(10) << "switches" << std::setw(10) << "fairness" << std::setw(10) << "wall ms";
+    if (memoryLimit > 0)
+        std::cout << std::setw(10) << "swap-ins";
+    if (cacheModel)
+        std::cout << std::setw(10) << "stalls";
+    if (powerModel)
+        std::cout << std::setw(12) << "energy mJ" << std::setw(10) << "mJ/job";
+    if (!workload.groups().empty())
+        std::cout << std::setw(11) << "throttled";
+    if (fileWords > 0)
+        std::cout << std::setw(11) << "hit ratio" << std::setw(12) << "read-ahead";
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto &r : results)
+    {
+        std::cout << std::left << std::setw(9) << policyNames[r.policy] << std::right << std::setw(7) << r.timeSlice
+                  << std::setw(10) << r.makespan << std::setw(12) << r.avgTurnaround << std::setw(10) << r.p99Turnaround
+                  << std::setw(10) << r.avgWaiting << std::setw(10) << r.avgResponse << std::setw(10) << r.contextSwitches
+                  << std::setw(10) << r.fairness << std::setw(10) << r.wallMs;
+        if (memoryLimit > 0)
+            std::cout << std::setw(10) << r.swapIns;
+        if (cacheModel)
+            std::cout << std::setw(10) << r.stallTicks;
+        if (powerModel)
+            std::cout << std::setw(12) << r.energy << std::setw(10) << (r.finished ? r.energy / r.finished : 0);
+        if (!workload.groups().empty())
+            std::cout << std::setw(11) << r.throttledTicks;
+        if (fileWords > 0)
+            std::cout << std::setw(11) << r.cacheHitRatio << std::setw(12) << r.readAheadUsed;
+        std::cout << std::endl;
+    }
+    return 0;
+}
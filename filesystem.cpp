@@ -0,0 +1,267 @@
+// filesystem.cpp
+#include "filesystem.h"
+#include <iostream>
+
+FileSystem::FileSystem(const Options &_options)
+    : options(_options),
+      device(_options.blocks, _options.seekTicks, _options.transferTicks),
+      cache(device, _options.cacheBlocks),
+      inodes(std::max(1, _options.inodes)),
+      usedBlocks(device.size(), false)
+{
+    usedBlocks[0] = true;
+}
+
+int FileSystem::allocateInode(const std::string &name)
+{
+    for (size_t i = 0; i < inodes.size(); ++i)
+    {
+        if (!inodes[i].used)
+        {
+            inodes[i] = Inode();
+            inodes[i].used = true;
+            directory[name] = static_cast<int>(i);
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// 从上次分配的位置往后找空闲块，设备已满时返回 0
+int FileSystem::allocateBlock()
+{
+    for (int i = 0; i < device.size(); ++i)
+    {
+        int block = (nextFreeBlock + i) % device.size();
+        if (!usedBlocks[block])
+        {
+            usedBlocks[block] = true;
+            nextFreeBlock = block + 1;
+            return block;
+        }
+    }
+    return 0;
+}
+
+// 文件块号到设备块号的映射，未分配时返回 0；allocate 为真时沿途分配缺少的间接块与数据块
+int FileSystem::mapBlock(Inode &inode, int fileBlock, bool allocate, const PointerAccess &access)
+{
+    if (fileBlock < DIRECT_BLOCKS)
+    {
+        int &entry = inode.direct[fileBlock];
+        if (entry == 0 && allocate)
+            entry = allocateBlock();
+        return entry;
+    }
+    fileBlock -= DIRECT_BLOCKS;
+    if (fileBlock < POINTERS_PER_BLOCK)
+        return pointerEntry(inode.indirect, fileBlock, allocate, false, access);
+    fileBlock -= POINTERS_PER_BLOCK;
+    if (fileBlock >= POINTERS_PER_BLOCK * POINTERS_PER_BLOCK)
+        return 0;
+    int middle = pointerEntry(inode.doubleIndirect, fileBlock / POINTERS_PER_BLOCK, allocate, true, access);
+    if (middle == 0)
+        return 0;
+    return pointerEntry(middle, fileBlock % POINTERS_PER_BLOCK, allocate, false, access);
+}
+
+// 指针块 table 中第 slot 项；allocate 为真时先分配缺少的指针块，再为空项分配块（pointerTarget 表示新块也是指针块，需清零）
+int FileSystem::pointerEntry(int &table, int slot, bool allocate, bool pointerTarget, const PointerAccess &access)
+{
+    if (table == 0)
+    {
+        if (!allocate || (table = allocateBlock()) == 0)
+            return 0;
+        int *words = access(table, true, true);
+        std::fill(words, words + BLOCK_WORDS, 0);
+    }
+    int target = access(table, false, false)[slot];
+    if (target != 0 || !allocate)
+        return target;
+    if ((target = allocateBlock()) == 0)
+        return 0;
+    access(table, false, true)[slot] = target;
+    if (pointerTarget)
+    {
+        int *words = access(target, true, true);
+        std::fill(words, words + BLOCK_WORDS, 0);
+    }
+    return target;
+}
+
+// 经缓存访问指针块，等待读盘的时刻计入 readyAt
+FileSystem::PointerAccess FileSystem::cachedPointers(ProcessIo &io, long long now, long long &readyAt)
+{
+    return [this, &io, now, &readyAt](int block, bool fresh, bool modify)
+    {
+        BufferCache::Buffer *buffer = access(io, block, !fresh, now, readyAt);
+        if (fresh || modify)
+            cache.markDirty(buffer, now);
+        return buffer->data.data();
+    };
+}
+
+// 经缓存取得块；需要读入内容时计入进程的命中/未命中
+BufferCache::Buffer *FileSystem::access(ProcessIo &io, int block, bool load, long long now, long long &readyAt)
+{
+    bool hit;
+    BufferCache::Buffer *buffer = cache.get(block, load, now, hit);
+    if (load)
+        (hit ? io.hits : io.misses)++;
+    readyAt = std::max(readyAt, buffer->readyAt);
+    return buffer;
+}
+
+int FileSystem::createFile(const std::string &name, const std::vector<int> &contents)
+{
+    if (directory.count(name))
+        return -1;
+    int file = allocateInode(name);
+    if (file < 0)
+        return -1;
+    Inode &inode = inodes[file];
+    PointerAccess onDevice = [this](int block, bool, bool)
+    {
+        return device.block(block).data();
+    };
+    for (size_t position = 0; position < contents.size(); position += BLOCK_WORDS)
+    {
+        int block = mapBlock(inode, static_cast<int>(position / BLOCK_WORDS), true, onDevice);
+        if (block == 0)
+            return -1;
+        size_t words = std::min<size_t>(BLOCK_WORDS, contents.size() - position);
+        BlockDevice::Block &data = device.block(block);
+        data.fill(0);
+        std::copy(contents.begin() + position, contents.begin() + position + words, data.begin());
+        inode.size = static_cast<int>(position + words);
+    }
+    return file;
+}
+
+int FileSystem::open(const std::string &name, bool create)
+{
+    auto it = directory.find(name);
+    if (it != directory.end())
+        return it->second;
+    return create ? allocateInode(name) : -1;
+}
+
+int FileSystem::fileSize(int file) const
+{
+    return validFile(file) ? inodes[file].size : -1;
+}
+
+FileSystem::Transfer FileSystem::read(long long pid, int file, int offset, int count, AddressSpace &memory, int address, long long now)
+{
+    if (!validFile(file) || offset < 0 || count < 0)
+        return {-1, now};
+    Inode &inode = inodes[file];
+    int end = static_cast<int>(std::min<long long>(inode.size, static_cast<long long>(offset) + count));
+    if (offset >= end)
+        return {0, now};
+
+    ProcessIo &io = processIo[pid];
+    long long readyAt = now;
+    PointerAccess pointers = cachedPointers(io, now, readyAt);
+    for (int position = offset; position < end;)
+    {
+        int within = position % BLOCK_WORDS;
+        int words = std::min(BLOCK_WORDS - within, end - position);
+        int block = mapBlock(inode, position / BLOCK_WORDS, false, pointers);
+        // 文件中的空洞读出为 0，不访问设备
+        const int *data = block ? access(io, block, true, now, readyAt)->data.data() + within : nullptr;
+        for (int i = 0; i < words; ++i)
+            memory.write(address + position - offset + i, data ? data[i] : 0);
+        position += words;
+    }
+    readAhead(inode, offset, end, now);
+    io.wordsRead += end - offset;
+    io.waitTicks += readyAt - now;
+    return {end - offset, readyAt};
+}
+
+FileSystem::Transfer FileSystem::write(long long pid, int file, int offset, int count, const AddressSpace &memory, int address, long long now)
+{
+    if (!validFile(file) || offset < 0 || count < 0)
+        return {-1, now};
+    Inode &inode = inodes[file];
+    long long maxSize = static_cast<long long>(DIRECT_BLOCKS + POINTERS_PER_BLOCK + POINTERS_PER_BLOCK * POINTERS_PER_BLOCK) * BLOCK_WORDS;
+    int end = static_cast<int>(std::min<long long>(maxSize, static_cast<long long>(offset) + count));
+
+    ProcessIo &io = processIo[pid];
+    long long readyAt = now;
+    PointerAccess pointers = cachedPointers(io, now, readyAt);
+    int position = offset;
+    while (position < end)
+    {
+        int fileBlock = position / BLOCK_WORDS;
+        int within = position % BLOCK_WORDS;
+        int words = std::min(BLOCK_WORDS - within, end - position);
+        int block = mapBlock(inode, fileBlock, false, pointers);
+        bool fresh = block == 0;
+        if (fresh && (block = mapBlock(inode, fileBlock, true, pointers)) == 0)
+            break; // 设备已满
+        // 新分配的块或整块覆盖时不必先读盘，否则读出原内容再修改
+        bool whole = within == 0 && words == BLOCK_WORDS;
+        BufferCache::Buffer *buffer = access(io, block, !fresh && !whole, now, readyAt);
+        if (fresh && !whole)
+            buffer->data.fill(0);
+        for (int i = 0; i < words; ++i)
+            memory.read(address + position - offset + i, buffer->data[within + i]);
+        cache.markDirty(buffer, now);
+        position += words;
+    }
+    int written = position - offset;
+    inode.size = std::max(inode.size, position);
+    io.wordsWritten += written;
+    io.waitTicks += readyAt - now;
+    return {written > 0 || count == 0 ? written : -1, readyAt};
+}
+
+// 顺序读取（从上次读完的位置继续）时预读窗口从 4 块起倍增到 readAheadMax，随机读取时关闭预读
+void FileSystem::readAhead(Inode &inode, int offset, int end, long long now)
+{
+    if (offset == inode.readAheadNext)
+        inode.readAheadWindow = std::min(std::max(4, inode.readAheadWindow * 2), options.readAheadMax);
+    else
+        inode.readAheadWindow = 0;
+    inode.readAheadNext = end;
+    int lastBlock = (end - 1) / BLOCK_WORDS;
+
+    // 预读不阻塞进程，查找间接块也不计入进程的命中率
+    ProcessIo ignoredIo;
+    long long ignored = now;
+    PointerAccess pointers = cachedPointers(ignoredIo, now, ignored);
+    int fileBlocks = (inode.size + BLOCK_WORDS - 1) / BLOCK_WORDS;
+    for (int fileBlock = lastBlock + 1; fileBlock <= lastBlock + inode.readAheadWindow && fileBlock < fileBlocks; ++fileBlock)
+        if (int block = mapBlock(inode, fileBlock, false, pointers))
+            cache.prefetch(block, now);
+}
+
+void FileSystem::flush(long long now)
+{
+    if (now < nextFlush)
+        return;
+    nextFlush = now + options.flushInterval;
+    flushedBlocks += cache.flush(now - options.dirtyExpire, now);
+}
+
+void FileSystem::displayStats(std::ostream &out) const
+{
+    long long lookups = cache.hitCount() + cache.missCount();
+    out << "File system: " << directory.size() << " files, " << std::count(usedBlocks.begin(), usedBlocks.end(), true) - 1 << "/"
+        << device.size() - 1 << " blocks used, buffer cache " << cache.capacity() << " blocks" << std::endl;
+    out << "Buffer cache: hit ratio " << (lookups ? static_cast<double>(cache.hitCount()) / lookups : 0) << " (" << cache.hitCount()
+        << " hits, " << cache.missCount() << " misses), read-ahead " << cache.prefetchCount() << " blocks (" << cache.prefetchHitCount()
+        << " used), " << cache.evictionCount() << " evictions, " << cache.writeBackCount() << " write-backs (" << flushedBlocks
+        << " by the flusher), " << cache.dirtyCount() << " dirty" << std::endl;
+    out << "Disk: " << device.readCount() << " reads, " << device.writeCount() << " writes" << std::endl;
+    for (const auto &entry : processIo)
+    {
+        const ProcessIo &io = entry.second;
+        long long accesses = io.hits + io.misses;
+        out << "  Process " << entry.first << ": hit ratio " << (accesses ? static_cast<double>(io.hits) / accesses : 0)
+            << " (" << io.hits << "/" << accesses << "), I/O wait " << io.waitTicks << " ticks, read " << io.wordsRead
+            << " words, wrote " << io.wordsWritten << " words" << std::endl;
+    }
+}
@@ -0,0 +1,118 @@
+// filesystem.h
+#ifndef FILESYSTEM_H
+#define FILESYSTEM_H
+
+#include "buffer_cache.h"
+#include "address_space.h"
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+
+// 模拟的 i 节点文件系统，建在 BlockDevice 之上，所有块访问都经过 BufferCache。
+// 文件以字为单位读写；i 节点有 DIRECT_BLOCKS 个直接块指针、一个一级间接块和一个二级间接块，
+// 间接块与数据块一样存放在设备上并经缓存访问。i 节点表、空闲块位图和目录（单层）保存在内存中。
+// 顺序读取同一文件时按倍增的窗口预读后续的块；脏块由后台回写（flush）按过期时间写回
+class FileSystem
+{
+public:
+    static constexpr int BLOCK_WORDS = BlockDevice::BLOCK_WORDS;
+    static constexpr int DIRECT_BLOCKS = 12;
+    static constexpr int POINTERS_PER_BLOCK = BLOCK_WORDS;
+
+    struct Options
+    {
+        int blocks = 16384;     // 设备块数
+        int inodes = 1024;      // i 节点数
+        int cacheBlocks = 256;  // 缓冲区缓存的块数
+        int seekTicks = 8;      // 寻道耗时
+        int transferTicks = 1;  // 每块传输耗时
+        int readAheadMax = 32;  // 预读窗口上限（块）
+        int flushInterval = 32; // 后台回写的间隔（tick）
+        int dirtyExpire = 64;   // 脏块最多保留多久就要写回（tick）
+    };
+
+    // 一次读写的结果：传输的字数（文件句柄无效或空间不足时为 -1），以及数据就绪的时刻
+    struct Transfer
+    {
+        int words;
+        long long readyAt;
+    };
+
+    explicit FileSystem(const Options &options);
+
+    FileSystem(const FileSystem &) = delete;
+    FileSystem &operator=(const FileSystem &) = delete;
+
+    // 宿主机侧：创建文件并把内容直接写入设备（不经缓存、不计时），用于准备工作负载的输入文件。
+    // 返回文件句柄（i 节点号），文件已存在或空间不足时返回 -1
+    int createFile(const std::string &name, const std::vector<int> &contents);
+
+    // 打开文件，create 为真时文件不存在则创建；返回文件句柄，失败时返回 -1
+    int open(const std::string &name, bool create);
+
+    int fileSize(int file) const;
+
+    // 从文件 offset 处读取最多 count 个字到 memory 的 address 处，读到文件末尾为止。调用者保证地址范围有效
+    Transfer read(long long pid, int file, int offset, int count, AddressSpace &memory, int address, long long now);
+
+    // 把 memory 中 address 处的 count 个字写入文件 offset 处，必要时扩展文件
+    Transfer write(long long pid, int file, int offset, int count, const AddressSpace &memory, int address, long long now);
+
+    // 后台回写：每隔 flushInterval 个 tick 写回修改时间超过 dirtyExpire 的脏块
+    void flush(long long now);
+
+    // 缓存命中率、预读、回写与各进程的 I/O 统计
+    void displayStats(std::ostream &out) const;
+
+    const BufferCache &bufferCache() const { return cache; }
+    const BlockDevice &blockDevice() const { return device; }
+    long long flushedBlockCount() const { return flushedBlocks; }
+
+private:
+    struct Inode
+    {
+        bool used = false;
+        int size = 0; // 字
+        int direct[DIRECT_BLOCKS] = {};
+        int indirect = 0;
+        int doubleIndirect = 0;
+        int readAheadNext = 0;   // 上次读取结束的位置（字），下次从这里读即为顺序读取
+        int readAheadWindow = 0; // 当前预读窗口（块），0 表示未在顺序读取
+    };
+
+    // 各进程的 I/O 统计
+    struct ProcessIo
+    {
+        long long hits = 0;
+        long long misses = 0;
+        long long waitTicks = 0; // 因未命中阻塞的时间
+        long long wordsRead = 0;
+        long long wordsWritten = 0;
+    };
+
+    // 访问指针块（间接块）中的字：(块号, 新分配的块, 将要修改) -> 块内容
+    using PointerAccess = std::function<int *(int block, bool fresh, bool modify)>;
+
+    bool validFile(int file) const { return file >= 0 && file < static_cast<int>(inodes.size()) && inodes[file].used; }
+    int allocateInode(const std::string &name);
+    int allocateBlock();
+    int mapBlock(Inode &inode, int fileBlock, bool allocate, const PointerAccess &access);
+    int pointerEntry(int &table, int slot, bool allocate, bool pointerTarget, const PointerAccess &access);
+    PointerAccess cachedPointers(ProcessIo &io, long long now, long long &readyAt);
+    BufferCache::Buffer *access(ProcessIo &io, int block, bool load, long long now, long long &readyAt);
+    void readAhead(Inode &inode, int offset, int end, long long now);
+
+    Options options;
+    BlockDevice device;
+    BufferCache cache;
+    std::vector<Inode> inodes;
+    std::vector<bool> usedBlocks; // 块 0 保留，块号 0 表示“未分配”
+    int nextFreeBlock = 1;        // 从这里开始找空闲块，使顺序写入的文件在设备上连续
+    std::unordered_map<std::string, int> directory;
+    std::map<long long, ProcessIo> processIo; // 按进程号排序，便于显示
+    long long nextFlush = 0;
+    long long flushedBlocks = 0; // 后台回写写出的块数
+};
+
+#endif // FILESYSTEM_H
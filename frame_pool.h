@@ -0,0 +1,87 @@
+// frame_pool.h
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// 协程帧分配池：按 64 字节分级的空闲链表，块从 64KB 的大块中切出，释放后留在池中复用，
+// 稳定运行时创建/销毁协程不调用系统分配器。超过最大级别的帧直接使用 operator new。
+// 每个线程一个池（并行实验各自独立，无需加锁），帧必须在创建它的线程上销毁
+class FramePool
+{
+public:
+    static constexpr size_t GRANULE = 64;
+    static constexpr size_t CLASSES = 32; // 最大 2KB
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    static FramePool &local()
+    {
+        thread_local FramePool pool;
+        return pool;
+    }
+
+    FramePool() {}
+    ~FramePool()
+    {
+        for (char *chunk : chunks)
+            ::operator delete(chunk);
+    }
+
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    void *allocate(size_t size)
+    {
+        size_t index = classOf(size);
+        if (index >= CLASSES)
+            return ::operator new(size);
+        if (FreeBlock *block = freeLists[index])
+        {
+            freeLists[index] = block->next;
+            return block;
+        }
+        return carve((index + 1) * GRANULE);
+    }
+
+    void deallocate(void *pointer, size_t size)
+    {
+        size_t index = classOf(size);
+        if (index >= CLASSES)
+        {
+            ::operator delete(pointer);
+            return;
+        }
+        FreeBlock *block = static_cast<FreeBlock *>(pointer);
+        block->next = freeLists[index];
+        freeLists[index] = block;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    static size_t classOf(size_t size) { return size == 0 ? 0 : (size - 1) / GRANULE; }
+
+    // 从当前大块切出一块，不够时再申请一个大块（旧块剩余部分丢弃）
+    void *carve(size_t bytes)
+    {
+        if (chunks.empty() || chunkUsed + bytes > CHUNK_SIZE)
+        {
+            chunks.push_back(static_cast<char *>(::operator new(CHUNK_SIZE)));
+            chunkUsed = 0;
+        }
+        void *block = chunks.back() + chunkUsed;
+        chunkUsed += bytes;
+        return block;
+    }
+
+    FreeBlock *freeLists[CLASSES] = {};
+    std::vector<char *> chunks;
+    size_t chunkUsed = 0;
+};
+
+#endif // FRAME_POOL_H
@@ -0,0 +1,145 @@
+// intrusive_list.h
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#include <cstddef>
+#include <iterator>
+
+template <typename T, typename Hook>
+class IntrusiveList;
+
+// 嵌入在元素中的链表挂钩。一个挂钩同一时刻只能挂在一个链表上；
+// 复制元素时挂钩不随之复制，副本处于未链接状态
+template <typename T>
+struct ListHook
+{
+    ListHook() {}
+    ListHook(const ListHook &) {}
+    ListHook &operator=(const ListHook &) { return *this; }
+
+    bool isLinked() const { return owner != nullptr; }
+
+private:
+    template <typename, typename>
+    friend class IntrusiveList;
+
+    T *prev = nullptr;
+    T *next = nullptr;
+    const void *owner = nullptr; // 所在的链表
+};
+
+// 侵入式双向链表：节点就是元素自身，入队、出队、任意位置删除都是 O(1) 且不分配内存。
+// Hook 提供 static ListHook<T> &of(T *) 取得元素中的挂钩。
+// 元素的生命周期由使用者负责，元素可能先于链表销毁，因此链表析构时不访问元素；
+// 链表销毁后仍挂在其上的元素不能再入队
+template <typename T, typename Hook>
+class IntrusiveList
+{
+public:
+    IntrusiveList() {}
+
+    IntrusiveList(const IntrusiveList &) = delete;
+    IntrusiveList &operator=(const IntrusiveList &) = delete;
+
+    bool empty() const { return head == nullptr; }
+    size_t size() const { return count; }
+    T *front() const { return head; }
+    T *back() const { return tail; }
+
+    bool contains(const T *item) const { return Hook::of(const_cast<T *>(item)).owner == this; }
+
+    // 链表中 item 之后的元素；遍历时先取出下一个元素，即可安全地移走当前元素
+    T *next(const T *item) const { return Hook::of(const_cast<T *>(item)).next; }
+
+    // 把元素从它所在的链表上摘下，不需要知道是哪个链表
+    static void unlink(T *item)
+    {
+        ListHook<T> &hook = Hook::of(item);
+        if (hook.owner)
+            static_cast<IntrusiveList *>(const_cast<void *>(hook.owner))->remove(item);
+    }
+
+    // 追加到末尾；元素若已挂在另一个链表上，先从那里摘下（移动只改指针）
+    void push_back(T *item)
+    {
+        ListHook<T> &hook = Hook::of(item);
+        if (hook.owner)
+            unlink(item);
+        hook.owner = this;
+        hook.prev = tail;
+        hook.next = nullptr;
+        if (tail)
+            Hook::of(tail).next = item;
+        else
+            head = item;
+        tail = item;
+        count++;
+    }
+
+    T *pop_front()
+    {
+        T *item = head;
+        if (item)
+            remove(item);
+        return item;
+    }
+
+    // 从链表中摘下元素，元素不在本链表上时不做任何事
+    void remove(T *item)
+    {
+        ListHook<T> &hook = Hook::of(item);
+        if (hook.owner != this)
+            return;
+        if (hook.prev)
+            Hook::of(hook.prev).next = hook.next;
+        else
+            head = hook.next;
+        if (hook.next)
+            Hook::of(hook.next).prev = hook.prev;
+        else
+            tail = hook.prev;
+        hook.prev = hook.next = nullptr;
+        hook.owner = nullptr;
+        count--;
+    }
+
+    void clear()
+    {
+        while (head)
+            pop_front();
+    }
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T **;
+        using reference = T *;
+
+        explicit iterator(T *_node) : node(_node) {}
+        T *operator*() const { return node; }
+        iterator &operator++()
+        {
+            node = Hook::of(node).next;
+            return *this;
+        }
+        bool operator==(const iterator &other) const { return node == other.node; }
+        bool operator!=(const iterator &other) const { return node != other.node; }
+
+    private:
+        T *node;
+    };
+
+    // 遍历期间不能删除当前元素
+    iterator begin() const { return iterator(head); }
+    iterator end() const { return iterator(nullptr); }
+
+private:
+    T *head = nullptr;
+    T *tail = nullptr;
+    size_t count = 0;
+};
+
+#endif // INTRUSIVE_LIST_H
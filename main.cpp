@@ -1,19 +1,48 @@
 // main.cpp
-#include "all_cpu.h"
+#include "cpu.h"
+#include "timer.h"
+#include "telemetry.h"
+#include "terminal.h"
 #include "allhead.h"
-#include "all_pcb.h"
+#include "pcb.h"
+#include <cstdlib>
 
-std::vector<std::string> code;
-
-int main()
+// 用法：os_sim [调度算法编号] [时间片] [指标文件] [指标套接字] [输入脚本]，编号见 CPU::manageTimeAndSchedule；
+// 指标文件为 Prometheus 文本格式，套接字为 Unix 域套接字，每个连接返回一份当前指标（传空字符串表示不启用）；
+// 进程的 std::cin 从输入脚本读取，未给出时从标准输入读取
+int main(int argc, char *argv[])
 {
+    int selectedScheduleAlgorithm = argc > 1 ? std::atoi(argv[1]) : 0;
+    int timeSlice = argc > 2 ? std::atoi(argv[2]) : 2;
+    CPU cpu(timeSlice);
+    cpu.setSnapshotInterval(1); // 每条指令都有模拟耗时，每个 tick 发布一次快照
+
+    Terminal terminal;
+    if (argc > 5)
+    {
+        std::string error;
+        if (!terminal.openScript(argv[5], error))
+        {
+            std::cerr << "Cannot open input script " << error << std::endl;
+            return 1;
+        }
+    }
+    else
+        terminal.openStdin();
+    cpu.attachTerminal(&terminal);
+
+    TelemetryReporter::Options telemetry;
+    if (argc > 3)
+        telemetry.metricsPath = argv[3];
+    if (argc > 4)
+        telemetry.socketPath = argv[4];
+    TelemetryReporter reporter(cpu, telemetry);
+
     // 设置信号处理
     signal(SIGINT, signalHandler);
     // 创建计时线程
     pthread_t timer;
-    pthread_create(&timer, nullptr, countTime, nullptr);
-    // 模拟程序运行，等待一段时间后停止计时线程
-    // std::this_thread::sleep_for(std::chrono::seconds(10));
+    pthread_create(&timer, nullptr, countTime, &reporter);
 
     std::vector<PCB *> processes;
 
@@ -75,37 +104,35 @@ int main()
     processes.push_back(pcb4);
     processes.push_back(pcb5);
 
-    code.resize(ALL_MEMORY_SIZE, "");
-
-    auto loadInstructions = [&](const std::vector<std::string> &instructions, PCB *pcb)
-    {
-        int offset = pcb->numOfpro * 256; // 假设每个进程最多256条指令
-        for (size_t i = 0; i < instructions.size() && (offset + i) < ALL_MEMORY_SIZE; ++i)
-        {
-            code[offset + i] = instructions[i];
-        }
-        pcb->setCodeInfo(offset, instructions.size());
-    };
-
-    // 加载指令到 code 中
-    loadInstructions(instructions_p1, pcb1);
-    loadInstructions(instructions_p2, pcb2);
-    loadInstructions(instructions_p3, pcb3);
-    loadInstructions(instructions_p3, pcb4);
-    loadInstructions(instructions_p3, pcb5);
+    // 加载指令到 CPU 的指令内存中
+    cpu.loadProgram(pcb1, instructions_p1);
+    cpu.loadProgram(pcb2, instructions_p2);
+    cpu.loadProgram(pcb3, instructions_p3);
+    cpu.loadProgram(pcb4, instructions_p3);
+    cpu.loadProgram(pcb5, instructions_p3);
 
     std::sort(processes.begin(), processes.end(), [](PCB *a, PCB *b)
-              { return !(*a < *b); });
+              { return *b < *a; });
 
     for (auto &pcb : processes)
     {
         std::cout << "Process " << pcb->getPid() << " Priority: " << pcb->getPriority() << std::endl;
+        cpu.addProcess(pcb);
     }
 
+    cpu.manageTimeAndSchedule(selectedScheduleAlgorithm);
+    cpu.displayStats();
+#ifdef OSSIM_PHASE_TIMERS
+    cpu.displayPhaseProfile();
+#endif
+
     // 停止计时线程
     stopTimer = true;
     // 等待计时线程结束
     pthread_join(timer, nullptr);
-    std::cout << "Main thread ends." << "CPU Time:" << CPU::currentTime << std::endl;
+    std::cout << "Main thread ends." << "CPU Time:" << cpu.getCurrentTime() << std::endl;
+
+    for (auto &pcb : processes)
+        delete pcb;
     return 0;
 }
@@ -2,14 +2,41 @@
 #define PCB_H
 
 #include "allhead.h"
-#include <memory>
+#include "checkpoint.h"
+#include "intrusive_list.h"
+#include "timing_wheel.h"
+#include "address_space.h"
+#include <coroutine>
 #include <vector>
 #include <unordered_map>
 #include <iostream>
 
+class ControlGroup;
+
 struct Context
 {
     std::unordered_map<std::string, int> registers; // 模拟寄存器
+
+    void save(CheckpointWriter &out) const
+    {
+        out.write(static_cast<uint32_t>(registers.size()));
+        for (const auto &reg : registers)
+        {
+            out.writeString(reg.first);
+            out.write(reg.second);
+        }
+    }
+
+    void restore(CheckpointReader &in)
+    {
+        registers.clear();
+        uint32_t count = in.readCount(1 << 16);
+        for (uint32_t i = 0; i < count && in.ok(); ++i)
+        {
+            std::string name = in.readString();
+            registers[name] = in.read<int>();
+        }
+    }
 };
 
 struct StackFrame
@@ -45,6 +72,29 @@ public:
         return stack.empty();
     }
 
+    void save(CheckpointWriter &out) const
+    {
+        out.write(static_cast<uint32_t>(stack.size()));
+        for (const auto &frame : stack)
+        {
+            frame.context.save(out);
+            out.write(frame.programCounter);
+        }
+    }
+
+    void restore(CheckpointReader &in)
+    {
+        stack.clear();
+        uint32_t count = in.readCount(1 << 20);
+        for (uint32_t i = 0; i < count && in.ok(); ++i)
+        {
+            StackFrame frame;
+            frame.context.restore(in);
+            frame.programCounter = in.read<int>();
+            stack.push_back(frame);
+        }
+    }
+
 private:
     std::vector<StackFrame> stack;
 };
@@ -58,21 +108,51 @@ public:
         READY,
         RUNNING,
         BLOCKED,
-        TERMINATED
+        TERMINATED,
+        SUSPENDED_READY,  // 就绪但已被换出，换入后才能运行
+        SUSPENDED_BLOCKED // 阻塞且已被换出，被唤醒后成为 SUSPENDED_READY
     };
 
-    PCB(long long int _pid = 0, int _priority = 0, int _arrivalTime = 0, int _totalRunTime = 0, State _currentState = READY, std::shared_ptr<PCB> _parent = nullptr, int _memoryUsage = 0)
-        : pid(_pid),
+    PCB(long long int _pid = 0, int _priority = 0, int _arrivalTime = 0, int _totalRunTime = 0, State _currentState = READY, PCB *_parent = nullptr, int _memoryUsage = 0)
+        : currentState(_currentState),
+          usedTimeSlice(0),
+          remainingTimeSlice(0),
+          predictedBurst(0),
+          currentBurst(0),
+          period(0),
+          relativeDeadline(0),
+          wcet(0),
+          nextRelease(0),
+          absoluteDeadline(0),
+          jobExecuted(0),
+          jobActive(false),
+          jobsReleased(0),
+          jobsCompleted(0),
+          deadlineMisses(0),
+          totalLateness(0),
+          maxLateness(std::numeric_limits<int>::min()),
+          vruntime(0),
+          schedIndex(-1),
+          tickets(0),
+          pass(0),
+          queueStamp(0),
+          firstRunTime(-1),
+          finishTime(-1),
+          readySince(0),
+          waitingTime(0),
+          parent(_parent),
+          addressSpace(_memoryUsage),
+          programCounter(0),
+          pid(_pid),
           priority(_priority),
           arrivalTime(_arrivalTime),
           totalRunTime(_totalRunTime),
-          usedRunTime(0),
-          currentState(_currentState),
-          programCounter(0),
-          usedTimeSlice(0),
-          remainingTimeSlice(0)
+          usedRunTime(0)
     {
-        numOfpro = proNum++;
+        numOfpro = 0; // 由 CPU::addProcess 按加入顺序编号
+        // 进程树只记录指针，父子进程都由 CPU 的进程表持有；父进程终止时 CPU 把子进程交给 init
+        if (parent)
+            parent->children.push_back(this);
     }
 
     // Getters 和 Setters
@@ -82,6 +162,12 @@ public:
     State getCurrentState() const { return currentState; }
     int getUsedRunTime() const { return usedRunTime; }
     void updateUsedRunTime(int additionalTime) { usedRunTime += additionalTime; }
+    int getRemainingRunTime() const { return totalRunTime - usedRunTime; }
+
+    // CPU 区间预测：tau(n+1) = alpha * t(n) + (1 - alpha) * tau(n)
+    double getPredictedBurst() const { return predictedBurst; }
+    void setPredictedBurst(double estimate) { predictedBurst = estimate; }
+    void updatePredictedBurst(int actualBurst, double alpha) { predictedBurst = alpha * actualBurst + (1 - alpha) * predictedBurst; }
 
     int getUsedTimeSlice() const { return usedTimeSlice; }
     void updateUsedTimeSlice() { usedTimeSlice++; }
@@ -89,6 +175,42 @@ public:
     int getRemainingTimeSlice() const { return remainingTimeSlice; }
     void setRemainingTimeSlice(int newRemainingTimeSlice) { remainingTimeSlice = newRemainingTimeSlice; }
 
+    // 设置周期性实时任务参数：周期、相对截止期（0 表示等于周期）、最坏执行时间
+    void setRealTimeParams(int _period, int _relativeDeadline, int _wcet)
+    {
+        period = _period;
+        relativeDeadline = _relativeDeadline > 0 ? _relativeDeadline : _period;
+        wcet = _wcet;
+        nextRelease = arrivalTime;
+    }
+
+    bool isPeriodic() const { return period > 0; }
+    int getPeriod() const { return period; }
+    int getRelativeDeadline() const { return relativeDeadline; }
+    int getWcet() const { return wcet; }
+
+    // CFS 权重：优先级 20 对应 nice 0，优先级每高 1 级 nice 减 1，权重约增加 25%
+    int getNice() const { return std::max(-20, std::min(19, 20 - priority)); }
+    int getWeight() const
+    {
+        static const int prioToWeight[40] = {
+            /* -20 */ 88761, 71755, 56483, 46273, 36291,
+            /* -15 */ 29154, 23254, 18705, 14949, 11916,
+            /* -10 */ 9548, 7620, 6100, 4904, 3906,
+            /*  -5 */ 3121, 2501, 1991, 1586, 1277,
+            /*   0 */ 1024, 820, 655, 526, 423,
+            /*   5 */ 335, 272, 215, 172, 137,
+            /*  10 */ 110, 87, 70, 56, 45,
+            /*  15 */ 36, 29, 23, 18, 15};
+        return std::max(1, static_cast<int>(prioToWeight[getNice() + 20] * shareScale));
+    }
+
+    // 彩票/步长调度的票数，未显式设置时取优先级（至少 1 张），再按控制组份额折算
+    int getTickets() const { return std::max(1, static_cast<int>(getRawTickets() * shareScale)); }
+    // 未按份额折算的票数，与 setTickets 的单位相同
+    int getRawTickets() const { return tickets > 0 ? tickets : std::max(1, priority); }
+    void setTickets(int newTickets) { tickets = std::max(1, newTickets); }
+
     void setCodeInfo(int startIndex, int length)
     {
         codeStartIndex = startIndex;
@@ -99,6 +221,109 @@ public:
     int getCodeLength() const { return codeLength; }
 
     int getArrivalTime() const { return arrivalTime; } // 获取 arrivalTime 的 Getter
+    void setArrivalTime(int time) { arrivalTime = time; } // 交给 CPU 之前设置（集群中为作业经网络到达节点的时刻）
+
+    // 将进程的全部状态写入检查点（不含指向其它对象的指针与进程树，由 CPU 按下标重建）
+    void saveState(CheckpointWriter &out) const
+    {
+        out.write(pid);
+        out.write(priority);
+        out.write(arrivalTime);
+        out.write(totalRunTime);
+        out.write(usedRunTime);
+        out.write(numOfpro);
+        out.write(static_cast<int>(currentState));
+        context.save(out);
+        out.write(codeStartIndex);
+        out.write(codeLength);
+        out.write(usedTimeSlice);
+        out.write(remainingTimeSlice);
+        out.write(predictedBurst);
+        out.write(currentBurst);
+        out.write(period);
+        out.write(relativeDeadline);
+        out.write(wcet);
+        out.write(nextRelease);
+        out.write(absoluteDeadline);
+        out.write(jobExecuted);
+        out.write(jobActive);
+        out.write(jobsReleased);
+        out.write(jobsCompleted);
+        out.write(deadlineMisses);
+        out.write(totalLateness);
+        out.write(maxLateness);
+        out.write(vruntime);
+        out.write(schedIndex);
+        out.write(tickets);
+        out.write(pass);
+        out.write(queueStamp);
+        out.write(firstRunTime);
+        out.write(finishTime);
+        out.write(readySince);
+        out.write(waitingTime);
+        out.write(zombie);
+        out.write(waitingForChild);
+        out.write(exited);
+        out.write(exitStatus);
+        out.write(stallCycles);
+        out.write(cacheAccesses);
+        out.write(energy);
+        addressSpace.save(out);
+        stack.save(out);
+        out.write(programCounter);
+    }
+
+    // 按 saveState 的顺序恢复，读取是否成功由调用者检查 in.ok()
+    void restoreState(CheckpointReader &in)
+    {
+        pid = in.read<long long int>();
+        priority = in.read<int>();
+        arrivalTime = in.read<int>();
+        totalRunTime = in.read<int>();
+        usedRunTime = in.read<int>();
+        numOfpro = in.read<int>();
+        currentState = static_cast<State>(in.read<int>());
+        context.restore(in);
+        codeStartIndex = in.read<int>();
+        codeLength = in.read<int>();
+        usedTimeSlice = in.read<int>();
+        remainingTimeSlice = in.read<int>();
+        predictedBurst = in.read<double>();
+        currentBurst = in.read<int>();
+        period = in.read<int>();
+        relativeDeadline = in.read<int>();
+        wcet = in.read<int>();
+        nextRelease = in.read<int>();
+        absoluteDeadline = in.read<int>();
+        jobExecuted = in.read<int>();
+        jobActive = in.read<bool>();
+        jobsReleased = in.read<int>();
+        jobsCompleted = in.read<int>();
+        deadlineMisses = in.read<int>();
+        totalLateness = in.read<long long>();
+        maxLateness = in.read<int>();
+        vruntime = in.read<long long>();
+        schedIndex = in.read<int>();
+        tickets = in.read<int>();
+        pass = in.read<long long>();
+        queueStamp = in.read<long long>();
+        firstRunTime = in.read<int>();
+        finishTime = in.read<int>();
+        readySince = in.read<long long>();
+        waitingTime = in.read<long long>();
+        zombie = in.read<bool>();
+        waitingForChild = in.read<bool>();
+        exited = in.read<bool>();
+        exitStatus = in.read<int>();
+        stallCycles = in.read<long long>();
+        cacheAccesses = in.read<long long>();
+        energy = in.read<double>();
+        addressSpace.restore(in);
+        stack.restore(in);
+        programCounter = in.read<int>();
+        if (currentState < READY || currentState > SUSPENDED_BLOCKED)
+            in.fail();
+    }
 
     // 重载小于运算符用于优先级比较
     bool operator<(const PCB &other) const
@@ -142,10 +367,72 @@ public:
     State currentState;
 
     Context context;
-    int codeStartIndex;
-    int codeLength;
+    int codeStartIndex = 0;
+    int codeLength = 0;
     int usedTimeSlice;
     int remainingTimeSlice;
+    double predictedBurst; // 下一次 CPU 区间的预测长度
+    int currentBurst;      // 当前 CPU 区间已连续执行的时间（被抢占不中断区间）
+
+    // 周期性实时任务
+    int period;           // 周期，0 表示非周期进程
+    int relativeDeadline; // 相对截止期
+    int wcet;             // 最坏执行时间（每个作业的执行需求）
+    int nextRelease;      // 下一个作业的释放时刻
+    int absoluteDeadline; // 当前作业的绝对截止期
+    int jobExecuted;      // 当前作业已执行时间
+    bool jobActive;       // 当前作业是否尚未完成
+    int jobsReleased;
+    int jobsCompleted;
+    int deadlineMisses;
+    long long totalLateness; // 已完成作业的延迟之和（完成时刻 - 截止期）
+    int maxLateness;
+
+    long long vruntime; // CFS 加权虚拟运行时间
+
+    int schedIndex; // 在 CPU 进程表中的下标
+    int tickets;    // 比例份额调度的票数（0 表示由优先级决定）
+    long long pass; // 步长调度的行程值
+
+    long long queueStamp; // 最近一次入调度堆的序号，用于堆的惰性删除
+
+    int firstRunTime; // 第一次被调度的时刻，-1 表示尚未运行
+    int finishTime;   // 终止时刻，-1 表示尚未终止
+    long long readySince;  // 最近一次进入就绪态的时刻
+    long long waitingTime; // 处于就绪态的累计时间
+
+    ListHook<PCB> runLink; // 运行队列挂钩，见 ProcessList
+
+    ListHook<PCB> timerLink;    // 定时器挂钩，见 ProcessTimers
+    long long timerExpires = 0; // 定时器的到期时刻
+    int timerEvent = 0;         // 定时器到期时的动作，由 CPU 解释
+
+    std::coroutine_handle<> program; // 协程进程的程序（见 program.h），为空表示按指令内存执行
+    int burstRemaining = 0;          // 协程进程当前 CPU 区间还需的 tick 数
+
+    // 进程树，由 CPU 的 fork/wait/exit 维护
+    PCB *parent;                  // 父进程，为空表示由 init 收养，终止后直接回收
+    std::vector<PCB *> children;  // 尚未被回收的子进程，按创建顺序
+    bool zombie = false;          // 已终止、等待父进程 wait 回收
+    bool waitingForChild = false; // 阻塞在 wait 上
+    bool exited = false;          // 协程进程已结束（程序返回或调用 exit），协程帧已释放
+    int exitStatus = 0;
+
+    AddressSpace addressSpace; // 数据地址空间，fork 时写时复制共享
+
+    // 中级调度：进程的内存在 CPU 的内存限额中占用 addressSpace.size() 个字
+    bool resident = false;                      // 已准入且未被换出（换入进行中也算）
+    std::vector<std::pair<int, int>> swapSlots; // 换出时各页的（页号, 交换设备槽号）
+
+    // 所属的控制组（见 control_group.h），为空表示不受限；shareScale 为组份额折算的权重比例
+    ControlGroup *group = nullptr;
+    double shareScale = 1.0;
+
+    // 缓存模型（见 cache_model.h）：尚未折算成 tick 的访存停顿周期，与计算时已访存的次数
+    long long stallCycles = 0;
+    long long cacheAccesses = 0;
+
+    double energy = 0; // 运行时消耗的能量（mJ），见 power_model.h
 
     Stack stack;
 
@@ -158,10 +445,22 @@ private:
     int arrivalTime;
     int totalRunTime;
     int usedRunTime;
-    static int proNum;
 };
 
-// 初始化静态成员
-int PCB::proNum = 0;
+// 进程队列：以 PCB 内嵌的 runLink 链接，入队、出队与从中间移除都是 O(1) 且不分配内存。
+// CPU 的就绪/等待队列与 FIFO 类调度策略的就绪队列共用同一个挂钩，进程同一时刻只在其中一个队列中
+struct RunQueueHook
+{
+    static ListHook<PCB> &of(PCB *process) { return process->runLink; }
+};
+using ProcessList = IntrusiveList<PCB, RunQueueHook>;
+
+// 进程定时器：每个进程一个，以 PCB 内嵌的 timerLink 链入 CPU 的时间轮
+struct TimerHook
+{
+    static ListHook<PCB> &of(PCB *process) { return process->timerLink; }
+    static long long &expiresOf(PCB *process) { return process->timerExpires; }
+};
+using ProcessTimers = TimingWheel<PCB, TimerHook>;
 
 #endif
\ No newline at end of file
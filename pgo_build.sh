@@ -0,0 +1,32 @@
+#!/bin/sh
+# 构建经 PGO 训练的 Release 版模拟器：
+#   1. 以 OSSIM_PGO=GENERATE 构建插桩版本
+#   2. 用生成的代表性工作负载运行 sched_bench，采集各调度策略的剖析数据
+#   3. 在同一构建目录以 OSSIM_PGO=USE 重新构建（目标文件路径不变，剖析数据才能对应）
+# 用法：./pgo_build.sh [构建目录] [训练进程数]
+set -e
+
+SOURCE_DIR=$(cd "$(dirname "$0")" && pwd)
+BUILD_DIR=${1:-"$SOURCE_DIR/build-pgo"}
+TRAIN_PROCESSES=${2:-3000}
+PGO_DIR="$BUILD_DIR/pgo-data"
+
+rm -rf "$PGO_DIR"
+cmake -S "$SOURCE_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release -DOSSIM_PGO=GENERATE -DOSSIM_PGO_DIR="$PGO_DIR"
+cmake --build "$BUILD_DIR" --clean-first -j"$(nproc)"
+
+# 训练：多个种子和时间片，覆盖抢占与非抢占路径
+for seed in 1 2 3; do
+    for slice in 2 8; do
+        "$BUILD_DIR/sched_bench" "$TRAIN_PROCESSES" "$seed" "$slice" > /dev/null
+    done
+done
+
+# Clang 需要先把原始剖析数据合并为 .profdata
+if ls "$PGO_DIR"/*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -output="$PGO_DIR/default.profdata" "$PGO_DIR"/*.profraw
+fi
+
+cmake -S "$SOURCE_DIR" -B "$BUILD_DIR" -DOSSIM_PGO=USE
+cmake --build "$BUILD_DIR" --clean-first -j"$(nproc)"
+echo "PGO-optimized binaries: $BUILD_DIR/os_sim $BUILD_DIR/sched_bench"
@@ -0,0 +1,136 @@
+// phase_timer.h
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 调度循环中被计时的阶段
+enum class Phase
+{
+    PickNext,      // 调度策略选出下一个进程
+    PolicyTick,    // 调度策略每个 tick 的记账与抢占判断
+    ContextSwitch, // 切入/切出进程：状态变更、时间片计算、重新入队
+    CheckArrivals, // checkAndAddNewArrivedProcesses
+    Execute,       // executeInstruction（模拟指令执行）
+    Logging,       // 调度日志的格式化与输出
+    Count
+};
+
+inline const char *phaseName(Phase phase)
+{
+    static const char *names[] = {"pick-next", "policy-tick", "context-switch", "check-arrivals", "execute", "logging"};
+    return names[static_cast<int>(phase)];
+}
+
+// 读取时间戳：x86 上使用 rdtsc，其它平台退化为 steady_clock 纳秒
+inline uint64_t readTimestamp()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// 各阶段的累计时间戳计数与调用次数；报告时用同一区间的 steady_clock 换算为纳秒。
+// 计时是独占的：嵌套阶段（如执行指令时输出日志）运行期间外层阶段暂停计时，各阶段之和不超过总时间
+class PhaseProfile
+{
+public:
+    friend class ScopedPhaseTimer;
+
+    PhaseProfile() { reset(); }
+
+    void reset()
+    {
+        for (int i = 0; i < static_cast<int>(Phase::Count); ++i)
+        {
+            cycles[i] = 0;
+            calls[i] = 0;
+        }
+        active = Phase::Count;
+        startTimestamp = readTimestamp();
+        startTime = std::chrono::steady_clock::now();
+    }
+
+    // 输出各阶段的总耗时、占比和每次调用的平均耗时
+    void display(std::ostream &out, long long simulatedTicks) const
+    {
+        uint64_t totalCycles = readTimestamp() - startTimestamp;
+        double totalNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+        double nsPerCycle = totalCycles ? totalNs / totalCycles : 0;
+
+        out << "Phase breakdown (" << totalNs / 1e6 << " ms, " << simulatedTicks << " ticks):" << std::endl;
+        uint64_t accounted = 0;
+        for (int i = 0; i < static_cast<int>(Phase::Count); ++i)
+        {
+            accounted += cycles[i];
+            double ns = cycles[i] * nsPerCycle;
+            out << "  " << std::left << std::setw(15) << phaseName(static_cast<Phase>(i)) << std::right
+                << std::setw(12) << std::fixed << std::setprecision(3) << ns / 1e6 << " ms "
+                << std::setw(6) << std::setprecision(1) << (totalNs > 0 ? 100.0 * ns / totalNs : 0) << "% "
+                << std::setw(10) << calls[i] << " calls "
+                << std::setw(10) << std::setprecision(1) << (calls[i] ? ns / calls[i] : 0) << " ns/call";
+            if (simulatedTicks > 0)
+                out << std::setw(10) << ns / simulatedTicks << " ns/tick";
+            out << std::endl;
+        }
+        double otherNs = totalCycles > accounted ? (totalCycles - accounted) * nsPerCycle : 0;
+        out << "  " << std::left << std::setw(15) << "other" << std::right << std::setw(12) << std::setprecision(3) << otherNs / 1e6 << " ms "
+            << std::setw(6) << std::setprecision(1) << (totalNs > 0 ? 100.0 * otherNs / totalNs : 0) << "%" << std::endl;
+        out << std::defaultfloat << std::setprecision(6);
+    }
+
+private:
+    uint64_t cycles[static_cast<int>(Phase::Count)];
+    uint64_t calls[static_cast<int>(Phase::Count)];
+    uint64_t startTimestamp;
+    std::chrono::steady_clock::time_point startTime;
+
+    Phase active;          // 正在计时的阶段，Count 表示没有
+    uint64_t activeSince; // 当前阶段本段计时的起点
+};
+
+// 作用域计时器：构造时取时间戳，析构时累加到 PhaseProfile；
+// 未定义 OSSIM_PHASE_TIMERS 时为空操作，调度热路径上没有任何开销
+class ScopedPhaseTimer
+{
+public:
+#ifdef OSSIM_PHASE_TIMERS
+    ScopedPhaseTimer(PhaseProfile &_profile, Phase phase)
+        : profile(_profile), outer(_profile.active)
+    {
+        uint64_t now = readTimestamp();
+        if (outer != Phase::Count)
+            profile.cycles[static_cast<int>(outer)] += now - profile.activeSince;
+        profile.active = phase;
+        profile.activeSince = now;
+        profile.calls[static_cast<int>(phase)]++;
+    }
+
+    ~ScopedPhaseTimer()
+    {
+        uint64_t now = readTimestamp();
+        profile.cycles[static_cast<int>(profile.active)] += now - profile.activeSince;
+        profile.active = outer;
+        profile.activeSince = now;
+    }
+
+private:
+    PhaseProfile &profile;
+    Phase outer; // 被本计时器打断的外层阶段
+#else
+    ScopedPhaseTimer(PhaseProfile &, Phase) {}
+#endif
+    ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+    ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+};
+
+#endif // PHASE_TIMER_H
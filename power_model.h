@@ -0,0 +1,268 @@
+// power_model.h
+#ifndef POWER_MODEL_H
+#define POWER_MODEL_H
+
+#include "checkpoint.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 单个 CPU 核的功耗模型：运行时处于某个频率档（P-state），空闲时进入某个空闲态（C-state）。
+// 频率低于最高档时，每个 tick 只完成 f/fmax 个 tick 的工作（按比例累计，满 1 时进程推进一个 tick）；
+// 切换频率后 transitionTicks 个 tick 内不执行。空闲态越深功率越低，但唤醒需要 exitLatency 个 tick，
+// 按 menu 调节器的做法取预计空闲时长（最近空闲时长的指数平均）不短于 targetResidency 的最深一档。
+// 调频器每 samplingTicks 个 tick 按这段时间的利用率选择频率。能量以 mJ 计（功率 W × tick 的毫秒数）
+class PowerModel
+{
+public:
+    struct PState
+    {
+        int frequencyMHz;
+        double watts; // 运行功率
+    };
+
+    struct CState
+    {
+        std::string name;
+        double watts;        // 空闲功率
+        int exitLatency;     // 唤醒耗时（tick）
+        int targetResidency; // 值得进入的最短空闲时长（tick）
+    };
+
+    enum Governor
+    {
+        Performance, // 总是最高频率
+        Powersave,   // 总是最低频率
+        Ondemand,    // 利用率超过 upThreshold 时升到最高，否则按利用率成比例降频
+        Schedutil    // 频率 = 1.25 × fmax × 频率不变的利用率（利用率 × 当前频率 / fmax）
+    };
+
+    struct Config
+    {
+        std::vector<PState> pstates = {{800, 0.6}, {1600, 1.6}, {2400, 3.4}, {3200, 6.5}}; // 频率从低到高
+        std::vector<CState> cstates = {{"C1", 0.5, 0, 0}, {"C3", 0.2, 2, 8}, {"C6", 0.05, 8, 40}}; // 从浅到深
+        Governor governor = Schedutil;
+        int transitionTicks = 1;
+        int samplingTicks = 10;
+        double upThreshold = 0.8;
+        double tickMs = 1.0;
+    };
+
+    PowerModel() : PowerModel(Config()) {}
+    explicit PowerModel(const Config &_config)
+        : config(_config)
+    {
+        if (config.pstates.empty())
+            config.pstates.push_back({1000, 1.0});
+        if (config.cstates.empty())
+            config.cstates.push_back({"C1", 0.0, 0, 0});
+        pstateTicks.assign(config.pstates.size(), 0);
+        cstateTicks.assign(config.cstates.size(), 0);
+        config.samplingTicks = std::max(1, config.samplingTicks);
+        pstate = config.governor == Powersave ? 0 : static_cast<int>(config.pstates.size()) - 1;
+    }
+
+    // 按名称解析调频器，未知名称时返回 false
+    static bool parseGovernor(const char *name, Governor &governor)
+    {
+        static const char *names[] = {"performance", "powersave", "ondemand", "schedutil"};
+        for (int i = 0; i < 4; ++i)
+        {
+            if (std::strcmp(name, names[i]) == 0)
+            {
+                governor = static_cast<Governor>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const Config &getConfig() const { return config; }
+    int frequency() const { return config.pstates[pstate].frequencyMHz; }
+    const CState &idleState() const { return config.cstates[cstate]; }
+    bool isIdle() const { return idle; }
+
+    // 以当前频率运行一个 tick 消耗的能量
+    double activeTickEnergy() const { return config.pstates[pstate].watts * config.tickMs; }
+
+    // 运行一个 tick（stalled 表示等待访存，不执行指令），返回进程是否推进了一个 tick（stalled 时总是 false）
+    bool busyTick(bool stalled)
+    {
+        activeEnergy += activeTickEnergy();
+        pstateTicks[pstate]++;
+        windowBusy++;
+        bool progress = false;
+        if (transition > 0)
+            transition--;
+        else if (!stalled)
+        {
+            credit += static_cast<double>(frequency()) / config.pstates.back().frequencyMHz;
+            progress = credit >= 1 - 1e-9;
+            if (progress)
+                credit -= 1;
+        }
+        endTick();
+        return progress;
+    }
+
+    // 空闲一个 tick，空闲开始时按预计时长选择空闲态
+    void idleTick()
+    {
+        if (!idle)
+        {
+            idle = true;
+            idleLength = 0;
+            cstate = 0;
+            for (size_t i = 0; i < config.cstates.size(); ++i)
+                if (config.cstates[i].targetResidency <= predictedIdle)
+                    cstate = static_cast<int>(i);
+        }
+        idleEnergy += config.cstates[cstate].watts * config.tickMs;
+        cstateTicks[cstate]++;
+        idleLength++;
+        endTick();
+    }
+
+    // 结束空闲，返回唤醒需要的 tick 数（随后每个 tick 调用 wakeTick）
+    int wake()
+    {
+        if (!idle)
+            return 0;
+        idle = false;
+        predictedIdle = (predictedIdle * 3 + idleLength) / 4;
+        wakeups++;
+        wakeTicks += config.cstates[cstate].exitLatency;
+        return config.cstates[cstate].exitLatency;
+    }
+
+    // 唤醒过程中的一个 tick，按最低频率的功率计
+    void wakeTick()
+    {
+        idleEnergy += config.pstates.front().watts * config.tickMs;
+        endTick();
+    }
+
+    double activeEnergyUsed() const { return activeEnergy; }
+    double idleEnergyUsed() const { return idleEnergy; }
+    long long frequencyChanges() const { return changes; }
+    long long wakeupCount() const { return wakeups; }
+    long long wakeLatencyTicks() const { return wakeTicks; }
+    long long pstateResidency(int index) const { return pstateTicks[index]; }
+    long long cstateResidency(int index) const { return cstateTicks[index]; }
+
+    // 当前频率档与空闲态、调频器的采样窗口与累计的能量和驻留时间，恢复到同样配置的模型
+    void save(CheckpointWriter &out) const
+    {
+        out.write(pstate);
+        out.write(cstate);
+        out.write(idle);
+        out.write(credit);
+        out.write(transition);
+        out.write(windowTicks);
+        out.write(windowBusy);
+        out.write(idleLength);
+        out.write(predictedIdle);
+        out.write(activeEnergy);
+        out.write(idleEnergy);
+        out.write(changes);
+        out.write(wakeups);
+        out.write(wakeTicks);
+        for (const std::vector<long long> *ticks : {&pstateTicks, &cstateTicks})
+        {
+            out.write(static_cast<uint32_t>(ticks->size()));
+            for (long long value : *ticks)
+                out.write(value);
+        }
+    }
+
+    // 频率档或空闲态的个数与保存时不同时标记检查点损坏
+    void restore(CheckpointReader &in)
+    {
+        pstate = in.read<int>();
+        cstate = in.read<int>();
+        idle = in.read<bool>();
+        credit = in.read<double>();
+        transition = in.read<int>();
+        windowTicks = in.read<int>();
+        windowBusy = in.read<int>();
+        idleLength = in.read<long long>();
+        predictedIdle = in.read<long long>();
+        activeEnergy = in.read<double>();
+        idleEnergy = in.read<double>();
+        changes = in.read<long long>();
+        wakeups = in.read<long long>();
+        wakeTicks = in.read<long long>();
+        for (std::vector<long long> *ticks : {&pstateTicks, &cstateTicks})
+        {
+            if (in.read<uint32_t>() != ticks->size())
+            {
+                in.fail();
+                return;
+            }
+            for (long long &value : *ticks)
+                value = in.read<long long>();
+        }
+        if (pstate < 0 || pstate >= static_cast<int>(pstateTicks.size()) || cstate < 0 || cstate >= static_cast<int>(cstateTicks.size()))
+            in.fail();
+    }
+
+private:
+    // 每个采样周期结束时由调频器选择频率
+    void endTick()
+    {
+        if (++windowTicks < config.samplingTicks)
+            return;
+        double utilization = static_cast<double>(windowBusy) / windowTicks;
+        windowTicks = 0;
+        windowBusy = 0;
+
+        int top = static_cast<int>(config.pstates.size()) - 1;
+        double fmax = config.pstates[top].frequencyMHz;
+        double target = 0;
+        switch (config.governor)
+        {
+        case Performance:
+            target = fmax;
+            break;
+        case Powersave:
+            target = 0;
+            break;
+        case Ondemand:
+            target = utilization > config.upThreshold ? fmax : fmax * utilization / config.upThreshold;
+            break;
+        case Schedutil:
+            target = 1.25 * utilization * frequency(); // 1.25 × fmax × (utilization × f / fmax)
+            break;
+        }
+        int next = 0;
+        while (next < top && config.pstates[next].frequencyMHz < target)
+            next++;
+        if (next != pstate)
+        {
+            pstate = next;
+            transition = config.transitionTicks;
+            changes++;
+        }
+    }
+
+    Config config;
+    int pstate = 0;
+    int cstate = 0;
+    bool idle = false;
+    double credit = 0;           // 低频运行时累计完成的工作（tick）
+    int transition = 0;          // 调频过渡剩余的 tick
+    int windowTicks = 0;         // 当前采样周期的 tick 数
+    int windowBusy = 0;          // 其中忙的 tick 数
+    long long idleLength = 0;    // 本次空闲已持续的 tick
+    long long predictedIdle = 0; // 预计的空闲时长
+    double activeEnergy = 0;
+    double idleEnergy = 0;
+    long long changes = 0;
+    long long wakeups = 0;
+    long long wakeTicks = 0;
+    std::vector<long long> pstateTicks; // 各频率档的运行 tick 数
+    std::vector<long long> cstateTicks; // 各空闲态的空闲 tick 数
+};
+
+#endif // POWER_MODEL_H
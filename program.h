@@ -0,0 +1,390 @@
+// program.h
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include "pcb.h"
+#include "frame_pool.h"
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <utility>
+
+class Channel;
+class Program;
+
+// 模拟程序向 CPU 提出的请求，由协程挂起时写入 promise，CPU 恢复协程前处理
+struct ProgramRequest
+{
+    enum Kind
+    {
+        None,
+        Compute, // 占用 CPU ticks 个 tick
+        Io,      // 阻塞 ticks 个 tick 等待 I/O
+        Sleep,   // 阻塞 ticks 个 tick
+        Send,    // 向 channel 发送 value，不耗时
+        Receive, // 从 channel 接收，没有消息时阻塞；ticks 大于 0 时最多等待 ticks 个 tick
+        Fork,    // 创建运行 program 的子进程，子进程写时复制共享地址空间
+        Exec,    // 以 program 替换当前程序，地址空间换成 value 个字的新空间
+        Wait,    // 回收一个已终止的子进程，没有时阻塞
+        Exit,    // 以状态 value 结束进程
+        Load,     // 读取地址 address 处的字
+        Store,    // 向地址 address 写入 value
+        Open,     // 打开文件 path，value 非 0 时不存在则创建
+        FileRead, // 从文件 value 的 offset 处读取 count 个字到 address 处，缓存未命中时阻塞
+        FileWrite // 把 address 处的 count 个字写入文件 value 的 offset 处
+    };
+
+    Kind kind = None;
+    int ticks = 0;
+    Channel *channel = nullptr;
+    int value = 0;
+    int address = 0;
+    Program *program = nullptr;
+    const char *path = nullptr;
+    int offset = 0;
+    int count = 0;
+};
+
+// wait 的结果；没有子进程时 pid 为 -1
+struct ChildStatus
+{
+    long long pid;
+    int status;
+};
+
+// 以 C++20 协程编写的模拟程序。协程创建后先挂起，进程第一次被调度时开始执行；
+// 每次 co_await 计算、I/O、睡眠或通信时挂起，把请求交给 CPU，轮到该进程时再被恢复。例如：
+//   Program worker(Channel &requests)
+//   {
+//       int job = co_await receiveFrom(requests);
+//       co_await computeFor(job);
+//       co_await ioWait(3);
+//   }
+// 协程帧无法复制，因此 fork 不像 Unix 那样从调用点复制出子进程，而是由调用者给出子进程要运行的程序
+// （相当于 fork 后子进程立即进入该函数），子进程以写时复制的方式共享父进程的地址空间。
+// 协程帧从 FramePool 分配
+class Program
+{
+public:
+    struct promise_type
+    {
+        ProgramRequest request;   // 最近一次挂起时提出的请求
+        int mailbox = 0;          // 阻塞接收时由发送方直接写入的消息，或 load/wait/文件操作的结果
+        long long childPid = 0;   // fork/wait 得到的子进程号
+        bool timedOut = false;    // 限时接收因超时被唤醒
+        std::exception_ptr error; // 协程体抛出的异常，由 CPU 在恢复后重新抛出
+
+        Program get_return_object() { return Program(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+
+        static void *operator new(size_t size) { return FramePool::local().allocate(size); }
+        static void operator delete(void *pointer, size_t size) { FramePool::local().deallocate(pointer, size); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Program() {}
+    explicit Program(Handle _handle) : handle(_handle) {}
+    Program(Program &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Program &operator=(Program &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Program()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    Program(const Program &) = delete;
+    Program &operator=(const Program &) = delete;
+
+    Handle get() const { return handle; }
+
+    static Handle from(std::coroutine_handle<> erased) { return Handle::from_address(erased.address()); }
+
+private:
+    Handle handle;
+};
+
+// 进程间的消息通道。发送从不阻塞；接收时没有消息则阻塞，直到有进程发送
+class Channel
+{
+public:
+    bool hasMessage() const { return !messages.empty(); }
+
+    int take()
+    {
+        int value = messages.front();
+        messages.pop_front();
+        return value;
+    }
+
+    void put(int value) { messages.push_back(value); }
+
+    // 阻塞在本通道上等待接收的进程，按阻塞顺序
+    ProcessList receivers;
+
+private:
+    std::deque<int> messages;
+};
+
+// 只提出请求、不带返回值的等待
+struct RequestAwaiter
+{
+    ProgramRequest request;
+
+    bool await_ready() const { return request.kind == ProgramRequest::None; }
+    void await_suspend(Program::Handle handle) { handle.promise().request = request; }
+    void await_resume() {}
+};
+
+struct ReceiveAwaiter
+{
+    Channel &channel;
+    int value = 0;
+    Program::promise_type *promise = nullptr;
+
+    // 已有消息时直接取走，不挂起
+    bool await_ready()
+    {
+        if (!channel.hasMessage())
+            return false;
+        value = channel.take();
+        return true;
+    }
+
+    void await_suspend(Program::Handle handle)
+    {
+        promise = &handle.promise();
+        promise->request.kind = ProgramRequest::Receive;
+        promise->request.channel = &channel;
+    }
+
+    int await_resume() { return promise ? promise->mailbox : value; }
+};
+
+// 由 CPU 把结果写入 promise 的请求
+struct ResultAwaiter
+{
+    ProgramRequest request;
+    Program::promise_type *promise = nullptr;
+
+    bool await_ready() const { return false; }
+    void await_suspend(Program::Handle handle)
+    {
+        promise = &handle.promise();
+        promise->request = request;
+    }
+    int await_resume() const { return promise->mailbox; }
+};
+
+// 携带一个程序的请求（fork/exec），程序在挂起期间由 CPU 取走
+struct ProgramAwaiter
+{
+    ProgramRequest request;
+    Program program;
+    Program::promise_type *promise = nullptr;
+
+    bool await_ready() const { return false; }
+    void await_suspend(Program::Handle handle)
+    {
+        promise = &handle.promise();
+        promise->request = request;
+        promise->request.program = &program;
+    }
+    long long await_resume() const { return promise->childPid; }
+};
+
+struct WaitAwaiter
+{
+    Program::promise_type *promise = nullptr;
+
+    bool await_ready() const { return false; }
+    void await_suspend(Program::Handle handle)
+    {
+        promise = &handle.promise();
+        promise->request.kind = ProgramRequest::Wait;
+    }
+    ChildStatus await_resume() const { return ChildStatus{promise->childPid, promise->mailbox}; }
+};
+
+// 限时接收：超时前没有收到消息时结果为空
+struct TimedReceiveAwaiter
+{
+    Channel &channel;
+    int timeout;
+    std::optional<int> value;
+    Program::promise_type *promise = nullptr;
+
+    bool await_ready()
+    {
+        if (!channel.hasMessage())
+            return timeout <= 0;
+        value = channel.take();
+        return true;
+    }
+
+    void await_suspend(Program::Handle handle)
+    {
+        promise = &handle.promise();
+        promise->timedOut = false;
+        promise->request.kind = ProgramRequest::Receive;
+        promise->request.channel = &channel;
+        promise->request.ticks = timeout;
+    }
+
+    std::optional<int> await_resume()
+    {
+        if (promise && !promise->timedOut)
+            return promise->mailbox;
+        return value;
+    }
+};
+
+inline RequestAwaiter computeFor(int ticks)
+{
+    ProgramRequest request;
+    if (ticks > 0)
+    {
+        request.kind = ProgramRequest::Compute;
+        request.ticks = ticks;
+    }
+    return {request};
+}
+
+inline RequestAwaiter ioWait(int ticks)
+{
+    ProgramRequest request;
+    if (ticks > 0)
+    {
+        request.kind = ProgramRequest::Io;
+        request.ticks = ticks;
+    }
+    return {request};
+}
+
+inline RequestAwaiter sleepFor(int ticks)
+{
+    ProgramRequest request;
+    if (ticks > 0)
+    {
+        request.kind = ProgramRequest::Sleep;
+        request.ticks = ticks;
+    }
+    return {request};
+}
+
+inline RequestAwaiter sendTo(Channel &channel, int value)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::Send;
+    request.channel = &channel;
+    request.value = value;
+    return {request};
+}
+
+inline ReceiveAwaiter receiveFrom(Channel &channel)
+{
+    return ReceiveAwaiter{channel};
+}
+
+inline TimedReceiveAwaiter receiveFrom(Channel &channel, int timeout)
+{
+    return TimedReceiveAwaiter{channel, timeout};
+}
+
+// 返回子进程号
+inline ProgramAwaiter forkProcess(Program child)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::Fork;
+    return ProgramAwaiter{request, std::move(child)};
+}
+
+// 不返回：当前程序的协程帧被销毁，进程从 image 的开头继续运行
+inline ProgramAwaiter execProgram(Program image, int memoryWords = 0)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::Exec;
+    request.value = memoryWords;
+    return ProgramAwaiter{request, std::move(image)};
+}
+
+inline WaitAwaiter waitChild()
+{
+    return WaitAwaiter{};
+}
+
+// 不返回
+inline RequestAwaiter exitProcess(int status)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::Exit;
+    request.value = status;
+    return {request};
+}
+
+// 地址越界时进程以段错误终止
+inline ResultAwaiter loadWord(int address)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::Load;
+    request.address = address;
+    return ResultAwaiter{request};
+}
+
+inline RequestAwaiter storeWord(int address, int value)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::Store;
+    request.address = address;
+    request.value = value;
+    return {request};
+}
+
+// 返回文件句柄，文件不存在（且不创建）或没有空闲 i 节点时返回 -1。path 在请求处理完之前必须有效
+inline ResultAwaiter openFile(const char *path, bool create = false)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::Open;
+    request.path = path;
+    request.value = create;
+    return ResultAwaiter{request};
+}
+
+// 返回读到的字数（读到文件末尾时少于 count），句柄无效时返回 -1；地址越界时进程以段错误终止
+inline ResultAwaiter readFile(int file, int offset, int address, int count)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::FileRead;
+    request.value = file;
+    request.offset = offset;
+    request.address = address;
+    request.count = count;
+    return ResultAwaiter{request};
+}
+
+// 返回写入的字数，句柄无效或设备已满时返回 -1
+inline ResultAwaiter writeFile(int file, int offset, int address, int count)
+{
+    ProgramRequest request;
+    request.kind = ProgramRequest::FileWrite;
+    request.value = file;
+    request.offset = offset;
+    request.address = address;
+    request.count = count;
+    return ResultAwaiter{request};
+}
+
+#endif // PROGRAM_H
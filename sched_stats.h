@@ -0,0 +1,359 @@
+// sched_stats.h
+#ifndef SCHED_STATS_H
+#define SCHED_STATS_H
+
+#include "pcb.h"
+#include "checkpoint.h"
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+
+// 对数-线性分桶的直方图（HDR 风格）：小于 32 的值逐一计数，之后每个 2 的幂区间再等分 32 个桶，
+// 相对误差不超过 1/32。桶数固定，内存与记录的样本数无关
+class LogHistogram
+{
+public:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int BUCKETS = SUB_COUNT + (63 - SUB_BITS) * SUB_COUNT;
+
+    LogHistogram() { reset(); }
+
+    void reset()
+    {
+        std::fill(counts, counts + BUCKETS, 0);
+        total = 0;
+        sum = 0;
+        minimum = std::numeric_limits<long long>::max();
+        maximum = 0;
+    }
+
+    // 负值按 0 记录
+    void record(long long value)
+    {
+        value = std::max(0LL, value);
+        counts[bucketOf(value)]++;
+        total++;
+        sum += value;
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+    }
+
+    uint64_t count() const { return total; }
+    double mean() const { return total ? static_cast<double>(sum) / total : 0; }
+    long long min() const { return total ? minimum : 0; }
+    long long max() const { return maximum; }
+
+    // 第 p 百分位（0~100）的近似值：取所在桶的中点，并限制在 [min, max] 内
+    long long percentile(double p) const
+    {
+        if (total == 0)
+            return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+        rank = std::min<uint64_t>(std::max<uint64_t>(rank, 1), total);
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+            {
+                long long value = lowerBound(i) + (bucketWidth(i) - 1) / 2;
+                return std::min(std::max(value, minimum), maximum);
+            }
+        }
+        return maximum;
+    }
+
+    void save(CheckpointWriter &out) const
+    {
+        out.write(total);
+        out.write(sum);
+        out.write(minimum);
+        out.write(maximum);
+        // 只写非空桶：桶下标加计数
+        out.write(static_cast<uint32_t>(std::count_if(counts, counts + BUCKETS, [](uint64_t c)
+                                                      { return c != 0; })));
+        for (int i = 0; i < BUCKETS; ++i)
+        {
+            if (counts[i] == 0)
+                continue;
+            out.write(i);
+            out.write(counts[i]);
+        }
+    }
+
+    void restore(CheckpointReader &in)
+    {
+        reset();
+        total = in.read<uint64_t>();
+        sum = in.read<long long>();
+        minimum = in.read<long long>();
+        maximum = in.read<long long>();
+        uint32_t used = in.readCount(BUCKETS);
+        for (uint32_t i = 0; i < used && in.ok(); ++i)
+        {
+            int bucket = in.read<int>();
+            uint64_t value = in.read<uint64_t>();
+            if (bucket < 0 || bucket >= BUCKETS)
+                in.fail();
+            else
+                counts[bucket] = value;
+        }
+    }
+
+private:
+    static int bucketOf(long long value)
+    {
+        if (value < SUB_COUNT)
+            return static_cast<int>(value);
+        int msb = 63 - __builtin_clzll(static_cast<unsigned long long>(value));
+        int shift = msb - SUB_BITS;
+        return SUB_COUNT + shift * SUB_COUNT + static_cast<int>((value >> shift) - SUB_COUNT);
+    }
+
+    static long long lowerBound(int bucket)
+    {
+        if (bucket < 2 * SUB_COUNT)
+            return bucket;
+        int shift = (bucket - SUB_COUNT) / SUB_COUNT;
+        long long mantissa = (bucket - SUB_COUNT) % SUB_COUNT + SUB_COUNT;
+        return mantissa << shift;
+    }
+
+    static long long bucketWidth(int bucket)
+    {
+        if (bucket < 2 * SUB_COUNT)
+            return 1;
+        return 1LL << ((bucket - SUB_COUNT) / SUB_COUNT);
+    }
+
+    uint64_t counts[BUCKETS];
+    uint64_t total;
+    long long sum;
+    long long minimum;
+    long long maximum;
+};
+
+// 一个分布的摘要
+struct DistributionSummary
+{
+    uint64_t count = 0;
+    double mean = 0;
+    long long p50 = 0;
+    long long p90 = 0;
+    long long p99 = 0;
+    long long max = 0;
+
+    static DistributionSummary of(const LogHistogram &histogram)
+    {
+        DistributionSummary summary;
+        summary.count = histogram.count();
+        summary.mean = histogram.mean();
+        summary.p50 = histogram.percentile(50);
+        summary.p90 = histogram.percentile(90);
+        summary.p99 = histogram.percentile(99);
+        summary.max = histogram.max();
+        return summary;
+    }
+};
+
+// 某一时刻的统计快照，由调度线程发布，供监控线程无锁读取
+struct StatsSnapshot
+{
+    long long time = 0;
+    int processes = 0;
+    int ready = 0;
+    int terminated = 0;
+    long long contextSwitches = 0;
+    long long completed = 0;
+    long long busyTicks = 0;
+    long long idleTicks = 0;
+    double fairness = 1.0;
+    DistributionSummary waiting;
+    DistributionSummary turnaround;
+    DistributionSummary response;
+    bool finished = false;
+};
+
+// 调度统计：在每次状态转换时增量更新，汇总量与百分位草图的内存都与进程数无关。
+// 等待时间是进程处于就绪态的累计时间；周转时间与响应时间以到达时刻为起点；
+// 公平性为已完成进程服务率（运行时间 / 周转时间）的 Jain 指数
+class SchedStats
+{
+public:
+    void reset()
+    {
+        waiting.reset();
+        turnaround.reset();
+        response.reset();
+        busyTicks = 0;
+        idleTicks = 0;
+        switches = 0;
+        completed = 0;
+        readyCount = 0;
+        rateSum = 0;
+        rateSquareSum = 0;
+    }
+
+    // 进程进入就绪态
+    void onReady(PCB *process, long long now)
+    {
+        process->readySince = now;
+        readyCount++;
+    }
+
+    // 进程被分派运行；switched 表示换成了另一个进程（由 CPU 判断），时间片用完后重新分派同一进程不算切换
+    void onDispatch(PCB *process, long long now, bool switched)
+    {
+        if (switched)
+            switches++;
+        readyCount--;
+        process->waitingTime += now - process->readySince;
+        if (process->firstRunTime < 0)
+        {
+            process->firstRunTime = static_cast<int>(now);
+            if (!process->isPeriodic())
+                response.record(now - process->getArrivalTime());
+        }
+    }
+
+    // 就绪进程被迁移到别的 CPU，等待时间计到此刻为止
+    void onMigrate(PCB *process, long long now)
+    {
+        readyCount--;
+        process->waitingTime += now - process->readySince;
+    }
+
+    // 进程终止，在状态改为 TERMINATED 之前调用；周期任务只记录终止时刻，不计入周转类指标
+    void onExit(PCB *process, long long now)
+    {
+        if (process->getCurrentState() == PCB::READY || process->getCurrentState() == PCB::SUSPENDED_READY)
+            readyCount--;
+        process->finishTime = static_cast<int>(now);
+        if (process->isPeriodic())
+            return;
+        long long elapsed = now - process->getArrivalTime();
+        completed++;
+        turnaround.record(elapsed);
+        waiting.record(process->waitingTime);
+        double rate = elapsed > 0 ? static_cast<double>(process->getUsedRunTime()) / elapsed : 1.0;
+        rateSum += rate;
+        rateSquareSum += rate * rate;
+    }
+
+    void onTick(bool busy)
+    {
+        if (busy)
+            busyTicks++;
+        else
+            idleTicks++;
+    }
+
+    long long contextSwitches() const { return switches; }
+    long long completedProcesses() const { return completed; }
+    int readyProcesses() const { return readyCount; }
+    long long busyTime() const { return busyTicks; }
+    const LogHistogram &waitingTimes() const { return waiting; }
+    const LogHistogram &turnaroundTimes() const { return turnaround; }
+    const LogHistogram &responseTimes() const { return response; }
+
+    double utilization() const
+    {
+        long long ticks = busyTicks + idleTicks;
+        return ticks ? static_cast<double>(busyTicks) / ticks : 0;
+    }
+
+    // 每 1000 tick 完成的进程数
+    double throughput(long long now) const
+    {
+        return now > 0 ? 1000.0 * completed / now : 0;
+    }
+
+    double fairness() const
+    {
+        return rateSquareSum > 0 ? rateSum * rateSum / (completed * rateSquareSum) : 1.0;
+    }
+
+    // 生成快照（含百分位计算，开销与桶数成正比，不宜每个 tick 调用）
+    StatsSnapshot snapshot(long long now) const
+    {
+        StatsSnapshot result;
+        result.time = now;
+        result.ready = readyCount;
+        result.contextSwitches = switches;
+        result.completed = completed;
+        result.busyTicks = busyTicks;
+        result.idleTicks = idleTicks;
+        result.fairness = fairness();
+        result.waiting = DistributionSummary::of(waiting);
+        result.turnaround = DistributionSummary::of(turnaround);
+        result.response = DistributionSummary::of(response);
+        return result;
+    }
+
+    void display(std::ostream &out, long long now) const
+    {
+        out << "\nScheduling Statistics (time " << now << "):" << std::endl;
+        out << "  completed " << completed << ", context switches " << switches
+            << ", CPU utilization " << std::fixed << std::setprecision(1) << 100.0 * utilization() << "%"
+            << ", throughput " << std::setprecision(3) << throughput(now) << " per 1000 ticks"
+            << ", Jain fairness " << fairness() << std::endl;
+        out << "  " << std::left << std::setw(12) << "metric" << std::right << std::setw(10) << "mean"
+            << std::setw(8) << "p50" << std::setw(8) << "p90" << std::setw(8) << "p99" << std::setw(8) << "max" << std::endl;
+        displayRow(out, "waiting", waiting);
+        displayRow(out, "turnaround", turnaround);
+        displayRow(out, "response", response);
+        out << std::defaultfloat << std::setprecision(6);
+    }
+
+    void save(CheckpointWriter &out) const
+    {
+        waiting.save(out);
+        turnaround.save(out);
+        response.save(out);
+        out.write(busyTicks);
+        out.write(idleTicks);
+        out.write(switches);
+        out.write(completed);
+        out.write(rateSum);
+        out.write(rateSquareSum);
+        out.write(readyCount);
+    }
+
+    void restore(CheckpointReader &in)
+    {
+        waiting.restore(in);
+        turnaround.restore(in);
+        response.restore(in);
+        busyTicks = in.read<long long>();
+        idleTicks = in.read<long long>();
+        switches = in.read<long long>();
+        completed = in.read<long long>();
+        rateSum = in.read<double>();
+        rateSquareSum = in.read<double>();
+        readyCount = in.read<int>();
+    }
+
+private:
+    static void displayRow(std::ostream &out, const char *name, const LogHistogram &histogram)
+    {
+        out << "  " << std::left << std::setw(12) << name << std::right << std::setw(10) << std::setprecision(2) << histogram.mean()
+            << std::setw(8) << histogram.percentile(50) << std::setw(8) << histogram.percentile(90)
+            << std::setw(8) << histogram.percentile(99) << std::setw(8) << histogram.max() << std::endl;
+    }
+
+    LogHistogram waiting;
+    LogHistogram turnaround;
+    LogHistogram response;
+    long long busyTicks = 0;
+    long long idleTicks = 0;
+    long long switches = 0;
+    long long completed = 0;
+    double rateSum = 0;       // 服务率之和
+    double rateSquareSum = 0; // 服务率平方和
+    int readyCount = 0;       // 当前处于就绪态的进程数
+};
+
+#endif // SCHED_STATS_H
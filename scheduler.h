@@ -0,0 +1,529 @@
+// scheduler.h
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "pcb.h"
+#include "FenwickTree.h"
+#include <functional>
+#include <set>
+#include <random>
+#include <limits>
+#include <algorithm>
+
+// 调度策略接口。CPU 只负责推进时间与进程状态，就绪集合及其排序完全由策略管理：
+//   onEnqueue  进程进入就绪态（新到达、时间片用完或被抢占）
+//   pickNext   取出下一个运行的进程，没有就绪进程时返回 nullptr
+//   onTick     运行中的进程每执行一个 tick 后调用，返回 true 表示应当抢占
+//   onBlock    运行中的进程阻塞（等待 I/O、周期作业完成等）
+//   onWake     阻塞的进程重新就绪
+//   onExit     运行中的进程终止
+//   onUpdate   仍在就绪集合中的进程调度参数（如截止期）发生变化
+//   onSuspend  就绪进程被中级调度换出或迁移到别的 CPU，移出就绪集合；换入后以 onWake 重新加入
+//   dropRemoved 丢弃惰性删除留下的项，之后策略不再引用已移出的进程（进程迁移到别的 CPU 之前调用）
+// CPU::manageTimeAndSchedule 以模板方式接收策略：传入具体的 final 类时所有调用都被静态绑定并可内联；
+// 传入 SchedulerPolicy& 时按虚函数插件方式动态分派。
+class SchedulerPolicy
+{
+public:
+    virtual ~SchedulerPolicy() {}
+
+    virtual const char *name() const = 0;
+    virtual void onEnqueue(PCB *process, int now) = 0;
+    virtual PCB *pickNext(int now) = 0;
+
+    // 被选中的进程本次最多可连续运行的 tick 数
+    virtual int timeSliceFor(const PCB *process) const { return std::numeric_limits<int>::max(); }
+    virtual bool onTick(PCB *running, int now) { return false; }
+    virtual void onBlock(PCB *process, int now) {}
+    virtual void onWake(PCB *process, int now) { onEnqueue(process, now); }
+    virtual void onExit(PCB *process, int now) {}
+    virtual void onUpdate(PCB *process, int now) {}
+    virtual void onSuspend(PCB *process, int now) = 0;
+    virtual void dropRemoved() {}
+
+    // 原地遍历就绪集合，不复制；顺序由策略决定，仅用于显示与统计
+    using ReadyVisitor = std::function<void(PCB *)>;
+    virtual void forEachReady(const ReadyVisitor &visit) const = 0;
+};
+
+// 带惰性删除的最小堆：同一进程再次入堆会使旧项失效，出堆时跳过失效项和已不在就绪态的进程
+class StampedHeap
+{
+public:
+    void push(double key, PCB *process)
+    {
+        process->queueStamp = ++stamp;
+        heap.push_back({key, stamp, process});
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+
+    // 返回键最小的有效进程，堆中没有有效进程时返回 nullptr
+    PCB *top()
+    {
+        while (!heap.empty())
+        {
+            const Entry &entry = heap.front();
+            if (isValid(entry))
+                return entry.pcb;
+            popEntry();
+        }
+        return nullptr;
+    }
+
+    double topKey() const { return heap.front().key; }
+
+    PCB *pop()
+    {
+        PCB *process = top();
+        if (process)
+            popEntry();
+        return process;
+    }
+
+    // 使进程在堆中的项失效，出堆时跳过
+    void remove(PCB *process) { process->queueStamp = ++stamp; }
+
+    // 立即删去所有失效项，O(n)
+    void compact()
+    {
+        heap.erase(std::remove_if(heap.begin(), heap.end(), [](const Entry &entry)
+                                  { return !isValid(entry); }),
+                   heap.end());
+        std::make_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+
+    // 按堆数组顺序（非键序）原地遍历有效项
+    template <typename Visitor>
+    void forEach(Visitor &&visit) const
+    {
+        for (const Entry &entry : heap)
+            if (isValid(entry))
+                visit(entry.pcb);
+    }
+
+private:
+    // key 越小越先调度，order 保证相同 key 时先进先出
+    struct Entry
+    {
+        double key;
+        long long order;
+        PCB *pcb;
+
+        bool operator>(const Entry &other) const
+        {
+            if (key != other.key)
+                return key > other.key;
+            return order > other.order;
+        }
+    };
+
+    static bool isValid(const Entry &entry)
+    {
+        return entry.order == entry.pcb->queueStamp && entry.pcb->getCurrentState() == PCB::READY;
+    }
+
+    void popEntry()
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        heap.pop_back();
+    }
+
+    // 以 std::push_heap/pop_heap 维护的小根堆，底层数组可原地遍历
+    std::vector<Entry> heap;
+    long long stamp = 0;
+};
+
+// 轮转调度
+class RoundRobinPolicy final : public SchedulerPolicy
+{
+public:
+    explicit RoundRobinPolicy(int _timeSlice) : timeSlice(_timeSlice) {}
+
+    const char *name() const override { return "Round Robin"; }
+    void onEnqueue(PCB *process, int) override { queue.push_back(process); }
+    void onSuspend(PCB *process, int) override { queue.remove(process); }
+
+    PCB *pickNext(int) override
+    {
+        if (queue.empty())
+            return nullptr;
+        return queue.pop_front();
+    }
+
+    int timeSliceFor(const PCB *) const override { return timeSlice; }
+
+    void forEachReady(const ReadyVisitor &visit) const override
+    {
+        for (PCB *process : queue)
+            visit(process);
+    }
+
+private:
+    int timeSlice;
+    ProcessList queue;
+};
+
+// 先来先服务（非抢占）
+class FcfsPolicy final : public SchedulerPolicy
+{
+public:
+    const char *name() const override { return "FCFS"; }
+    void onEnqueue(PCB *process, int) override { queue.push_back(process); }
+    void onSuspend(PCB *process, int) override { queue.remove(process); }
+
+    PCB *pickNext(int) override
+    {
+        if (queue.empty())
+            return nullptr;
+        return queue.pop_front();
+    }
+
+    void forEachReady(const ReadyVisitor &visit) const override
+    {
+        for (PCB *process : queue)
+            visit(process);
+    }
+
+private:
+    ProcessList queue;
+};
+
+// 最高优先级优先（非抢占，优先级值越高越先调度）
+class PriorityPolicy final : public SchedulerPolicy
+{
+public:
+    const char *name() const override { return "Highest Priority First"; }
+    void onEnqueue(PCB *process, int) override { heap.push(-process->getPriority(), process); }
+    PCB *pickNext(int) override { return heap.pop(); }
+    void onSuspend(PCB *process, int) override { heap.remove(process); }
+    void dropRemoved() override { heap.compact(); }
+    void forEachReady(const ReadyVisitor &visit) const override { heap.forEach(visit); }
+
+private:
+    StampedHeap heap;
+};
+
+// 最短作业优先 / 最短剩余时间优先，按剩余运行时间或 CPU 区间预测值排序
+class ShortestJobPolicy final : public SchedulerPolicy
+{
+public:
+    explicit ShortestJobPolicy(bool _preemptive) : preemptive(_preemptive) {}
+
+    // 启用 CPU 区间指数平均预测，用于进程总运行时间未知时
+    void enableBurstPrediction(double alpha, double initialEstimate)
+    {
+        useBurstPrediction = true;
+        burstAlpha = alpha;
+        initialBurstEstimate = initialEstimate;
+    }
+
+    const char *name() const override { return preemptive ? "SRTF" : "SJF"; }
+
+    void onEnqueue(PCB *process, int) override
+    {
+        if (useBurstPrediction && process->getUsedRunTime() == 0 && process->currentBurst == 0)
+            process->setPredictedBurst(initialBurstEstimate);
+        heap.push(burstKey(process), process);
+    }
+
+    PCB *pickNext(int) override { return heap.pop(); }
+
+    // running->currentBurst 已由 CPU 计入本 tick
+    bool onTick(PCB *running, int) override
+    {
+        if (!preemptive || !heap.top())
+            return false;
+        // 新到达进程的剩余时间更短时抢占
+        return heap.topKey() < burstKey(running);
+    }
+
+    void onBlock(PCB *process, int) override { endBurst(process); }
+    void onExit(PCB *process, int) override { endBurst(process); }
+    void onSuspend(PCB *process, int) override { heap.remove(process); }
+    void dropRemoved() override { heap.compact(); }
+    void forEachReady(const ReadyVisitor &visit) const override { heap.forEach(visit); }
+
+private:
+    // 排序键：剩余运行时间，或预测区间的剩余部分
+    double burstKey(const PCB *process) const
+    {
+        if (useBurstPrediction)
+            return std::max(0.0, process->getPredictedBurst() - process->currentBurst);
+        return process->getRemainingRunTime();
+    }
+
+    // CPU 区间结束（阻塞或终止）时更新预测值，被抢占不算区间结束
+    void endBurst(PCB *process)
+    {
+        if (useBurstPrediction && process->currentBurst > 0)
+            process->updatePredictedBurst(process->currentBurst, burstAlpha);
+        process->currentBurst = 0;
+    }
+
+    bool preemptive;
+    StampedHeap heap;
+    bool useBurstPrediction = false;   // 是否使用指数平均预测代替真实剩余时间
+    double burstAlpha = 0.5;           // 指数平均系数
+    double initialBurstEstimate = 5.0; // 初始预测值 tau(0)
+};
+
+// 最早截止期优先 / 速率单调；非周期进程排在所有实时作业之后
+class RealTimePolicy final : public SchedulerPolicy
+{
+public:
+    explicit RealTimePolicy(bool _rateMonotonic) : rateMonotonic(_rateMonotonic) {}
+
+    const char *name() const override { return rateMonotonic ? "RM" : "EDF"; }
+    void onEnqueue(PCB *process, int) override { heap.push(realTimeKey(process), process); }
+    PCB *pickNext(int) override { return heap.pop(); }
+
+    // 新作业的截止期改变了排序键，重新入堆使旧项失效
+    void onUpdate(PCB *process, int now) override { onEnqueue(process, now); }
+    void onSuspend(PCB *process, int) override { heap.remove(process); }
+    void dropRemoved() override { heap.compact(); }
+
+    // 释放作业可能带来截止期更早（或周期更短）的作业
+    bool onTick(PCB *running, int) override
+    {
+        return heap.top() && heap.topKey() < realTimeKey(running);
+    }
+
+    void forEachReady(const ReadyVisitor &visit) const override { heap.forEach(visit); }
+
+private:
+    // EDF 以绝对截止期为键，RM 以周期为键
+    double realTimeKey(const PCB *process) const
+    {
+        if (!process->isPeriodic())
+            return std::numeric_limits<double>::infinity();
+        return rateMonotonic ? process->getPeriod() : process->absoluteDeadline;
+    }
+
+    bool rateMonotonic;
+    StampedHeap heap;
+};
+
+// 完全公平调度：就绪树按 (vruntime, 进程序号) 排序，std::set 即红黑树
+class CfsPolicy final : public SchedulerPolicy
+{
+public:
+    static constexpr long long CFS_TICK = 1000000;  // 1 个 tick 对应的 vruntime 单位
+    static constexpr long long NICE_0_LOAD = 1024; // nice 0 的权重
+
+    // 目标调度延迟与最小粒度，单位：tick
+    CfsPolicy(int _targetLatency = 12, int _minGranularity = 2)
+        : targetLatency(_targetLatency), minGranularity(std::max(1, _minGranularity)) {}
+
+    const char *name() const override { return "CFS"; }
+
+    // 新到达或被唤醒的进程从 min_vruntime 附近开始，避免长期睡眠后独占 CPU
+    void onEnqueue(PCB *process, int) override
+    {
+        long long floor = minVruntime - static_cast<long long>(targetLatency) * CFS_TICK / 2;
+        if (process->getUsedRunTime() == 0)
+            floor = minVruntime;
+        process->vruntime = std::max(process->vruntime, floor);
+
+        auto it = tree.insert(process).first;
+        if (tree.size() == 1 || VruntimeLess()(process, *leftmost))
+            leftmost = it;
+        totalWeight += process->getWeight();
+        arrived = true;
+    }
+
+    PCB *pickNext(int) override
+    {
+        if (tree.empty())
+            return nullptr;
+        PCB *process = *leftmost;
+        leftmost = tree.erase(leftmost);
+        totalWeight -= process->getWeight();
+        arrived = false;
+        return process;
+    }
+
+    // 时间片 = 调度周期 * 进程权重 / 总权重；进程过多时周期按最小粒度扩展
+    int timeSliceFor(const PCB *process) const override
+    {
+        long long runnable = static_cast<long long>(tree.size()) + 1;
+        long long weightSum = totalWeight + process->getWeight();
+        long long period = std::max<long long>(targetLatency, runnable * minGranularity);
+        return static_cast<int>(std::max<long long>(minGranularity, period * process->getWeight() / weightSum));
+    }
+
+    // 新到达进程的 vruntime 明显更小时抢占
+    bool onTick(PCB *running, int) override
+    {
+        running->vruntime += CFS_TICK * NICE_0_LOAD / running->getWeight();
+        updateMinVruntime(running);
+        bool wakeup = arrived;
+        arrived = false;
+        return wakeup && !tree.empty() && (*leftmost)->vruntime + CFS_TICK * minGranularity < running->vruntime;
+    }
+
+    void onBlock(PCB *, int) override { updateMinVruntime(nullptr); }
+    void onExit(PCB *, int) override { updateMinVruntime(nullptr); }
+
+    void onSuspend(PCB *process, int) override
+    {
+        auto it = tree.find(process);
+        if (it == tree.end())
+            return;
+        if (it == leftmost)
+            leftmost = tree.erase(it);
+        else
+            tree.erase(it);
+        totalWeight -= process->getWeight();
+    }
+
+    void forEachReady(const ReadyVisitor &visit) const override
+    {
+        for (PCB *process : tree)
+            visit(process);
+    }
+
+private:
+    struct VruntimeLess
+    {
+        bool operator()(const PCB *a, const PCB *b) const
+        {
+            if (a->vruntime != b->vruntime)
+                return a->vruntime < b->vruntime;
+            return a->numOfpro < b->numOfpro;
+        }
+    };
+
+    // min_vruntime 单调不减
+    void updateMinVruntime(const PCB *running)
+    {
+        long long candidate = running ? running->vruntime : std::numeric_limits<long long>::max();
+        if (!tree.empty())
+            candidate = std::min(candidate, (*leftmost)->vruntime);
+        if (candidate != std::numeric_limits<long long>::max())
+            minVruntime = std::max(minVruntime, candidate);
+    }
+
+    int targetLatency;
+    int minGranularity;
+    std::set<PCB *, VruntimeLess> tree;                // 就绪树
+    std::set<PCB *, VruntimeLess>::iterator leftmost; // 缓存的最左节点（最小 vruntime）
+    long long totalWeight = 0;                        // 就绪树中进程的权重之和
+    long long minVruntime = 0;
+    bool arrived = false; // 上个 tick 以来是否有进程进入就绪树
+};
+
+// 彩票调度：票数存放在以进程序号 numOfpro 为下标的树状数组中，抽签与删除均为 O(log n)。
+// 序号在进程属于本 CPU 期间不变；schedIndex 会在迁出进程时变动，不能作为下标
+class LotteryPolicy final : public SchedulerPolicy
+{
+public:
+    LotteryPolicy(int _timeSlice, unsigned long long seed = 20241019) : timeSlice(_timeSlice), rng(seed) {}
+
+    const char *name() const override { return "Lottery"; }
+
+    void onEnqueue(PCB *process, int) override
+    {
+        if (process->numOfpro >= tickets.size())
+        {
+            // 容量按倍数增长，逐个加入 n 个进程时重建的总代价为 O(n)
+            int capacity = std::max(process->numOfpro + 1, 2 * tickets.size());
+            tickets.resize(capacity);
+            slots.resize(capacity, nullptr);
+        }
+        slots[process->numOfpro] = process;
+        tickets.set(process->numOfpro, process->getTickets());
+    }
+
+    PCB *pickNext(int) override
+    {
+        if (tickets.sum() == 0)
+            return nullptr;
+        long long winner = std::uniform_int_distribution<long long>(0, tickets.sum() - 1)(rng);
+        PCB *process = slots[tickets.find(winner)];
+        tickets.set(process->numOfpro, 0);
+        return process;
+    }
+
+    int timeSliceFor(const PCB *) const override { return timeSlice; }
+
+    void onSuspend(PCB *process, int) override
+    {
+        if (process->numOfpro < tickets.size())
+            tickets.set(process->numOfpro, 0);
+    }
+
+    // 票数转让（如客户端阻塞等待服务端时把票借给服务端），就绪进程的中奖概率立即生效。
+    // amount 以未折算的票数计，转让后两个进程各按自己控制组的份额折算
+    void transferTickets(PCB *from, PCB *to, int amount)
+    {
+        amount = std::min(amount, from->getRawTickets() - 1);
+        if (amount <= 0)
+            return;
+        from->setTickets(from->getRawTickets() - amount);
+        to->setTickets(to->getRawTickets() + amount);
+        for (PCB *pcb : {from, to})
+        {
+            if (pcb->numOfpro < tickets.size() && tickets.get(pcb->numOfpro) > 0)
+                tickets.set(pcb->numOfpro, pcb->getTickets());
+        }
+    }
+
+    void forEachReady(const ReadyVisitor &visit) const override
+    {
+        for (int i = 0; i < tickets.size(); ++i)
+            if (tickets.get(i) > 0)
+                visit(slots[i]);
+    }
+
+private:
+    int timeSlice;
+    FenwickTree tickets;      // 就绪进程的票数
+    std::vector<PCB *> slots; // numOfpro -> 进程
+    std::mt19937_64 rng;
+};
+
+// 步长调度：选择 pass 最小的进程，每运行一个 tick 其 pass 增加 STRIDE1 / 票数
+class StridePolicy final : public SchedulerPolicy
+{
+public:
+    static constexpr long long STRIDE1 = 1 << 20;
+
+    explicit StridePolicy(int _timeSlice) : timeSlice(_timeSlice) {}
+
+    const char *name() const override { return "Stride"; }
+
+    // 新加入的进程从全局 pass 开始，不能凭借过去的空闲积累优势
+    void onEnqueue(PCB *process, int) override
+    {
+        process->pass = std::max(process->pass, globalPass);
+        heap.push(static_cast<double>(process->pass), process);
+    }
+
+    PCB *pickNext(int) override
+    {
+        PCB *process = heap.pop();
+        if (process)
+            globalPass = process->pass;
+        return process;
+    }
+
+    int timeSliceFor(const PCB *) const override { return timeSlice; }
+
+    bool onTick(PCB *running, int) override
+    {
+        running->pass += STRIDE1 / running->getTickets();
+        return false;
+    }
+
+    void onSuspend(PCB *process, int) override { heap.remove(process); }
+    void dropRemoved() override { heap.compact(); }
+
+    void forEachReady(const ReadyVisitor &visit) const override { heap.forEach(visit); }
+
+private:
+    int timeSlice;
+    StampedHeap heap;
+    long long globalPass = 0; // 最近一次被调度进程的 pass
+};
+
+#endif
@@ -0,0 +1,86 @@
+// sim_clock.h
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <algorithm>
+
+// 模拟时钟。每个核有自己的本地时钟（独占一条缓存行，只由该核的调度线程写入），
+// 读者只做原子读取，不加锁：
+//   单核模式：全局时间就是 0 号核的本地时钟
+//   多核模式：各核独立推进本地时钟，在屏障处（集群的窗口边界）取所有本地时钟的最小值发布为全局时间，
+//             全局时间单调不减，任何读者都不会看到时间倒退
+class SimClock
+{
+public:
+    explicit SimClock(int _cores = 1)
+        : cores(_cores < 1 ? 1 : _cores),
+          local(new LocalClock[cores]),
+          global(0)
+    {
+    }
+
+    int coreCount() const { return cores; }
+
+    // 全局模拟时间
+    long long now() const
+    {
+        if (cores == 1)
+            return local[0].time.load(std::memory_order_acquire);
+        return global.load(std::memory_order_acquire);
+    }
+
+    long long localNow(int core) const
+    {
+        return local[core].time.load(std::memory_order_acquire);
+    }
+
+    // 推进某个核的本地时钟，只能由该核的调度线程调用
+    void tick(int core = 0, long long delta = 1)
+    {
+        LocalClock &clock = local[core];
+        clock.time.store(clock.time.load(std::memory_order_relaxed) + delta, std::memory_order_release);
+    }
+
+    void advanceTo(int core, long long time)
+    {
+        LocalClock &clock = local[core];
+        if (time > clock.time.load(std::memory_order_relaxed))
+            clock.time.store(time, std::memory_order_release);
+    }
+
+    // 将所有时钟重置到 time，只能在没有调度线程运行时调用
+    void reset(long long time = 0)
+    {
+        for (int i = 0; i < cores; ++i)
+            local[i].time.store(time, std::memory_order_relaxed);
+        global.store(time, std::memory_order_release);
+    }
+
+    // 计算所有本地时钟的最小值并发布为全局时间（单调不减）
+    long long synchronize()
+    {
+        long long minimum = std::numeric_limits<long long>::max();
+        for (int i = 0; i < cores; ++i)
+            minimum = std::min(minimum, local[i].time.load(std::memory_order_acquire));
+        long long current = global.load(std::memory_order_relaxed);
+        while (minimum > current && !global.compare_exchange_weak(current, minimum, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        return std::max(minimum, current);
+    }
+
+private:
+    struct alignas(64) LocalClock
+    {
+        std::atomic<long long> time{0};
+    };
+
+    int cores;
+    std::unique_ptr<LocalClock[]> local;
+    alignas(64) std::atomic<long long> global;
+};
+
+#endif // SIM_CLOCK_H
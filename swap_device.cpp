@@ -0,0 +1,49 @@
+// swap_device.cpp
+#include "swap_device.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+SwapDevice::~SwapDevice()
+{
+    if (data)
+        munmap(data, bytes);
+}
+
+bool SwapDevice::open(const std::string &path, int _pages, std::string &error)
+{
+    if (data || _pages <= 0)
+    {
+        error = data ? "swap device already open" : "swap device needs at least one page";
+        return false;
+    }
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    unlink(path.c_str());
+
+    size_t size = static_cast<size_t>(_pages) * PAGE_WORDS * sizeof(int);
+    void *mapping = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        error = path + ": " + std::strerror(errno);
+        close(fd);
+        return false;
+    }
+    close(fd);
+
+    data = static_cast<int *>(mapping);
+    bytes = size;
+    pages = _pages;
+    freeSlots.reserve(pages);
+    for (int slot = pages - 1; slot >= 0; --slot)
+        freeSlots.push_back(slot);
+    return true;
+}
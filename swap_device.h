@@ -0,0 +1,52 @@
+// swap_device.h
+#ifndef SWAP_DEVICE_H
+#define SWAP_DEVICE_H
+
+#include "address_space.h"
+#include <string>
+#include <vector>
+
+// 模拟的交换设备：以 mmap 共享映射的本地文件作为后备存储，按页（AddressSpace::PAGE_WORDS 个字）分配槽位。
+// 中级调度换出进程时把它已分配的页逐页写入空闲槽，换入时读回并释放槽位
+class SwapDevice
+{
+public:
+    static constexpr int PAGE_WORDS = AddressSpace::PAGE_WORDS;
+
+    SwapDevice() {}
+    ~SwapDevice();
+
+    SwapDevice(const SwapDevice &) = delete;
+    SwapDevice &operator=(const SwapDevice &) = delete;
+
+    // 创建 pages 页的交换文件并映射；文件创建后即被删除，只在映射期间存在。
+    // 失败时返回 false 并在 error 中说明原因
+    bool open(const std::string &path, int pages, std::string &error);
+
+    bool isOpen() const { return data != nullptr; }
+
+    int capacity() const { return pages; }
+    int used() const { return pages - static_cast<int>(freeSlots.size()); }
+
+    // 分配一个槽位，设备已满时返回 -1
+    int allocate()
+    {
+        if (freeSlots.empty())
+            return -1;
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    void release(int slot) { freeSlots.push_back(slot); }
+
+    int *page(int slot) { return data + static_cast<size_t>(slot) * PAGE_WORDS; }
+
+private:
+    int *data = nullptr;
+    size_t bytes = 0;
+    int pages = 0;
+    std::vector<int> freeSlots; // 空闲槽位，后进先出以复用刚释放的页
+};
+
+#endif // SWAP_DEVICE_H
@@ -0,0 +1,216 @@
+// telemetry.cpp
+#include "telemetry.h"
+#include "cpu.h"
+#include <charconv>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// 实数按能精确还原的最短定点小数输出，不受流的默认 6 位有效数字限制
+static std::string formatReal(double value)
+{
+    char buffer[512];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed);
+    if (result.ec != std::errc())
+        return std::to_string(value);
+    return std::string(buffer, result.ptr);
+}
+
+static void writeHeader(std::ostringstream &out, const char *name, const char *type, const char *help)
+{
+    out << "# HELP " << name << ' ' << help << '\n'
+        << "# TYPE " << name << ' ' << type << '\n';
+}
+
+// 计数与整数量原样输出
+static void writeMetric(std::ostringstream &out, const char *name, const char *type, const char *help, long long value)
+{
+    writeHeader(out, name, type, help);
+    out << name << ' ' << value << '\n';
+}
+
+static void writeMetric(std::ostringstream &out, const char *name, const char *type, const char *help, double value)
+{
+    writeHeader(out, name, type, help);
+    out << name << ' ' << formatReal(value) << '\n';
+}
+
+static void writeSummary(std::ostringstream &out, const char *name, const char *help, const DistributionSummary &summary)
+{
+    writeHeader(out, name, "summary", help);
+    out << name << "{quantile=\"0.5\"} " << summary.p50 << '\n'
+        << name << "{quantile=\"0.9\"} " << summary.p90 << '\n'
+        << name << "{quantile=\"0.99\"} " << summary.p99 << '\n'
+        << name << "{quantile=\"1\"} " << summary.max << '\n'
+        << name << "_sum " << formatReal(summary.mean * summary.count) << '\n'
+        << name << "_count " << summary.count << '\n';
+}
+
+TelemetryReporter::TelemetryReporter(const CPU &_cpu, const Options &_options)
+    : cpu(_cpu), options(_options)
+{
+}
+
+TelemetryReporter::~TelemetryReporter()
+{
+    if (listenFd >= 0)
+    {
+        close(listenFd);
+        unlink(options.socketPath.c_str());
+    }
+}
+
+std::string TelemetryReporter::formatPrometheus(const StatsSnapshot &snapshot, double tickRate, double dispatchRate)
+{
+    std::ostringstream out;
+    long long ticks = snapshot.busyTicks + snapshot.idleTicks;
+    writeMetric(out, "ossim_sim_time_ticks", "gauge", "Current simulated time.", snapshot.time);
+    writeMetric(out, "ossim_processes", "gauge", "Processes known to the scheduler.", static_cast<long long>(snapshot.processes));
+    writeMetric(out, "ossim_ready_processes", "gauge", "Processes in the READY state.", static_cast<long long>(snapshot.ready));
+    writeMetric(out, "ossim_terminated_processes", "gauge", "Processes that have terminated.", static_cast<long long>(snapshot.terminated));
+    writeMetric(out, "ossim_blocked_processes", "gauge", "Processes not yet arrived or blocked.",
+                static_cast<long long>(std::max(0, snapshot.processes - snapshot.ready - snapshot.terminated)));
+    writeMetric(out, "ossim_context_switches_total", "counter", "Switches from one process to a different one.", snapshot.contextSwitches);
+    writeMetric(out, "ossim_completed_processes_total", "counter", "Non-periodic processes that terminated.", snapshot.completed);
+    writeMetric(out, "ossim_busy_ticks_total", "counter", "Ticks spent executing processes.", snapshot.busyTicks);
+    writeMetric(out, "ossim_idle_ticks_total", "counter", "Ticks the CPU was idle.", snapshot.idleTicks);
+    writeMetric(out, "ossim_cpu_utilization", "gauge", "Busy ticks divided by all ticks.", ticks ? static_cast<double>(snapshot.busyTicks) / ticks : 0);
+    writeMetric(out, "ossim_fairness_jain", "gauge", "Jain fairness index of completed processes' service rates.", snapshot.fairness);
+    writeMetric(out, "ossim_tick_rate", "gauge", "Simulated ticks per wall-clock second.", tickRate);
+    writeMetric(out, "ossim_dispatch_rate", "gauge", "Context switches per wall-clock second.", dispatchRate);
+    writeMetric(out, "ossim_finished", "gauge", "1 once every process has terminated.", snapshot.finished ? 1LL : 0LL);
+    writeSummary(out, "ossim_waiting_time_ticks", "Time completed processes spent READY.", snapshot.waiting);
+    writeSummary(out, "ossim_turnaround_time_ticks", "Arrival to termination of completed processes.", snapshot.turnaround);
+    writeSummary(out, "ossim_response_time_ticks", "Arrival to first dispatch.", snapshot.response);
+    return out.str();
+}
+
+bool TelemetryReporter::openSocket()
+{
+    sockaddr_un address{};
+    if (options.socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Telemetry socket path too long: " << options.socketPath << std::endl;
+        return false;
+    }
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+    {
+        std::perror("socket");
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, options.socketPath.c_str());
+    unlink(options.socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listenFd, 16) < 0)
+    {
+        std::perror("telemetry socket");
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    return true;
+}
+
+// 依次接受所有等待中的连接，各写入一份指标后关闭。连接是非阻塞的：
+// 套接字缓冲区写满（对方不读）时放弃该连接，不让抓取方拖住监控线程
+void TelemetryReporter::serveClients(const std::string &text)
+{
+    while (true)
+    {
+        int client = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0)
+            return;
+        size_t sent = 0;
+        while (sent < text.size())
+        {
+            ssize_t written = send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                break;
+            sent += written;
+        }
+        close(client);
+    }
+}
+
+// 写入临时文件后改名，抓取方不会读到写了一半的文件
+void TelemetryReporter::writeMetricsFile(const std::string &text)
+{
+    std::string temporary = options.metricsPath + ".tmp";
+    FILE *file = std::fopen(temporary.c_str(), "w");
+    if (!file)
+    {
+        std::perror(temporary.c_str());
+        return;
+    }
+    bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temporary.c_str(), options.metricsPath.c_str()) != 0)
+    {
+        std::perror(options.metricsPath.c_str());
+        unlink(temporary.c_str());
+    }
+}
+
+void TelemetryReporter::report()
+{
+    auto now = std::chrono::steady_clock::now();
+    StatsSnapshot snapshot = cpu.readSnapshot();
+    double seconds = std::chrono::duration<double>(now - lastReport).count();
+    double tickRate = seconds > 0 ? (snapshot.time - last.time) / seconds : 0;
+    double dispatchRate = seconds > 0 ? (snapshot.contextSwitches - last.contextSwitches) / seconds : 0;
+    last = snapshot;
+    lastReport = now;
+
+    metrics = formatPrometheus(snapshot, tickRate, dispatchRate);
+    if (!options.metricsPath.empty())
+        writeMetricsFile(metrics);
+    if (options.console)
+    {
+        std::chrono::duration<double> elapsed = now - start;
+        std::cout << "Time elapsed: " << elapsed.count() << " seconds, CPU currentTime: " << cpu.getCurrentTime()
+                  << ", ready " << snapshot.ready << ", terminated " << snapshot.terminated << "/" << snapshot.processes
+                  << ", " << tickRate << " ticks/s" << std::endl;
+    }
+}
+
+void TelemetryReporter::run(const std::atomic<bool> &stop)
+{
+    start = lastReport = std::chrono::steady_clock::now();
+    last = cpu.readSnapshot();
+    if (!options.socketPath.empty())
+        openSocket();
+
+    auto interval = std::chrono::milliseconds(options.intervalMs);
+    auto nextReport = start;
+    while (!stop)
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= nextReport)
+        {
+            report();
+            nextReport = now + interval;
+        }
+
+        // 等待连接或下一次输出，最多 100ms 以便及时响应停止请求
+        int timeout = static_cast<int>(std::min<long long>(100, std::chrono::duration_cast<std::chrono::milliseconds>(nextReport - now).count()));
+        if (listenFd >= 0)
+        {
+            pollfd entry{listenFd, POLLIN, 0};
+            if (poll(&entry, 1, std::max(timeout, 0)) > 0)
+                serveClients(metrics);
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::max(timeout, 0)));
+        }
+    }
+    report();
+}
@@ -0,0 +1,51 @@
+// telemetry.h
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "allhead.h"
+#include "sched_stats.h"
+
+class CPU;
+
+// 监控输出：定期读取 CPU 发布的统计快照（无锁），输出到控制台、
+// Prometheus 文本格式文件（先写临时文件再原子改名），以及本地 Unix 套接字（每个连接返回一份当前指标）
+class TelemetryReporter
+{
+public:
+    struct Options
+    {
+        int intervalMs = 2000;       // 输出间隔
+        std::string metricsPath;     // Prometheus 文本文件，为空则不写
+        std::string socketPath;      // Unix 套接字路径，为空则不监听
+        bool console = true;         // 是否在控制台输出进度
+    };
+
+    TelemetryReporter(const CPU &cpu, const Options &options);
+    ~TelemetryReporter();
+
+    TelemetryReporter(const TelemetryReporter &) = delete;
+    TelemetryReporter &operator=(const TelemetryReporter &) = delete;
+
+    // 运行直到 stop 为真；stop 置位后输出最后一次快照再返回
+    void run(const std::atomic<bool> &stop);
+
+    // 将快照格式化为 Prometheus 文本格式；tickRate 为每秒推进的模拟 tick 数
+    static std::string formatPrometheus(const StatsSnapshot &snapshot, double tickRate, double dispatchRate);
+
+private:
+    bool openSocket();
+    void serveClients(const std::string &metrics);
+    void writeMetricsFile(const std::string &metrics);
+    void report();
+
+    const CPU &cpu;
+    Options options;
+    int listenFd = -1;
+
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point lastReport;
+    StatsSnapshot last;
+    std::string metrics; // 最近一次格式化的指标，套接字连接直接返回
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,86 @@
+// terminal.cpp
+#include "terminal.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sstream>
+#include <unistd.h>
+
+Terminal::~Terminal()
+{
+    if (ownsFd)
+        close(fd);
+}
+
+// 标准输入的打开文件描述可能与 shell 共享，因此不设置 O_NONBLOCK，而是先 poll 再读
+void Terminal::openStdin()
+{
+    fd = STDIN_FILENO;
+    ownsFd = false;
+    eof = false;
+}
+
+bool Terminal::openScript(const std::string &path, std::string &error)
+{
+    int scriptFd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (scriptFd < 0)
+    {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    if (ownsFd)
+        close(fd);
+    fd = scriptFd;
+    ownsFd = true;
+    eof = false;
+    return true;
+}
+
+bool Terminal::poll(int timeoutMs)
+{
+    if (eof)
+        return false;
+    size_t before = tokens.size();
+    // 第一次按调用者给定的时间等待，之后只取走已到达的输入
+    for (int wait = timeoutMs; !eof; wait = 0)
+    {
+        pollfd entry{fd, POLLIN, 0};
+        int ready = ::poll(&entry, 1, wait);
+        if (ready < 0 && errno == EINTR)
+            break;
+        if (ready <= 0)
+        {
+            if (ready < 0)
+                std::perror("terminal");
+            eof = ready < 0;
+            break;
+        }
+
+        char buffer[4096];
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count < 0 && (errno == EINTR || errno == EAGAIN))
+            break;
+        if (count < 0)
+            std::perror("terminal");
+        if (count <= 0)
+            eof = true;
+        else
+            partial.append(buffer, count);
+        splitLines();
+    }
+    return tokens.size() > before || eof;
+}
+
+void Terminal::splitLines()
+{
+    size_t end = eof ? partial.size() : partial.rfind('\n');
+    if (end == std::string::npos)
+        return;
+    std::istringstream lines(partial.substr(0, end));
+    std::string token;
+    while (lines >> token)
+        tokens.push_back(token);
+    partial.erase(0, end + (eof ? 0 : 1));
+}
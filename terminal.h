@@ -0,0 +1,59 @@
+// terminal.h
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include "pcb.h"
+#include <deque>
+
+// 模拟终端：从宿主机标准输入或脚本文件读取输入，按行缓冲（行结束后才交给进程，与终端的规范模式一致），
+// 再按空白切分为记号，供进程的 std::cin 读取。只在 poll 报告可读后才读取，调度线程不会阻塞在读上；
+// 等待输入的进程挂在 readers 上，不占用 CPU
+class Terminal
+{
+public:
+    Terminal() {}
+    ~Terminal();
+
+    Terminal(const Terminal &) = delete;
+    Terminal &operator=(const Terminal &) = delete;
+
+    // 以宿主机标准输入作为终端
+    void openStdin();
+
+    // 以脚本文件作为终端输入，读完即输入结束；失败时返回 false 并在 error 中说明原因
+    bool openScript(const std::string &path, std::string &error);
+
+    bool isOpen() const { return fd >= 0; }
+
+    // 输入已结束（或终端未打开），缓冲中的记号仍可读取
+    bool atEof() const { return eof; }
+
+    // 读取已到达的输入，没有输入时最多等待 timeoutMs 毫秒（-1 表示一直等到有输入或输入结束）。
+    // 得到新的记号或输入结束时返回 true
+    bool poll(int timeoutMs);
+
+    // 缓冲中完整输入行的记号数
+    size_t available() const { return tokens.size(); }
+
+    std::string take()
+    {
+        std::string token = std::move(tokens.front());
+        tokens.pop_front();
+        return token;
+    }
+
+    // 阻塞在终端上等待输入的进程，按阻塞顺序
+    ProcessList readers;
+
+private:
+    // 把缓冲中已结束的行切分为记号；输入结束时最后不完整的一行也算作一行
+    void splitLines();
+
+    int fd = -1;
+    bool ownsFd = false;
+    bool eof = true;
+    std::string partial; // 尚未遇到换行的输入
+    std::deque<std::string> tokens;
+};
+
+#endif // TERMINAL_H
@@ -0,0 +1,58 @@
+// tests/check.h
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// 测试用的最小断言库：断言失败时输出位置与两边的值并计数，不中止当前测试；
+// 每个测试文件是一个可执行文件，main 依次 RUN_TEST，最后以 testResult() 作为退出码交给 ctest
+inline int &testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline void reportFailure(const char *file, int line, const std::string &message)
+{
+    testFailures()++;
+    std::cerr << file << ":" << line << ": check failed: " << message << std::endl;
+}
+
+#define CHECK(condition)                                         \
+    do                                                           \
+    {                                                            \
+        if (!(condition))                                        \
+            reportFailure(__FILE__, __LINE__, #condition);       \
+    } while (false)
+
+#define CHECK_EQ(actual, expected)                                                                      \
+    do                                                                                                  \
+    {                                                                                                   \
+        const auto &checkActual = (actual);                                                             \
+        const auto &checkExpected = (expected);                                                         \
+        if (!(checkActual == checkExpected))                                                            \
+        {                                                                                               \
+            std::ostringstream checkMessage;                                                            \
+            checkMessage << #actual << " == " << #expected << " (" << checkActual << " vs " << checkExpected << ")"; \
+            reportFailure(__FILE__, __LINE__, checkMessage.str());                                      \
+        }                                                                                               \
+    } while (false)
+
+#define RUN_TEST(function)                                      \
+    do                                                          \
+    {                                                           \
+        int failuresBefore = testFailures();                    \
+        function();                                             \
+        std::cout << (testFailures() == failuresBefore ? "[ OK ] " : "[FAIL] ") << #function << std::endl; \
+    } while (false)
+
+inline int testResult()
+{
+    if (testFailures() > 0)
+        std::cerr << testFailures() << " checks failed." << std::endl;
+    return testFailures() == 0 ? 0 : 1;
+}
+
+#endif // TESTS_CHECK_H
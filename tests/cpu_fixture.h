@@ -0,0 +1,14 @@
+// tests/cpu_fixture.h
+#ifndef TESTS_CPU_FIXTURE_H
+#define TESTS_CPU_FIXTURE_H
+
+#include "cpu.h"
+
+// 测试中的 CPU 不模拟指令耗时与空闲等待，也不输出逐条调度日志
+inline void quiet(CPU &cpu)
+{
+    cpu.setSimulatedDelays(0, 0);
+    cpu.setVerbose(false);
+}
+
+#endif // TESTS_CPU_FIXTURE_H
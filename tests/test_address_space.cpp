@@ -0,0 +1,128 @@
+// tests/test_address_space.cpp
+// 写时复制的地址空间，以及协程进程 fork 后父子进程的内存互不影响
+#include "check.h"
+#include "cpu_fixture.h"
+#include <sstream>
+
+static int wordAt(const AddressSpace &space, int address)
+{
+    int value = -1;
+    CHECK(space.read(address, value));
+    return value;
+}
+
+static void testReadWriteAndBounds()
+{
+    AddressSpace space(1000);
+    CHECK_EQ(space.pageCount(), 16);
+    // 从未写过的页读出为 0
+    CHECK_EQ(wordAt(space, 999), 0);
+    CHECK(space.write(0, 7));
+    CHECK(space.write(999, 9));
+    CHECK_EQ(wordAt(space, 0), 7);
+    CHECK_EQ(wordAt(space, 999), 9);
+    int value;
+    CHECK(!space.read(1000, value));
+    CHECK(!space.read(-1, value));
+    CHECK(!space.write(1000, 1));
+    // 首次写入分配零页，不算写时复制
+    CHECK_EQ(space.copiedPages(), 0);
+}
+
+static void testForkSharesUntilWrite()
+{
+    // 多于 64 页，页表有两层
+    const int words = AddressSpace::PAGE_WORDS * AddressSpace::FANOUT * 3;
+    AddressSpace parent(words);
+    for (int address = 0; address < words; address += AddressSpace::PAGE_WORDS)
+        parent.write(address, address);
+
+    AddressSpace child = parent.fork();
+    CHECK_EQ(child.size(), words);
+    CHECK_EQ(wordAt(child, AddressSpace::PAGE_WORDS * 5), AddressSpace::PAGE_WORDS * 5);
+    CHECK_EQ(child.copiedPages(), 0);
+
+    // 子进程写两个页，只复制这两个页；父进程看不到子进程的写入
+    child.write(AddressSpace::PAGE_WORDS * 5, -1);
+    child.write(AddressSpace::PAGE_WORDS * 5 + 1, -2);
+    child.write(words - 1, -3);
+    CHECK_EQ(child.copiedPages(), 2);
+    CHECK_EQ(wordAt(parent, AddressSpace::PAGE_WORDS * 5), AddressSpace::PAGE_WORDS * 5);
+    CHECK_EQ(wordAt(parent, words - 1), 0);
+    CHECK_EQ(wordAt(child, AddressSpace::PAGE_WORDS * 5), -1);
+
+    // 父进程之后的写入同样不影响子进程；子进程已独占的页再写不再复制
+    parent.write(AddressSpace::PAGE_WORDS * 6, 42);
+    CHECK_EQ(parent.copiedPages(), 1);
+    CHECK_EQ(wordAt(child, AddressSpace::PAGE_WORDS * 6), AddressSpace::PAGE_WORDS * 6);
+    child.write(AddressSpace::PAGE_WORDS * 5 + 2, -4);
+    CHECK_EQ(child.copiedPages(), 2);
+}
+
+static void testSaveRestore()
+{
+    AddressSpace space(5000);
+    space.write(10, 1);
+    space.write(4999, 2);
+    AddressSpace shared = space.fork();
+
+    std::stringstream stream;
+    CheckpointWriter writer(stream);
+    shared.save(writer);
+    AddressSpace restored;
+    CheckpointReader reader(stream);
+    restored.restore(reader);
+    CHECK(reader.ok());
+    CHECK_EQ(restored.size(), 5000);
+    CHECK_EQ(wordAt(restored, 10), 1);
+    CHECK_EQ(wordAt(restored, 4999), 2);
+    CHECK_EQ(wordAt(restored, 11), 0);
+    // 恢复后的页面不与原地址空间共享
+    restored.write(10, 5);
+    CHECK_EQ(wordAt(space, 10), 1);
+    CHECK_EQ(restored.copiedPages(), 0);
+}
+
+// 父进程写入后 fork，子进程改写同一地址后退出；父进程回收子进程后读到的仍是自己的值
+static int parentSaw = -1;
+static int childSaw = -1;
+static int childStatus = -1;
+
+static Program child()
+{
+    childSaw = co_await loadWord(100);
+    co_await storeWord(100, 2);
+    co_await computeFor(2);
+    co_await exitProcess(7);
+}
+
+static Program parent()
+{
+    co_await storeWord(100, 1);
+    co_await forkProcess(child());
+    ChildStatus status = co_await waitChild();
+    childStatus = status.status;
+    parentSaw = co_await loadWord(100);
+}
+
+static void testForkedProgramsHavePrivateMemory()
+{
+    CPU cpu(2);
+    quiet(cpu);
+    PCB process(1, 1, 0, 0, PCB::READY, nullptr, 4096);
+    cpu.addProgram(&process, parent());
+    cpu.manageTimeAndSchedule(0);
+    CHECK(cpu.isFinished());
+    CHECK_EQ(childSaw, 1);
+    CHECK_EQ(childStatus, 7);
+    CHECK_EQ(parentSaw, 1);
+}
+
+int main()
+{
+    RUN_TEST(testReadWriteAndBounds);
+    RUN_TEST(testForkSharesUntilWrite);
+    RUN_TEST(testSaveRestore);
+    RUN_TEST(testForkedProgramsHavePrivateMemory);
+    return testResult();
+}
@@ -0,0 +1,103 @@
+// tests/test_cache_model.cpp
+// 缓存模型：组内 LRU 替换，进程切换使 L1 未命中增多，访存停顿折算为不推进进程的 tick
+#include "check.h"
+#include "cpu_fixture.h"
+
+static void testLruWithinSet()
+{
+    // 2 路、1 组：访问 1、2、1 后装入 3 替换最久未用的 2
+    CacheLevel level(2, 2);
+    CHECK(!level.access(1));
+    CHECK(!level.access(2));
+    CHECK(level.access(1));
+    CHECK(!level.access(3));
+    CHECK(level.access(1));
+    CHECK(!level.access(2));
+    CHECK_EQ(level.hitCount(), 2);
+    CHECK_EQ(level.missCount(), 4);
+}
+
+// 两个进程的工作集各 384 行，单独都放得进 512 行的 L1，合起来放不下
+static CacheHierarchy::Config twoWorkingSets()
+{
+    CacheHierarchy::Config config;
+    config.workingSetWords = 384 * config.lineWords;
+    return config;
+}
+
+static void runWithCache(CacheHierarchy &cache, int timeSlice, const std::vector<int> &runTimes)
+{
+    CPU cpu(timeSlice);
+    quiet(cpu);
+    cpu.attachCacheModel(&cache);
+    std::vector<std::unique_ptr<PCB>> processes;
+    for (size_t i = 0; i < runTimes.size(); ++i)
+    {
+        processes.emplace_back(new PCB(static_cast<long long>(i + 1), 1, 0, runTimes[i]));
+        cpu.addProcess(processes.back().get());
+    }
+    cpu.manageTimeAndSchedule(0);
+    CHECK(cpu.isFinished());
+}
+
+static void testSwitchesDriveL1MissesUp()
+{
+    // 同样 800 个 tick 的计算：一个进程独占时只有冷启动未命中；
+    // 两个进程每个 tick 轮换时互相挤掉对方的行，每次切换还有内核代码占用缓存
+    CacheHierarchy alone(twoWorkingSets());
+    runWithCache(alone, 1, {800});
+    CacheHierarchy shared(twoWorkingSets());
+    runWithCache(shared, 1, {400, 400});
+
+    // 冷启动：工作集 384 行加内核切换代码 64 行
+    CHECK_EQ(alone.switchCount(), 1);
+    CHECK_EQ(alone.level(0).missCount(), 384 + 64);
+    CHECK(shared.switchCount() >= 799);
+    CHECK(shared.level(0).missCount() > 10 * alone.level(0).missCount());
+    // 两个工作集放得进 L2，被挤出 L1 的行都在 L2 命中
+    CHECK_EQ(shared.level(1).missCount(), 2 * 384 + 64);
+
+    // 时间片足够长时只切换两次，L1 未命中只有冷启动
+    CacheHierarchy batched(twoWorkingSets());
+    runWithCache(batched, 1000, {400, 400});
+    CHECK_EQ(batched.switchCount(), 2);
+    CHECK_EQ(batched.level(0).missCount(), 2 * 384 + 64);
+}
+
+static void testStallTicksDoNotAdvance()
+{
+    // 每个未命中的访存多花费若干周期，满 cyclesPerTick 个周期占用一个 tick，但进程不推进
+    CacheHierarchy cache;
+    CPU cpu(5);
+    quiet(cpu);
+    cpu.attachCacheModel(&cache);
+    PCB process(1, 1, 0, 100);
+    cpu.addProcess(&process);
+    cpu.manageTimeAndSchedule(0);
+    CHECK(cpu.isFinished());
+    CHECK_EQ(process.getUsedRunTime(), 100);
+    CHECK(cpu.getStallTicks() > 0);
+    CHECK_EQ(process.finishTime, 100 + cpu.getStallTicks());
+    CHECK_EQ(cpu.getStats().busyTime(), 100 + cpu.getStallTicks());
+
+    // 各级延迟相同时访存没有停顿
+    CacheHierarchy::Config flat;
+    flat.l2Latency = flat.llcLatency = flat.memoryLatency = flat.l1Latency;
+    CacheHierarchy fast(flat);
+    CPU other(5);
+    quiet(other);
+    other.attachCacheModel(&fast);
+    PCB same(1, 1, 0, 100);
+    other.addProcess(&same);
+    other.manageTimeAndSchedule(0);
+    CHECK_EQ(other.getStallTicks(), 0);
+    CHECK_EQ(same.finishTime, 100);
+}
+
+int main()
+{
+    RUN_TEST(testLruWithinSet);
+    RUN_TEST(testSwitchesDriveL1MissesUp);
+    RUN_TEST(testStallTicksDoNotAdvance);
+    return testResult();
+}
@@ -0,0 +1,191 @@
+// tests/test_checkpoint.cpp
+// 检查点：暂停、保存、恢复到新的 CPU 后继续运行，结果与不中断的运行一致
+#include "check.h"
+#include "cpu_fixture.h"
+#include "workload.h"
+#include <map>
+
+static const std::vector<std::string> instructions = {"int a = 1;", "a = a + 1;", "std::cout << a;"};
+
+struct Run
+{
+    explicit Run(int timeSlice) : cpu(timeSlice)
+    {
+        quiet(cpu);
+    }
+
+    // 每三个进程中有一个带指令，检查点须保存指令内存与程序计数器
+    void load(const std::vector<ProcessSpec> &specs)
+    {
+        for (const ProcessSpec &spec : specs)
+        {
+            processes.emplace_back(spec.createPCB());
+            if (spec.pid % 3 == 0)
+                cpu.loadProgram(processes.back().get(), instructions);
+            cpu.addProcess(processes.back().get());
+        }
+    }
+
+    CPU cpu;
+    std::vector<std::unique_ptr<PCB>> processes;
+};
+
+// 各进程的（完成时刻, 首次运行时刻, 等待时间）
+static std::map<long long, std::tuple<int, int, long long>> outcome(const CPU &cpu)
+{
+    std::map<long long, std::tuple<int, int, long long>> result;
+    cpu.forEachTerminated([&](const PCB *pcb)
+                          { result[pcb->getPid()] = {pcb->finishTime, pcb->firstRunTime, pcb->waitingTime}; });
+    return result;
+}
+
+static std::string checkpointAt(Run &run, int policy, int time)
+{
+    run.cpu.pauseAt(time);
+    run.cpu.manageTimeAndSchedule(policy);
+    std::ostringstream out;
+    CHECK(run.cpu.saveCheckpoint(out));
+    return out.str();
+}
+
+static void testRoundTripMatchesUninterruptedRun()
+{
+    std::vector<ProcessSpec> specs = Workload::generate(40, 7);
+    for (int policy : {0, 4, 7, 9})
+    {
+        Run reference(2);
+        reference.load(specs);
+        reference.cpu.manageTimeAndSchedule(policy);
+
+        Run paused(2);
+        paused.load(specs);
+        std::string checkpoint = checkpointAt(paused, policy, 300);
+        // 暂停发生在到达 300 之后的第一次调度决策前
+        int pausedAt = paused.cpu.getCurrentTime();
+        CHECK(pausedAt >= 300);
+
+        // 恢复到新的 CPU 继续运行
+        Run restored(2);
+        std::istringstream in(checkpoint);
+        std::string error;
+        CHECK(restored.cpu.restoreCheckpoint(in, error));
+        CHECK_EQ(restored.cpu.getCurrentTime(), pausedAt);
+        CHECK_EQ(restored.cpu.getProcessCount(), 40);
+        restored.cpu.manageTimeAndSchedule(policy);
+
+        // 原 CPU 也从暂停点继续
+        paused.cpu.manageTimeAndSchedule(policy);
+
+        CHECK_EQ(outcome(reference.cpu).size(), 40u);
+        CHECK(outcome(restored.cpu) == outcome(reference.cpu));
+        CHECK(outcome(paused.cpu) == outcome(reference.cpu));
+        CHECK_EQ(restored.cpu.getCurrentTime(), reference.cpu.getCurrentTime());
+    }
+}
+
+// 缓存模型与功耗模型下，各进程的（停顿周期, 计算访存次数, 能量）
+static std::map<long long, std::tuple<long long, long long, double>> modelOutcome(const CPU &cpu)
+{
+    std::map<long long, std::tuple<long long, long long, double>> result;
+    for (const PCB *pcb : cpu.getProcesses())
+        result[pcb->getPid()] = {pcb->stallCycles, pcb->cacheAccesses, pcb->energy};
+    return result;
+}
+
+static void testCacheAndPowerStateSurviveCheckpoint()
+{
+    // 恢复到连接了新模型的 CPU：缓存内容、停顿、频率档与能量都从检查点继续，与不中断的运行一致
+    std::vector<ProcessSpec> specs = Workload::generate(40, 5);
+    CacheHierarchy referenceCache, pausedCache, restoredCache;
+    PowerModel referencePower, pausedPower, restoredPower;
+
+    Run reference(2);
+    reference.cpu.attachCacheModel(&referenceCache);
+    reference.cpu.attachPowerModel(&referencePower);
+    reference.load(specs);
+    reference.cpu.manageTimeAndSchedule(0);
+
+    Run paused(2);
+    paused.cpu.attachCacheModel(&pausedCache);
+    paused.cpu.attachPowerModel(&pausedPower);
+    paused.load(specs);
+    std::string checkpoint = checkpointAt(paused, 0, 300);
+    CHECK(paused.cpu.getStallTicks() > 0);
+
+    Run restored(2);
+    restored.cpu.attachCacheModel(&restoredCache);
+    restored.cpu.attachPowerModel(&restoredPower);
+    std::istringstream in(checkpoint);
+    std::string error;
+    CHECK(restored.cpu.restoreCheckpoint(in, error));
+    CHECK_EQ(restored.cpu.getStallTicks(), paused.cpu.getStallTicks());
+    CHECK_EQ(restored.cpu.getEnergy(), paused.cpu.getEnergy());
+    restored.cpu.manageTimeAndSchedule(0);
+
+    CHECK(outcome(restored.cpu) == outcome(reference.cpu));
+    CHECK(modelOutcome(restored.cpu) == modelOutcome(reference.cpu));
+    CHECK_EQ(restored.cpu.getStallTicks(), reference.cpu.getStallTicks());
+    CHECK_EQ(restored.cpu.getEnergy(), reference.cpu.getEnergy());
+    CHECK_EQ(restoredCache.level(2).missCount(), referenceCache.level(2).missCount());
+    CHECK_EQ(restoredCache.switchCount(), referenceCache.switchCount());
+    CHECK_EQ(restoredPower.frequencyChanges(), referencePower.frequencyChanges());
+
+    // 没有连接模型的 CPU 也能恢复同一份检查点
+    Run plain(2);
+    std::istringstream again(checkpoint);
+    CHECK(plain.cpu.restoreCheckpoint(again, error));
+    CHECK_EQ(plain.cpu.getStallTicks(), paused.cpu.getStallTicks());
+}
+
+static void testBranchesAreIndependent()
+{
+    // 同一份检查点分出两个分支，以不同策略继续
+    Run run(2);
+    run.load(Workload::generate(30, 11));
+    std::string checkpoint = checkpointAt(run, 0, 100);
+
+    Run fcfs(2), srtf(2);
+    std::string error;
+    std::istringstream first(checkpoint), second(checkpoint);
+    CHECK(fcfs.cpu.restoreCheckpoint(first, error));
+    CHECK(srtf.cpu.restoreCheckpoint(second, error));
+    fcfs.cpu.manageTimeAndSchedule(1);
+    srtf.cpu.manageTimeAndSchedule(4);
+    CHECK(fcfs.cpu.isFinished() && srtf.cpu.isFinished());
+    CHECK(outcome(fcfs.cpu) != outcome(srtf.cpu));
+    // 总工作量相同，两个分支同时结束
+    CHECK_EQ(fcfs.cpu.getCurrentTime(), srtf.cpu.getCurrentTime());
+}
+
+static void testCorruptCheckpointIsRejected()
+{
+    Run run(2);
+    run.load(Workload::generate(20, 3));
+    std::string checkpoint = checkpointAt(run, 0, 50);
+
+    Run truncated(2);
+    std::istringstream in(checkpoint.substr(0, checkpoint.size() / 2));
+    std::string error;
+    CHECK(!truncated.cpu.restoreCheckpoint(in, error));
+    CHECK(!error.empty());
+    // 读取失败时 CPU 不被修改
+    CHECK_EQ(truncated.cpu.getProcessCount(), 0);
+    CHECK_EQ(truncated.cpu.getCurrentTime(), 0);
+
+    Run wrongMagic(2);
+    std::istringstream garbage("not a checkpoint at all");
+    CHECK(!wrongMagic.cpu.restoreCheckpoint(garbage, error));
+
+    // 已有进程的 CPU 不能恢复
+    std::istringstream valid(checkpoint);
+    CHECK(!run.cpu.restoreCheckpoint(valid, error));
+}
+
+int main()
+{
+    RUN_TEST(testRoundTripMatchesUninterruptedRun);
+    RUN_TEST(testCacheAndPowerStateSurviveCheckpoint);
+    RUN_TEST(testBranchesAreIndependent);
+    RUN_TEST(testCorruptCheckpointIsRejected);
+    return testResult();
+}
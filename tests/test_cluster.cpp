@@ -0,0 +1,135 @@
+// tests/test_cluster.cpp
+// 多节点集群：窗口同步不改变节点上的调度，结果与线程数无关，迁移不丢失作业，节点时间由共享时钟的本地时钟维护
+#include "check.h"
+#include "cluster.h"
+#include "cpu_fixture.h"
+
+static const int builtinPolicies[] = {0, 1, 2, 3, 4, 7, 8, 9};
+
+static Cluster::Options clusterOptions(int nodes, int policy, int timeSlice)
+{
+    Cluster::Options options;
+    options.nodes = nodes;
+    options.policy = policy;
+    options.timeSlice = timeSlice;
+    options.migrateThreshold = 0;
+    options.threads = 1;
+    return options;
+}
+
+static void submitAll(Cluster &cluster, const std::vector<ProcessSpec> &specs)
+{
+    for (const ProcessSpec &spec : specs)
+    {
+        std::string error;
+        CHECK(cluster.submit(spec, error));
+    }
+}
+
+static void testSingleNodeMatchesStandaloneCpu()
+{
+    // 60 个作业挤在约 60 个 tick 内到达，单节点上排队上千个 tick，跨越数百个窗口。
+    // 按到达顺序加入 CPU，与集群分配作业的顺序一致（CFS 与彩票调度以加入顺序区分同等的进程）
+    std::vector<ProcessSpec> specs = Workload::generate(60, 5);
+    std::stable_sort(specs.begin(), specs.end(), [](const ProcessSpec &a, const ProcessSpec &b)
+                     { return a.arrivalTime < b.arrivalTime; });
+    for (int policy : builtinPolicies)
+    {
+        Cluster::Options options = clusterOptions(1, policy, 3);
+        Cluster cluster(options);
+        submitAll(cluster, specs);
+        CHECK(cluster.run());
+        CHECK_EQ(cluster.completedJobs(), 60);
+
+        // 同一负载直接在一个 CPU 上运行，到达时刻加上前端到节点的延迟
+        CPU cpu(options.timeSlice);
+        quiet(cpu);
+        cpu.setLotterySeed(options.seed);
+        std::vector<std::unique_ptr<PCB>> processes;
+        for (ProcessSpec spec : specs)
+        {
+            spec.arrivalTime += options.network.frontEndLatency;
+            processes.emplace_back(spec.createPCB());
+            cpu.addProcess(processes.back().get());
+        }
+        cpu.manageTimeAndSchedule(policy);
+
+        long long sum = 0;
+        long long makespan = 0;
+        for (size_t i = 0; i < specs.size(); ++i)
+        {
+            sum += processes[i]->finishTime - specs[i].arrivalTime;
+            makespan = std::max<long long>(makespan, processes[i]->finishTime);
+        }
+        CHECK_EQ(cluster.makespan(), makespan);
+        CHECK_EQ(cluster.turnaroundTimes().mean(), static_cast<double>(sum) / specs.size());
+    }
+}
+
+static double meanTurnaround(int policy, int timeSlice)
+{
+    Cluster cluster(clusterOptions(1, policy, timeSlice));
+    submitAll(cluster, Workload::generate(60, 5));
+    CHECK(cluster.run());
+    return cluster.turnaroundTimes().mean();
+}
+
+static void testPoliciesDifferAcrossWindows()
+{
+    // 窗口只有 2 个 tick；若窗口边界抢占运行中的进程，FCFS 与长时间片的轮转都会退化成时间片为 2 的轮转
+    double fcfs = meanTurnaround(1, 8);
+    double roundRobin = meanTurnaround(0, 8);
+    double shortSlice = meanTurnaround(0, 2);
+    CHECK(fcfs != roundRobin);
+    CHECK(roundRobin != shortSlice);
+    // 运行时间 1~50，时间片 8 的轮转让短作业先完成，平均周转时间比 FCFS 长（所有作业几乎同时到达）
+    CHECK(fcfs < roundRobin);
+}
+
+static void testResultsIndependentOfThreadsWithMigration()
+{
+    std::vector<ProcessSpec> specs = Workload::generate(2000, 9);
+    for (int policy : builtinPolicies)
+    {
+        std::vector<std::tuple<long long, long long, double, long long>> results;
+        for (size_t threads : {1, 4})
+        {
+            Cluster::Options options = clusterOptions(64, policy, 2);
+            options.migrateThreshold = 2;
+            options.threads = threads;
+            Cluster cluster(options);
+            submitAll(cluster, specs);
+            CHECK(cluster.run());
+            results.push_back({cluster.completedJobs(), cluster.makespan(), cluster.turnaroundTimes().mean(),
+                               cluster.turnaroundTimes().percentile(99)});
+        }
+        CHECK_EQ(std::get<0>(results[0]), 2000);
+        CHECK(results[0] == results[1]);
+    }
+}
+
+static void testNodesKeepTimeOnSharedClock()
+{
+    // 每个节点在集群的时钟中占一个核；结束时所有本地时钟都停在最后一个窗口的终点，即发布的全局时间
+    Cluster::Options options = clusterOptions(16, 0, 2);
+    options.migrateThreshold = 2;
+    options.threads = 4;
+    Cluster cluster(options);
+    submitAll(cluster, Workload::generate(300, 3));
+    CHECK(cluster.run());
+    const SimClock &clock = cluster.getClock();
+    CHECK_EQ(clock.coreCount(), 16);
+    CHECK(clock.now() >= cluster.makespan());
+    CHECK_EQ(clock.now() % options.network.lookahead(), 0);
+    for (int core = 0; core < clock.coreCount(); ++core)
+        CHECK_EQ(clock.localNow(core), clock.now());
+}
+
+int main()
+{
+    RUN_TEST(testSingleNodeMatchesStandaloneCpu);
+    RUN_TEST(testPoliciesDifferAcrossWindows);
+    RUN_TEST(testResultsIndependentOfThreadsWithMigration);
+    RUN_TEST(testNodesKeepTimeOnSharedClock);
+    return testResult();
+}
@@ -0,0 +1,190 @@
+// tests/test_containers.cpp
+// 侵入式链表、分层时间轮与树状数组
+#include "check.h"
+#include "FenwickTree.h"
+#include "timing_wheel.h"
+#include <vector>
+
+struct Item
+{
+    int id = 0;
+    ListHook<Item> link;
+    long long expires = 0;
+};
+
+struct ItemHook
+{
+    static ListHook<Item> &of(Item *item) { return item->link; }
+    static long long &expiresOf(Item *item) { return item->expires; }
+};
+
+using ItemList = IntrusiveList<Item, ItemHook>;
+using ItemWheel = TimingWheel<Item, ItemHook>;
+
+static std::vector<int> idsOf(const ItemList &list)
+{
+    std::vector<int> ids;
+    for (Item *item : list)
+        ids.push_back(item->id);
+    return ids;
+}
+
+static void testListOrderAndRemove()
+{
+    Item items[4];
+    ItemList list;
+    for (int i = 0; i < 4; ++i)
+    {
+        items[i].id = i;
+        list.push_back(&items[i]);
+    }
+    CHECK_EQ(list.size(), 4u);
+    CHECK(list.front() == &items[0] && list.back() == &items[3]);
+
+    // 从中间、头、尾删除
+    list.remove(&items[2]);
+    CHECK((idsOf(list) == std::vector<int>{0, 1, 3}));
+    CHECK(!items[2].link.isLinked());
+    CHECK(list.pop_front() == &items[0]);
+    list.remove(&items[3]);
+    CHECK((idsOf(list) == std::vector<int>{1}));
+    CHECK(list.front() == list.back());
+
+    // 不在本链表上的元素不受影响
+    list.remove(&items[2]);
+    CHECK_EQ(list.size(), 1u);
+    list.clear();
+    CHECK(list.empty() && list.pop_front() == nullptr);
+}
+
+static void testListMoveBetweenLists()
+{
+    Item a, b;
+    a.id = 1;
+    b.id = 2;
+    ItemList first, second;
+    first.push_back(&a);
+    first.push_back(&b);
+    // 已在别的链表上的元素入队时先从原链表摘下
+    second.push_back(&a);
+    CHECK((idsOf(first) == std::vector<int>{2}));
+    CHECK((idsOf(second) == std::vector<int>{1}));
+    CHECK(second.contains(&a) && !first.contains(&a));
+    ItemList::unlink(&b);
+    CHECK(first.empty());
+    CHECK(!b.link.isLinked());
+}
+
+// 推进到 time，返回按触发顺序的 (id, 触发时刻)
+static std::vector<std::pair<int, long long>> advance(ItemWheel &wheel, long long time)
+{
+    std::vector<std::pair<int, long long>> fired;
+    wheel.advance(time, [&](Item *item)
+                  { fired.push_back({item->id, wheel.now()}); });
+    return fired;
+}
+
+static void testWheelFiresAtExpiry()
+{
+    // 各层与溢出链表：1、63、64、4095、4096、2^24 + 5 个 tick 之后
+    const long long delays[] = {1, 63, 64, 4095, 4096, (1LL << 24) + 5};
+    Item items[6];
+    ItemWheel wheel(100);
+    for (int i = 0; i < 6; ++i)
+    {
+        items[i].id = i;
+        wheel.schedule(&items[i], 100 + delays[i]);
+    }
+    CHECK_EQ(wheel.size(), 6u);
+
+    std::vector<std::pair<int, long long>> fired;
+    long long step = 1000; // 分段推进，覆盖跨段的级联
+    for (long long time = 100; time < 100 + (1LL << 24) + 10; time += step)
+    {
+        auto part = advance(wheel, time + step);
+        fired.insert(fired.end(), part.begin(), part.end());
+    }
+    CHECK_EQ(fired.size(), 6u);
+    for (size_t i = 0; i < fired.size() && i < 6; ++i)
+    {
+        CHECK_EQ(fired[i].first, static_cast<int>(i));
+        CHECK_EQ(fired[i].second, 100 + delays[i]);
+    }
+    CHECK(wheel.empty());
+}
+
+static void testWheelCancelAndReschedule()
+{
+    Item a, b, c;
+    a.id = 1;
+    b.id = 2;
+    c.id = 3;
+    ItemWheel wheel(0);
+    wheel.schedule(&a, 10);
+    wheel.schedule(&b, 20);
+    wheel.schedule(&c, 300);
+    wheel.cancel(&b);
+    CHECK(!ItemWheel::isScheduled(&b));
+    // 重设到更早的时刻
+    wheel.schedule(&c, 5);
+    CHECK_EQ(wheel.size(), 2u);
+
+    auto fired = advance(wheel, 400);
+    CHECK((fired == std::vector<std::pair<int, long long>>{{3, 5}, {1, 10}}));
+    // 过期的时刻在下一个 tick 触发
+    wheel.schedule(&a, 100);
+    fired = advance(wheel, 401);
+    CHECK((fired == std::vector<std::pair<int, long long>>{{1, 401}}));
+}
+
+static void testWheelRearmInCallback()
+{
+    // 回调中重新加入自身，形成周期为 7 的定时器
+    Item periodic;
+    periodic.id = 1;
+    ItemWheel wheel(0);
+    wheel.schedule(&periodic, 7);
+    std::vector<long long> times;
+    wheel.advance(50, [&](Item *item)
+                  {
+        times.push_back(wheel.now());
+        wheel.schedule(item, wheel.now() + 7); });
+    CHECK((times == std::vector<long long>{7, 14, 21, 28, 35, 42, 49}));
+    CHECK(ItemWheel::isScheduled(&periodic));
+}
+
+static void testFenwickResizeKeepsValues()
+{
+    FenwickTree tree(3);
+    tree.set(0, 5);
+    tree.set(2, 1);
+    // 扩容后重建，原有的值与前缀和不变
+    tree.resize(10);
+    tree.set(7, 4);
+    CHECK_EQ(tree.size(), 10);
+    CHECK_EQ(tree.sum(), 10);
+    CHECK_EQ(tree.get(2), 1);
+    // 前缀和 [5, 5, 6, 6, 6, 6, 6, 10, ...]
+    CHECK_EQ(tree.find(0), 0);
+    CHECK_EQ(tree.find(4), 0);
+    CHECK_EQ(tree.find(5), 2);
+    CHECK_EQ(tree.find(6), 7);
+    CHECK_EQ(tree.find(9), 7);
+    // 与逐个 set 建出的树一致
+    FenwickTree expected(10);
+    for (int i = 0; i < 10; ++i)
+        expected.set(i, tree.get(i));
+    for (long long target = 0; target < tree.sum(); ++target)
+        CHECK_EQ(tree.find(target), expected.find(target));
+}
+
+int main()
+{
+    RUN_TEST(testListOrderAndRemove);
+    RUN_TEST(testListMoveBetweenLists);
+    RUN_TEST(testWheelFiresAtExpiry);
+    RUN_TEST(testWheelCancelAndReschedule);
+    RUN_TEST(testWheelRearmInCallback);
+    RUN_TEST(testFenwickResizeKeepsValues);
+    return testResult();
+}
@@ -0,0 +1,245 @@
+// tests/test_control_group.cpp
+// 控制组：带宽限制按周期补充配额、父组配额约束子组、份额折算权重，以及工作负载文件中的组声明
+#include "check.h"
+#include "cpu_fixture.h"
+#include "workload.h"
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+// 在每个周期开始时暂停，返回 process 在各个已结束的周期内运行的 tick 数
+static std::vector<int> runTimePerPeriod(CPU &cpu, int policy, const PCB &process, int period)
+{
+    std::vector<int> perPeriod;
+    int previous = 0;
+    for (int time = period; !cpu.isFinished(); time += period)
+    {
+        cpu.pauseAt(time);
+        cpu.manageTimeAndSchedule(policy);
+        // 暂停发生在周期开始时的调度决策之前，尚未补充配额
+        CHECK(cpu.isFinished() || cpu.getCurrentTime() == time);
+        perPeriod.push_back(process.getUsedRunTime() - previous);
+        previous = process.getUsedRunTime();
+    }
+    return perPeriod;
+}
+
+static void testQuotaLimitsRunTimePerPeriod()
+{
+    // 配额 3/10：进程每个周期只运行 3 个 tick，之后空闲到下一个周期开始
+    CPU cpu(5);
+    quiet(cpu);
+    ControlGroup group("batch");
+    group.setBandwidth(3, 10);
+    PCB process(1, 1, 0, 12);
+    group.attach(&process);
+    cpu.addProcess(&process);
+    CHECK((runTimePerPeriod(cpu, 0, process, 10) == std::vector<int>{3, 3, 3, 3}));
+    CHECK_EQ(process.finishTime, 33);
+    CHECK_EQ(group.usageTicks(), 12);
+    // 四个周期都在第 3 个 tick 用完配额；前三个周期各限流 7 个 tick，最后一个周期尚未结束
+    CHECK_EQ(group.throttledPeriods(), 4);
+    CHECK_EQ(group.periodCount(), 3);
+    CHECK_EQ(group.throttledTicks(), 21);
+}
+
+static void testUnthrottleAtPeriodBoundary()
+{
+    // 不受限的进程在组被限流期间使用 CPU；组内进程在每个周期开始时恢复运行
+    CPU cpu(2);
+    quiet(cpu);
+    ControlGroup group("limited");
+    group.setBandwidth(2, 8);
+    PCB limited(1, 1, 0, 6);
+    PCB free(2, 1, 0, 30);
+    group.attach(&limited);
+    cpu.addProcess(&limited);
+    cpu.addProcess(&free);
+    // 每个周期开始时解除限流重新排队，在该周期内用满 2 个 tick
+    std::vector<int> perPeriod = runTimePerPeriod(cpu, 0, limited, 8);
+    CHECK_EQ(perPeriod.size(), 5u);
+    CHECK((std::vector<int>(perPeriod.begin(), perPeriod.begin() + 3) == std::vector<int>{2, 2, 2}));
+    CHECK(limited.finishTime > 16 && limited.finishTime <= 24);
+    CHECK_EQ(group.usageTicks(), 6);
+    // 工作不丢失：总运行时间之和等于结束时刻
+    CHECK_EQ(cpu.getCurrentTime(), 36);
+    CHECK_EQ(free.finishTime, 36);
+}
+
+static void testParentQuotaBoundsChildren()
+{
+    // 父组 4/10，两个子组不限：两个子组合计每个周期最多 4 个 tick
+    CPU cpu(1);
+    quiet(cpu);
+    ControlGroup parent("tenant");
+    parent.setBandwidth(4, 10);
+    ControlGroup first("web", &parent);
+    ControlGroup second("db", &parent);
+    PCB a(1, 1, 0, 8), b(2, 1, 0, 8);
+    first.attach(&a);
+    second.attach(&b);
+    cpu.addProcess(&a);
+    cpu.addProcess(&b);
+    cpu.manageTimeAndSchedule(0);
+
+    CHECK_EQ(parent.usageTicks(), 16);
+    CHECK_EQ(first.usageTicks() + second.usageTicks(), 16);
+    // 16 个 tick 需要 4 个周期，最后一个 tick 在 [30, 34) 内
+    CHECK_EQ(std::max(a.finishTime, b.finishTime), 34);
+    // 子组未设配额，从未被限流；父组在前四个周期都用完配额
+    CHECK_EQ(first.throttledPeriods(), 0);
+    CHECK_EQ(second.throttledPeriods(), 0);
+    CHECK_EQ(parent.throttledPeriods(), 4);
+    CHECK_EQ(first.path(), std::string("tenant/web"));
+
+    // 子组的配额比父组更紧时以子组为准
+    CPU tight(1);
+    quiet(tight);
+    ControlGroup outer("tenant");
+    outer.setBandwidth(4, 10);
+    ControlGroup inner("cron", &outer);
+    inner.setBandwidth(1, 10);
+    PCB job(3, 1, 0, 3);
+    inner.attach(&job);
+    tight.addProcess(&job);
+    tight.manageTimeAndSchedule(0);
+    CHECK_EQ(job.finishTime, 21);
+    CHECK_EQ(outer.throttledPeriods(), 0);
+}
+
+static void testSharesScaleStrideTickets()
+{
+    // 份额 2048 与 1024 的两个组各有一个进程，步长调度按 2:1 分配
+    CPU cpu(1);
+    quiet(cpu);
+    ControlGroup heavy("heavy", nullptr, 2048);
+    ControlGroup light("light", nullptr, 1024);
+    PCB a(1, 10, 0, 100000), b(2, 10, 0, 100000);
+    heavy.attach(&a);
+    light.attach(&b);
+    CHECK_EQ(a.getTickets(), 2 * b.getTickets());
+    cpu.addProcess(&a);
+    cpu.addProcess(&b);
+    cpu.pauseAt(300);
+    cpu.manageTimeAndSchedule(9);
+    CHECK_EQ(a.getUsedRunTime(), 200);
+    CHECK_EQ(b.getUsedRunTime(), 100);
+}
+
+static void testTicketTransferKeepsShareScale()
+{
+    // a 在份额 2048 的组中，c 不属于任何组；转让以未折算的票数计，之后各按自己的份额折算
+    ControlGroup heavy("heavy", nullptr, 2048);
+    PCB a(1, 10, 0, 10), c(2, 10, 0, 10);
+    a.setTickets(300);
+    c.setTickets(100);
+    heavy.attach(&a);
+    a.numOfpro = 0;
+    c.numOfpro = 1;
+    CHECK_EQ(a.getTickets(), 600);
+
+    LotteryPolicy policy(1);
+    policy.transferTickets(&a, &c, 100);
+    CHECK_EQ(a.getRawTickets(), 200);
+    CHECK_EQ(a.getTickets(), 400);
+    CHECK_EQ(c.getRawTickets(), 200);
+    CHECK_EQ(c.getTickets(), 200);
+    // 上限是转出方未折算的票数，至少留下 1 张
+    policy.transferTickets(&a, &c, 1000);
+    CHECK_EQ(a.getRawTickets(), 1);
+    CHECK_EQ(a.getTickets(), 2);
+    CHECK_EQ(c.getRawTickets(), 399);
+    policy.transferTickets(&c, &a, 199);
+    CHECK_EQ(a.getRawTickets(), 200);
+
+    // 就绪进程的票数立即按折算后的值生效：转让后 a 与 c 为 400:200，a 约占 2/3
+    int wins = 0;
+    const int trials = 3000;
+    for (int trial = 0; trial < trials; ++trial)
+    {
+        a.setTickets(300);
+        c.setTickets(100);
+        LotteryPolicy draw(1, trial + 1);
+        draw.onEnqueue(&a, 0);
+        draw.onEnqueue(&c, 0);
+        draw.transferTickets(&a, &c, 100);
+        if (draw.pickNext(0) == &a)
+            wins++;
+    }
+    CHECK(wins > 1850 && wins < 2150);
+}
+
+// 把 text 写入临时文件并加载为工作负载
+static bool loadText(Workload &workload, const std::string &text, std::string &error)
+{
+    char path[] = "/tmp/ossim-test-workload-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return false;
+    close(fd);
+    {
+        std::ofstream out(path);
+        out << text;
+    }
+    bool loaded = workload.load(path, error);
+    unlink(path);
+    return loaded;
+}
+
+static void testWorkloadDeclaresGroups()
+{
+    Workload workload;
+    std::string error;
+    CHECK(loadText(workload,
+                   "group tenant quota=4/10\n"
+                   "group tenant/web shares=2048\n"
+                   "process 1 1 0 8 group=tenant/web\n"
+                   "end\n"
+                   "process 2 1 0 8\n"
+                   "end\n",
+                   error));
+    CHECK_EQ(workload.groups().size(), 2u);
+    CHECK_EQ(workload.processes().size(), 2u);
+    CHECK_EQ(workload.processes()[0].group, 1);
+    CHECK_EQ(workload.processes()[1].group, -1);
+
+    std::vector<std::unique_ptr<ControlGroup>> groups = Workload::createGroups(workload.groups());
+    CHECK_EQ(groups[1]->path(), std::string("tenant/web"));
+    CHECK(groups[1]->getParent() == groups[0].get());
+    CHECK_EQ(groups[0]->getQuota(), 4);
+    CHECK_EQ(groups[0]->getPeriod(), 10);
+    CHECK_EQ(groups[1]->getShares(), 2048);
+
+    // 写出后重新加载得到相同的组与归属
+    char path[] = "/tmp/ossim-test-workload-XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+    CHECK(Workload::write(path, workload.processes(), workload.groups()));
+    Workload reloaded;
+    CHECK(reloaded.load(path, error));
+    unlink(path);
+    CHECK_EQ(reloaded.groups().size(), 2u);
+    CHECK_EQ(reloaded.groups()[0].quota, 4);
+    CHECK_EQ(reloaded.processes()[0].group, 1);
+
+    // 未声明的父组与组
+    Workload orphan;
+    CHECK(!loadText(orphan, "group tenant/web\n", error));
+    CHECK(error.find("not declared") != std::string::npos);
+    Workload unknown;
+    CHECK(!loadText(unknown, "process 1 1 0 8 group=missing\nend\n", error));
+    Workload duplicate;
+    CHECK(!loadText(duplicate, "group a\ngroup a\n", error));
+}
+
+int main()
+{
+    RUN_TEST(testQuotaLimitsRunTimePerPeriod);
+    RUN_TEST(testUnthrottleAtPeriodBoundary);
+    RUN_TEST(testParentQuotaBoundsChildren);
+    RUN_TEST(testSharesScaleStrideTickets);
+    RUN_TEST(testTicketTransferKeepsShareScale);
+    RUN_TEST(testWorkloadDeclaresGroups);
+    return testResult();
+}
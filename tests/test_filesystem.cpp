@@ -0,0 +1,200 @@
+// tests/test_filesystem.cpp
+// 文件系统：缓冲区缓存命中率、顺序读取时倍增的预读窗口、脏块的后台回写与淘汰时写回
+#include "check.h"
+#include "cpu_fixture.h"
+
+static const int BLOCK = FileSystem::BLOCK_WORDS;
+
+static FileSystem::Options smallOptions(int cacheBlocks)
+{
+    FileSystem::Options options;
+    options.blocks = 1024;
+    options.inodes = 16;
+    options.cacheBlocks = cacheBlocks;
+    return options;
+}
+
+// 内容为 0, 1, 2, ... 的文件
+static std::vector<int> sequence(int words)
+{
+    std::vector<int> contents(words);
+    for (int i = 0; i < words; ++i)
+        contents[i] = i;
+    return contents;
+}
+
+static double hitRatio(const FileSystem &fs)
+{
+    const BufferCache &cache = fs.bufferCache();
+    long long lookups = cache.hitCount() + cache.missCount();
+    return lookups ? static_cast<double>(cache.hitCount()) / lookups : 0;
+}
+
+static void testSequentialReadHitsPrefetchedBlocks()
+{
+    FileSystem fs(smallOptions(64));
+    int file = fs.createFile("input", sequence(4 * BLOCK));
+    CHECK(file >= 0);
+    AddressSpace memory(BLOCK);
+
+    // 第一次读取未命中并阻塞到读盘完成，同时预读之后的 3 块
+    FileSystem::Transfer first = fs.read(1, file, 0, BLOCK, memory, 0, 100);
+    CHECK_EQ(first.words, BLOCK);
+    CHECK(first.readyAt > 100);
+    CHECK_EQ(fs.bufferCache().prefetchCount(), 3);
+    int value = -1;
+    memory.read(BLOCK - 1, value);
+    CHECK_EQ(value, BLOCK - 1);
+
+    // 之后的块都已预读，读盘完成后读取不再等待
+    for (int block = 1; block < 4; ++block)
+    {
+        FileSystem::Transfer next = fs.read(1, file, block * BLOCK, BLOCK, memory, 0, 1000);
+        CHECK_EQ(next.words, BLOCK);
+        CHECK_EQ(next.readyAt, 1000);
+    }
+    memory.read(0, value);
+    CHECK_EQ(value, 3 * BLOCK);
+    CHECK_EQ(fs.bufferCache().missCount(), 1);
+    CHECK_EQ(fs.bufferCache().hitCount(), 3);
+    CHECK_EQ(fs.bufferCache().prefetchHitCount(), 3);
+    CHECK_EQ(hitRatio(fs), 0.75);
+
+    // 读到文件末尾为止
+    CHECK_EQ(fs.read(1, file, 4 * BLOCK - 10, BLOCK, memory, 0, 1000).words, 10);
+    CHECK_EQ(fs.read(1, file, 4 * BLOCK, BLOCK, memory, 0, 1000).words, 0);
+}
+
+static void testReadAheadWindowDoublesAndResets()
+{
+    // 文件有 100 块，超出直接块的部分经一级间接块映射
+    FileSystem fs(smallOptions(256));
+    int file = fs.createFile("big", sequence(100 * BLOCK));
+    AddressSpace memory(BLOCK);
+
+    // 顺序读取时窗口 4、8、16、32 后保持 32：每次新预读到当前块之后 window 块处
+    const long long expected[] = {4, 9, 18, 35, 36, 37};
+    for (int block = 0; block < 6; ++block)
+    {
+        fs.read(1, file, block * BLOCK, BLOCK, memory, 0, 1000 * block);
+        CHECK_EQ(fs.bufferCache().prefetchCount(), expected[block]);
+    }
+    CHECK_EQ(fs.bufferCache().missCount(), 2); // 第一块和间接块
+
+    // 跳到别处读取关闭预读，再从那里顺序读取时窗口从 4 重新开始
+    fs.read(1, file, 80 * BLOCK, BLOCK, memory, 0, 10000);
+    CHECK_EQ(fs.bufferCache().prefetchCount(), 37);
+    fs.read(1, file, 81 * BLOCK, BLOCK, memory, 0, 10000);
+    CHECK_EQ(fs.bufferCache().prefetchCount(), 41);
+
+    // 窗口倍增到 8，预读 83~90 块，其中 83~85 已在缓存中
+    fs.read(1, file, 82 * BLOCK, BLOCK, memory, 0, 10000);
+    CHECK_EQ(fs.bufferCache().prefetchCount(), 46);
+}
+
+static void testWriteBackFlushesExpiredDirtyBlocks()
+{
+    FileSystem::Options options = smallOptions(16);
+    options.flushInterval = 32;
+    options.dirtyExpire = 64;
+    FileSystem fs(options);
+    int file = fs.open("output", true);
+    CHECK(file >= 0);
+    AddressSpace memory(2 * BLOCK);
+    for (int i = 0; i < 2 * BLOCK; ++i)
+        memory.write(i, 1000 + i);
+
+    // 写入只修改缓存
+    CHECK_EQ(fs.write(1, file, 0, BLOCK, memory, 0, 0).words, BLOCK);
+    CHECK_EQ(fs.write(1, file, BLOCK, BLOCK, memory, BLOCK, 40).words, BLOCK);
+    CHECK_EQ(fs.fileSize(file), 2 * BLOCK);
+    CHECK_EQ(fs.bufferCache().dirtyCount(), 2);
+    CHECK_EQ(fs.blockDevice().writeCount(), 0);
+
+    // 每 32 个 tick 回写一次，只写回已脏了 64 个 tick 的块
+    fs.flush(0);
+    fs.flush(32);
+    CHECK_EQ(fs.bufferCache().dirtyCount(), 2);
+    fs.flush(50); // 未到下一次回写
+    fs.flush(64);
+    CHECK_EQ(fs.flushedBlockCount(), 1);
+    CHECK_EQ(fs.bufferCache().dirtyCount(), 1);
+    fs.flush(96);
+    CHECK_EQ(fs.bufferCache().dirtyCount(), 1);
+    fs.flush(128);
+    CHECK_EQ(fs.flushedBlockCount(), 2);
+    CHECK_EQ(fs.blockDevice().writeCount(), 2);
+    CHECK_EQ(fs.bufferCache().dirtyCount(), 0);
+}
+
+static void testEvictionWritesBackDirtyBlocks()
+{
+    // 缓存只有 4 块：写入的块被读取其它文件挤出时先写回，之后重新读盘得到写入的内容
+    FileSystem fs(smallOptions(4));
+    int output = fs.open("output", true);
+    int input = fs.createFile("input", sequence(8 * BLOCK));
+    AddressSpace memory(BLOCK);
+    memory.write(5, 42);
+    fs.write(1, output, 0, BLOCK, memory, 0, 0);
+
+    for (int block = 0; block < 8; block += 2) // 跳着读，不触发预读
+        fs.read(1, input, block * BLOCK, BLOCK, memory, 0, 10);
+    CHECK_EQ(fs.bufferCache().writeBackCount(), 1);
+    CHECK_EQ(fs.flushedBlockCount(), 0);
+
+    AddressSpace check(BLOCK);
+    long long misses = fs.bufferCache().missCount();
+    fs.read(2, output, 0, BLOCK, check, 0, 20);
+    CHECK_EQ(fs.bufferCache().missCount(), misses + 1);
+    int value = -1;
+    check.read(5, value);
+    CHECK_EQ(value, 42);
+}
+
+// 协程进程顺序读入文件并复制到另一个文件
+static int copied = -1;
+
+static Program copyFile()
+{
+    int in = co_await openFile("input");
+    int out = co_await openFile("copy", true);
+    copied = 0;
+    for (int offset = 0;; offset += BLOCK)
+    {
+        int count = co_await readFile(in, offset, 0, BLOCK);
+        if (count <= 0)
+            break;
+        co_await computeFor(1);
+        copied += co_await writeFile(out, offset, 0, count);
+    }
+}
+
+static void testProgramsReadThroughAttachedFileSystem()
+{
+    FileSystem fs(smallOptions(64));
+    fs.createFile("input", sequence(6 * BLOCK + 5));
+    CPU cpu(2);
+    quiet(cpu);
+    cpu.attachFileSystem(&fs);
+    PCB process(1, 1, 0, 0, PCB::READY, nullptr, BLOCK);
+    cpu.addProgram(&process, copyFile());
+    cpu.manageTimeAndSchedule(0);
+
+    CHECK(cpu.isFinished());
+    CHECK_EQ(copied, 6 * BLOCK + 5);
+    CHECK_EQ(fs.fileSize(fs.open("copy", false)), 6 * BLOCK + 5);
+    // 第一块阻塞到读盘完成，其余块由预读读入
+    CHECK_EQ(fs.bufferCache().missCount(), 1);
+    CHECK_EQ(fs.bufferCache().hitCount(), 6);
+    CHECK(process.finishTime > 7);
+}
+
+int main()
+{
+    RUN_TEST(testSequentialReadHitsPrefetchedBlocks);
+    RUN_TEST(testReadAheadWindowDoublesAndResets);
+    RUN_TEST(testWriteBackFlushesExpiredDirtyBlocks);
+    RUN_TEST(testEvictionWritesBackDirtyBlocks);
+    RUN_TEST(testProgramsReadThroughAttachedFileSystem);
+    return testResult();
+}
@@ -0,0 +1,113 @@
+// tests/test_power_model.cpp
+// 功耗模型：各调频器选择的频率档，低频运行减慢进程，能量按运行与空闲分开统计
+#include "check.h"
+#include "cpu_fixture.h"
+#include <cmath>
+
+static PowerModel::Config withGovernor(PowerModel::Governor governor)
+{
+    PowerModel::Config config;
+    config.governor = governor;
+    return config;
+}
+
+// 一个采样周期（10 个 tick）内忙 busy 个 tick，其余空闲
+static void runWindow(PowerModel &model, int busy)
+{
+    for (int i = 0; i < busy; ++i)
+        model.busyTick(false);
+    for (int i = busy; i < 10; ++i)
+        model.idleTick();
+    model.wake();
+}
+
+static void testGovernorsPickPStates()
+{
+    PowerModel::Governor governor;
+    CHECK(PowerModel::parseGovernor("ondemand", governor));
+    CHECK_EQ(governor, PowerModel::Ondemand);
+    CHECK(!PowerModel::parseGovernor("turbo", governor));
+
+    PowerModel performance(withGovernor(PowerModel::Performance));
+    runWindow(performance, 1);
+    CHECK_EQ(performance.frequency(), 3200);
+
+    PowerModel powersave(withGovernor(PowerModel::Powersave));
+    CHECK_EQ(powersave.frequency(), 800);
+    runWindow(powersave, 10);
+    CHECK_EQ(powersave.frequency(), 800);
+
+    // ondemand：目标 3200 × 利用率 / 0.8，取不低于目标的最低一档：利用率 0.5 时 2000 取 2400，
+    // 0.3 时 1200 取 1600，0.2 时 800；超过 0.8 时升到最高
+    PowerModel ondemand(withGovernor(PowerModel::Ondemand));
+    runWindow(ondemand, 5);
+    CHECK_EQ(ondemand.frequency(), 2400);
+    runWindow(ondemand, 3);
+    CHECK_EQ(ondemand.frequency(), 1600);
+    runWindow(ondemand, 2);
+    CHECK_EQ(ondemand.frequency(), 800);
+    runWindow(ondemand, 9);
+    CHECK_EQ(ondemand.frequency(), 3200);
+
+    // schedutil：目标 1.25 × 利用率 × 当前频率，利用率 0.5 时逐个窗口降到 2400（2000）、1600（1500），
+    // 之后稳定在 1600（1000）；满载时升到 2400（2000）
+    PowerModel schedutil(withGovernor(PowerModel::Schedutil));
+    runWindow(schedutil, 5);
+    CHECK_EQ(schedutil.frequency(), 2400);
+    runWindow(schedutil, 5);
+    CHECK_EQ(schedutil.frequency(), 1600);
+    runWindow(schedutil, 5);
+    CHECK_EQ(schedutil.frequency(), 1600);
+    runWindow(schedutil, 10);
+    CHECK_EQ(schedutil.frequency(), 2400);
+    CHECK_EQ(schedutil.frequencyChanges(), 3);
+}
+
+static void testEnergySplitsActiveAndIdle()
+{
+    // 最高频率下两个进程各运行 20 个 tick，中间空闲 80 个 tick；
+    // 之前没有空闲过，预计空闲时长为 0，进入唤醒无延迟的 C1
+    PowerModel model(withGovernor(PowerModel::Performance));
+    CPU cpu(5);
+    quiet(cpu);
+    cpu.attachPowerModel(&model);
+    PCB first(1, 1, 0, 20), second(2, 1, 100, 20);
+    cpu.addProcess(&first);
+    cpu.addProcess(&second);
+    cpu.manageTimeAndSchedule(1);
+    CHECK(cpu.isFinished());
+    CHECK_EQ(second.finishTime, 120);
+    CHECK_EQ(model.pstateResidency(3), 40);
+    CHECK_EQ(model.cstateResidency(0), 80);
+    CHECK_EQ(model.activeEnergyUsed(), 40 * 6.5);
+    CHECK_EQ(model.idleEnergyUsed(), 80 * 0.5);
+    CHECK_EQ(cpu.getEnergy(), 40 * 6.5 + 80 * 0.5);
+    CHECK_EQ(first.energy, 20 * 6.5);
+    CHECK_EQ(model.wakeupCount(), 1);
+    CHECK_EQ(model.frequencyChanges(), 0);
+}
+
+static void testLowFrequencySlowsProgress()
+{
+    // 800 MHz 每个 tick 只完成 1/4 个 tick 的工作：20 个 tick 的进程运行 80 个 tick，能量按低频功率计
+    PowerModel model(withGovernor(PowerModel::Powersave));
+    CPU cpu(5);
+    quiet(cpu);
+    cpu.attachPowerModel(&model);
+    PCB process(1, 1, 0, 20);
+    cpu.addProcess(&process);
+    cpu.manageTimeAndSchedule(1);
+    CHECK_EQ(process.getUsedRunTime(), 20);
+    CHECK_EQ(process.finishTime, 80);
+    CHECK_EQ(model.pstateResidency(0), 80);
+    CHECK(std::abs(model.activeEnergyUsed() - 80 * 0.6) < 1e-9);
+    CHECK_EQ(model.idleEnergyUsed(), 0.0);
+}
+
+int main()
+{
+    RUN_TEST(testGovernorsPickPStates);
+    RUN_TEST(testEnergySplitsActiveAndIdle);
+    RUN_TEST(testLowFrequencySlowsProgress);
+    return testResult();
+}
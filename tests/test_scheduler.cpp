@@ -0,0 +1,323 @@
+// tests/test_scheduler.cpp
+// 内置调度策略的调度顺序：对同一组小工作负载手工推算各进程的完成时刻
+#include "check.h"
+#include "cpu_fixture.h"
+#include <map>
+#include <sstream>
+
+struct Job
+{
+    int pid;
+    int priority;
+    int arrival;
+    int runTime;
+};
+
+// A 先到且最长，B/C/D 在 A 运行期间陆续到达，运行时间与优先级的排序各不相同
+static const std::vector<Job> mixedJobs = {
+    {1, 1, 0, 6},
+    {2, 4, 1, 4},
+    {3, 2, 2, 1},
+    {4, 3, 3, 2},
+};
+
+// 以编号为 policy 的内置策略运行到结束，返回各进程的完成时刻
+static std::map<int, int> finishTimes(const std::vector<Job> &jobs, int policy, int timeSlice)
+{
+    CPU cpu(timeSlice);
+    quiet(cpu);
+    std::vector<std::unique_ptr<PCB>> processes;
+    for (const Job &job : jobs)
+    {
+        processes.emplace_back(new PCB(job.pid, job.priority, job.arrival, job.runTime));
+        cpu.addProcess(processes.back().get());
+    }
+    cpu.manageTimeAndSchedule(policy);
+    std::map<int, int> finished;
+    for (const auto &pcb : processes)
+        finished[static_cast<int>(pcb->getPid())] = pcb->finishTime;
+    return finished;
+}
+
+static void testFcfs()
+{
+    std::map<int, int> expected = {{1, 6}, {2, 10}, {3, 11}, {4, 13}};
+    CHECK(finishTimes(mixedJobs, 1, 2) == expected);
+}
+
+static void testShortestJobFirst()
+{
+    // A 不可抢占，之后按运行时间 C(1)、D(2)、B(4)
+    std::map<int, int> expected = {{1, 6}, {2, 13}, {3, 7}, {4, 9}};
+    CHECK(finishTimes(mixedJobs, 3, 2) == expected);
+}
+
+static void testShortestRemainingTimeFirst()
+{
+    // B 到达时剩余 4 < 5 抢占 A，C 到达时剩余 1 < 3 抢占 B；之后 B(3)、D(2) 按剩余时间
+    std::map<int, int> expected = {{1, 13}, {2, 8}, {3, 3}, {4, 5}};
+    CHECK(finishTimes(mixedJobs, 4, 2) == expected);
+}
+
+static void testHighestPriorityFirst()
+{
+    // A 不可抢占，之后按优先级 B(4)、D(3)、C(2)
+    std::map<int, int> expected = {{1, 6}, {2, 10}, {3, 13}, {4, 12}};
+    CHECK(finishTimes(mixedJobs, 2, 2) == expected);
+}
+
+static void testRoundRobin()
+{
+    // 时间片 2：新到达的进程排在时间片用完的进程之前
+    std::map<int, int> expected = {{1, 13}, {2, 11}, {3, 5}, {4, 9}};
+    CHECK(finishTimes(mixedJobs, 0, 2) == expected);
+    // 时间片足够长时退化为 FCFS
+    CHECK(finishTimes(mixedJobs, 0, 100) == finishTimes(mixedJobs, 1, 2));
+}
+
+static void testTerminatedInFinishingOrder()
+{
+    // SRTF 下完成顺序为 C、D、B、A，与进程表顺序不同
+    CPU cpu(2);
+    quiet(cpu);
+    std::vector<std::unique_ptr<PCB>> processes;
+    for (const Job &job : mixedJobs)
+    {
+        processes.emplace_back(new PCB(job.pid, job.priority, job.arrival, job.runTime));
+        cpu.addProcess(processes.back().get());
+    }
+    cpu.manageTimeAndSchedule(4);
+    std::vector<long long> order;
+    cpu.forEachTerminated([&](const PCB *pcb)
+                          { order.push_back(pcb->getPid()); });
+    CHECK((order == std::vector<long long>{3, 4, 2, 1}));
+}
+
+// 先计算 first 个 tick，等待 I/O 1 个 tick，再计算 second 个 tick
+static Program twoBursts(int first, int second)
+{
+    co_await computeFor(first);
+    co_await ioWait(1);
+    if (second > 0)
+        co_await computeFor(second);
+}
+
+// A 的区间为 6、1，B 为 2、5，C 不阻塞、一次运行 10 个 tick，都在 0 时到达；以非抢占 SJF 运行，
+// 返回完成顺序，并给出各进程最后的预测值
+static std::vector<long long> sjfOrder(bool predict, std::map<int, double> &predictions)
+{
+    CPU cpu(2);
+    quiet(cpu);
+    if (predict)
+        cpu.enableBurstPrediction(0.5, 4);
+    PCB a(1, 1, 0, 7), b(2, 1, 0, 7), c(3, 1, 0, 10);
+    cpu.addProgram(&a, twoBursts(6, 1));
+    cpu.addProgram(&b, twoBursts(2, 5));
+    cpu.addProcess(&c);
+    cpu.manageTimeAndSchedule(3);
+    CHECK(cpu.isFinished());
+    std::vector<long long> order;
+    cpu.forEachTerminated([&](const PCB *pcb)
+                          { order.push_back(pcb->getPid()); });
+    for (const PCB *pcb : {&a, &b, &c})
+        predictions[static_cast<int>(pcb->getPid())] = pcb->getPredictedBurst();
+    return order;
+}
+
+static void testBurstPredictionOrder()
+{
+    // alpha = 0.5，tau(0) = 4，三者预测相同时按到达顺序。A 运行 6 个 tick 后阻塞，tau = 0.5 * 6 + 0.5 * 4 = 5；
+    // B 运行 2 个 tick 后阻塞，tau = 0.5 * 2 + 0.5 * 4 = 3；8 时 C（4）先于 A（5）运行到 18，
+    // 之后 B（3）先于 A（5），尽管 A 实际只剩 1 个 tick。最后 A 为 0.5 * 1 + 0.5 * 5 = 3，B 为 0.5 * 5 + 0.5 * 3 = 4，
+    // C 为 0.5 * 10 + 0.5 * 4 = 7
+    std::map<int, double> predictions;
+    CHECK((sjfOrder(true, predictions) == std::vector<long long>{3, 2, 1}));
+    CHECK_EQ(predictions[1], 3.0);
+    CHECK_EQ(predictions[2], 4.0);
+    CHECK_EQ(predictions[3], 7.0);
+
+    // 按真实剩余时间：8 时 A 只剩 1 个 tick，先于 C（10）完成；9 时 B 醒来，剩余 5 仍少于 C；不做预测
+    predictions.clear();
+    CHECK((sjfOrder(false, predictions) == std::vector<long long>{1, 2, 3}));
+    CHECK_EQ(predictions[1], 0.0);
+}
+
+// 两个一直就绪的进程按 3:1 的票数分享 CPU，暂停时比较各自已运行的时间
+static std::pair<int, int> sharesAt(int policy, int pauseTime)
+{
+    CPU cpu(1);
+    quiet(cpu);
+    PCB heavy(1, 1, 0, 100000);
+    PCB light(2, 1, 0, 100000);
+    heavy.setTickets(300);
+    light.setTickets(100);
+    cpu.addProcess(&heavy);
+    cpu.addProcess(&light);
+    cpu.pauseAt(pauseTime);
+    cpu.manageTimeAndSchedule(policy);
+    return {heavy.getUsedRunTime(), light.getUsedRunTime()};
+}
+
+static void testStrideShares()
+{
+    // 步长调度是确定性的，400 个 tick 内恰好按 3:1 分配
+    std::pair<int, int> shares = sharesAt(9, 400);
+    CHECK_EQ(shares.first, 300);
+    CHECK_EQ(shares.second, 100);
+}
+
+static void testLotteryShares()
+{
+    // 彩票调度只在期望上成比例：2000 次抽签中重的进程约占 3/4
+    std::pair<int, int> shares = sharesAt(8, 2000);
+    CHECK_EQ(shares.first + shares.second, 2000);
+    CHECK(shares.first > 1400 && shares.first < 1600);
+}
+
+static void testContextSwitchesCountProcessChanges()
+{
+    // 时间片 1 时独自运行的进程每个 tick 都被重新分派，但只有一次上下文切换
+    CPU alone(1);
+    quiet(alone);
+    PCB only(1, 1, 0, 10);
+    alone.addProcess(&only);
+    alone.manageTimeAndSchedule(0);
+    CHECK_EQ(alone.getContextSwitches(), 1);
+
+    // 两个进程以时间片 2 交替：A A B B A A B B ... 各 6 个 tick，共 6 次切换
+    CPU shared(2);
+    quiet(shared);
+    PCB a(1, 1, 0, 6), b(2, 1, 0, 6);
+    shared.addProcess(&a);
+    shared.addProcess(&b);
+    shared.manageTimeAndSchedule(0);
+    CHECK_EQ(shared.getContextSwitches(), 6);
+}
+
+static void testRedispatchAfterQuantumIsNotASwitch()
+{
+    // A 运行 6 个 tick，时间片 2，在 0、2、4 时被分派；B 在 20 时到达。只有首次分派 A 和换成 B 算切换。
+    // 在 A 的两次分派之间保存检查点并恢复到新的 CPU，恢复后重新分派 A 仍不算切换，缓存模型也不计内核切换开销
+    CPU cpu(2);
+    quiet(cpu);
+    PCB a(1, 1, 0, 6), b(2, 1, 20, 4);
+    cpu.addProcess(&a);
+    cpu.addProcess(&b);
+    cpu.pauseAt(3);
+    cpu.manageTimeAndSchedule(0);
+    CHECK_EQ(cpu.getContextSwitches(), 1);
+    std::stringstream checkpoint;
+    CHECK(cpu.saveCheckpoint(checkpoint));
+
+    CPU restored(2);
+    quiet(restored);
+    CacheHierarchy cache;
+    restored.attachCacheModel(&cache);
+    std::string error;
+    CHECK(restored.restoreCheckpoint(checkpoint, error));
+    restored.manageTimeAndSchedule(0);
+    CHECK(restored.isFinished());
+    CHECK_EQ(restored.getContextSwitches(), 2);
+    CHECK_EQ(cache.switchCount(), 1);
+}
+
+// 两个一直就绪的进程，重的优先级 25（nice -5，权重 3121），轻的优先级 20（nice 0，权重 1024）。
+// 以同一个 CFS 策略对象逐 tick 暂停，返回每个 tick 运行的进程，并给出两者在 ticks 个 tick 内运行的时间
+static std::string cfsOrder(int targetLatency, int ticks, std::pair<int, int> &shares)
+{
+    CPU cpu(1);
+    quiet(cpu);
+    PCB heavy(1, 25, 0, 100000), light(2, 20, 0, 100000);
+    cpu.addProcess(&heavy);
+    cpu.addProcess(&light);
+    CfsPolicy policy(targetLatency, 2);
+    std::string order;
+    for (int time = 1; time <= ticks; ++time)
+    {
+        int before = heavy.getUsedRunTime();
+        cpu.pauseAt(time, true);
+        cpu.manageTimeAndSchedule(policy);
+        order += heavy.getUsedRunTime() > before ? '1' : '2';
+    }
+    shares = {heavy.getUsedRunTime(), light.getUsedRunTime()};
+    return order;
+}
+
+static void testCfsWeightedShares()
+{
+    std::pair<int, int> shares;
+    // 目标延迟 12：重的进程先被选中（进程序号小），时间片 12 * 3121 / 4145 = 9；之后轻的进程 vruntime 为 0，
+    // 时间片 max(2, 12 * 1024 / 4145) = 2，运行后 vruntime 2 个 tick 仍小于重的进程的 9 * 1024 / 3121 ≈ 2.95，再运行一片
+    std::string order = cfsOrder(12, 2000, shares);
+    CHECK_EQ(order.substr(0, 15), std::string("111111111222211"));
+    // 长期按权重 3121:1024 分配，重的进程约占 75.3%
+    CHECK_EQ(shares.first + shares.second, 2000);
+    CHECK(shares.first > 1480 && shares.first < 1530);
+
+    // 目标延迟 48：时间片为 36 与 11，切换更少，份额不变
+    order = cfsOrder(48, 2000, shares);
+    CHECK_EQ(order.substr(0, 36), std::string(36, '1'));
+    CHECK_EQ(order.substr(36, 11), std::string(11, '2'));
+    CHECK(shares.first > 1480 && shares.first < 1530);
+}
+
+// 两个周期任务 (周期 5, WCET 2) 与 (周期 7, WCET 4)，利用率 2/5 + 4/7 ≈ 0.97：不超过 1，EDF 可调度；
+// 超过两个任务的 RM 界 2(√2 - 1) ≈ 0.83，RM 在第一个超周期内错过截止期。
+// 以同一个策略对象逐 tick 暂停，返回每个 tick 运行的任务（空闲为 0）
+static std::string realTimeOrder(bool rateMonotonic, int &fastMisses, int &slowMisses)
+{
+    CPU cpu(100);
+    quiet(cpu);
+    PCB fast(1, 1, 0, 0), slow(2, 1, 0, 0);
+    fast.setRealTimeParams(5, 0, 2);
+    slow.setRealTimeParams(7, 0, 4);
+    cpu.addProcess(&fast);
+    cpu.addProcess(&slow);
+    RealTimePolicy policy(rateMonotonic);
+    std::string order;
+    for (int time = 1; time <= 35; ++time)
+    {
+        int before = fast.getUsedRunTime() + 2 * slow.getUsedRunTime();
+        cpu.pauseAt(time, true);
+        cpu.manageTimeAndSchedule(policy);
+        order += static_cast<char>('0' + fast.getUsedRunTime() + 2 * slow.getUsedRunTime() - before);
+    }
+    cpu.manageTimeAndSchedule(policy);
+    CHECK(cpu.isFinished());
+    fastMisses = fast.deadlineMisses;
+    slowMisses = slow.deadlineMisses;
+    return order;
+}
+
+static void testEdfMeetsDeadlinesRmMisses()
+{
+    int fastMisses = -1, slowMisses = -1;
+    // EDF：5 时释放的快任务作业（截止期 10）不抢占截止期为 7 的慢任务；15 时快任务（截止期 20）
+    // 抢占慢任务（截止期 21）；30 时截止期同为 35，不抢占。35 个 tick 中空闲 1 个，没有错过截止期
+    CHECK_EQ(realTimeOrder(false, fastMisses, slowMisses), std::string("11222211222211211222112222112222110"));
+    CHECK_EQ(fastMisses, 0);
+    CHECK_EQ(slowMisses, 0);
+
+    // RM：周期短的快任务始终优先；慢任务的第一个作业到 7 时只执行了 3 个 tick，被丢弃，之后的作业都能完成
+    CHECK_EQ(realTimeOrder(true, fastMisses, slowMisses), std::string("11222112221120211222112221122211220"));
+    CHECK_EQ(fastMisses, 0);
+    CHECK_EQ(slowMisses, 1);
+}
+
+int main()
+{
+    RUN_TEST(testFcfs);
+    RUN_TEST(testShortestJobFirst);
+    RUN_TEST(testShortestRemainingTimeFirst);
+    RUN_TEST(testHighestPriorityFirst);
+    RUN_TEST(testRoundRobin);
+    RUN_TEST(testTerminatedInFinishingOrder);
+    RUN_TEST(testBurstPredictionOrder);
+    RUN_TEST(testStrideShares);
+    RUN_TEST(testLotteryShares);
+    RUN_TEST(testCfsWeightedShares);
+    RUN_TEST(testContextSwitchesCountProcessChanges);
+    RUN_TEST(testRedispatchAfterQuantumIsNotASwitch);
+    RUN_TEST(testEdfMeetsDeadlinesRmMisses);
+    return testResult();
+}
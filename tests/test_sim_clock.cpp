@@ -0,0 +1,44 @@
+// tests/test_sim_clock.cpp
+// 多核模拟时钟：各核独立推进本地时钟，在同步时发布所有本地时钟的最小值，全局时间单调不减
+#include "check.h"
+#include "sim_clock.h"
+
+static void testSingleCoreReadsLocalClock()
+{
+    SimClock clock;
+    CHECK_EQ(clock.coreCount(), 1);
+    clock.tick();
+    clock.tick(0, 4);
+    CHECK_EQ(clock.now(), 5);
+    CHECK_EQ(clock.localNow(0), 5);
+    clock.reset(20);
+    CHECK_EQ(clock.now(), 20);
+}
+
+static void testSynchronizePublishesMinimum()
+{
+    SimClock clock(3);
+    clock.tick(0, 10);
+    clock.tick(1, 4);
+    clock.tick(2, 7);
+    // 同步之前全局时间不随本地时钟变化
+    CHECK_EQ(clock.now(), 0);
+    CHECK_EQ(clock.synchronize(), 4);
+    CHECK_EQ(clock.now(), 4);
+
+    // 落后的核追上之前全局时间不变；advanceTo 不会使本地时钟倒退
+    clock.advanceTo(1, 2);
+    CHECK_EQ(clock.localNow(1), 4);
+    clock.advanceTo(1, 12);
+    CHECK_EQ(clock.synchronize(), 7);
+    clock.advanceTo(2, 15);
+    CHECK_EQ(clock.synchronize(), 10);
+    CHECK_EQ(clock.localNow(0), 10);
+}
+
+int main()
+{
+    RUN_TEST(testSingleCoreReadsLocalClock);
+    RUN_TEST(testSynchronizePublishesMinimum);
+    return testResult();
+}
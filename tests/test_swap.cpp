@@ -0,0 +1,171 @@
+// tests/test_swap.cpp
+// 准入控制与中级调度：内存不足时新进程挂起等待，换出再换入后地址空间内容不变，挂起状态的转换不破坏就绪计数
+#include "check.h"
+#include "cpu_fixture.h"
+#include <sstream>
+#include <unistd.h>
+
+static std::string memoryReport(const CPU &cpu)
+{
+    std::ostringstream out;
+    cpu.displayMemoryReport(out);
+    return out.str();
+}
+
+static bool openSwap(SwapDevice &swap, int pages)
+{
+    std::string error;
+    std::string path = "/tmp/ossim-test-swap-" + std::to_string(getpid());
+    bool opened = swap.open(path, pages, error);
+    CHECK(opened);
+    return opened;
+}
+
+static int wordAt(const PCB &process, int address)
+{
+    int value = -1;
+    process.addressSpace.read(address, value);
+    return value;
+}
+
+// 就绪计数与处于 READY、SUSPENDED_READY 的进程数一致（运行中的进程不算就绪）
+static void checkReadyCount(const CPU &cpu, const std::vector<PCB *> &processes)
+{
+    int ready = 0;
+    for (const PCB *pcb : processes)
+        if (pcb->getCurrentState() == PCB::READY || pcb->getCurrentState() == PCB::SUSPENDED_READY)
+            ready++;
+    CHECK_EQ(cpu.getStats().readyProcesses(), ready);
+}
+
+static void testAdmissionHoldsArrivals()
+{
+    // 限额 1000 字，每个进程 400 字：前两个准入，第三个等到有进程结束才准入
+    CPU cpu(2);
+    quiet(cpu);
+    cpu.setMemoryLimit(1000);
+    PCB a(1, 1, 0, 10, PCB::READY, nullptr, 400);
+    PCB b(2, 1, 0, 10, PCB::READY, nullptr, 400);
+    PCB c(3, 1, 0, 10, PCB::READY, nullptr, 400);
+    cpu.addProcess(&a);
+    cpu.addProcess(&b);
+    cpu.addProcess(&c);
+
+    cpu.pauseAt(5);
+    cpu.manageTimeAndSchedule(1);
+    CHECK_EQ(c.getCurrentState(), PCB::BLOCKED);
+    CHECK_EQ(c.getUsedRunTime(), 0);
+    checkReadyCount(cpu, {&a, &b, &c});
+
+    cpu.manageTimeAndSchedule(1);
+    CHECK(cpu.isFinished());
+    // 不插队：c 在 a 结束、腾出内存之后才开始运行
+    CHECK(c.firstRunTime >= a.finishTime);
+    CHECK_EQ(c.finishTime, 30);
+    CHECK(memoryReport(cpu).find("peak resident 800 words, 1 arrivals held") != std::string::npos);
+    CHECK_EQ(cpu.getStats().readyProcesses(), 0);
+}
+
+// 写入内存后长时间等待 I/O，期间被换出；醒来换入后读回写入的值
+static int valuesRead[3] = {-1, -1, -1};
+
+static Program writeWaitRead()
+{
+    const int addresses[3] = {0, 100, 255};
+    for (int i = 0; i < 3; ++i)
+        co_await storeWord(addresses[i], 1000 + i);
+    co_await ioWait(60);
+    for (int i = 0; i < 3; ++i)
+        valuesRead[i] = co_await loadWord(addresses[i]);
+}
+
+static void testSwapRoundTripKeepsContents()
+{
+    SwapDevice swap;
+    if (!openSwap(swap, 16))
+        return;
+    CPU cpu(2);
+    quiet(cpu);
+    cpu.setMemoryLimit(300);
+    cpu.attachSwap(&swap, 2);
+    // writer 阻塞期间 other 到达，放不下时换出阻塞的 writer
+    PCB writer(1, 1, 0, 0, PCB::READY, nullptr, 256);
+    PCB other(2, 1, 5, 20, PCB::READY, nullptr, 256);
+    cpu.addProgram(&writer, writeWaitRead());
+    cpu.addProcess(&other);
+    std::vector<PCB *> all = {&writer, &other};
+
+    bool sawSuspendedBlocked = false;
+    bool sawSuspendedReady = false;
+    for (int time = 1; !cpu.isFinished(); ++time)
+    {
+        cpu.pauseAt(time);
+        cpu.manageTimeAndSchedule(0);
+        checkReadyCount(cpu, all);
+        sawSuspendedBlocked |= writer.getCurrentState() == PCB::SUSPENDED_BLOCKED;
+        sawSuspendedReady |= writer.getCurrentState() == PCB::SUSPENDED_READY;
+        if (writer.getCurrentState() == PCB::SUSPENDED_BLOCKED)
+            CHECK_EQ(swap.used(), 3); // 写过的 0、1、3 页
+    }
+    CHECK(sawSuspendedBlocked);
+    CHECK(sawSuspendedReady);
+    CHECK_EQ(cpu.getSwapIns(), 1);
+    CHECK_EQ(swap.used(), 0);
+    CHECK_EQ(valuesRead[0], 1000);
+    CHECK_EQ(valuesRead[1], 1001);
+    CHECK_EQ(valuesRead[2], 1002);
+    CHECK(memoryReport(cpu).find("1 swap-outs (3 pages), 1 swap-ins (3 pages)") != std::string::npos);
+    CHECK_EQ(cpu.getStats().readyProcesses(), 0);
+}
+
+static void testSuspendedReadyKeepsReadyCount()
+{
+    // 三个就绪进程都已驻留；限额降低后超出限额，就绪进程也被换出成为 SUSPENDED_READY，
+    // 仍计入就绪进程，换入后照常运行完
+    SwapDevice swap;
+    if (!openSwap(swap, 16))
+        return;
+    CPU cpu(4);
+    quiet(cpu);
+    cpu.setMemoryLimit(1000);
+    cpu.attachSwap(&swap, 3);
+    PCB a(1, 1, 0, 20, PCB::READY, nullptr, 256);
+    PCB b(2, 1, 0, 20, PCB::READY, nullptr, 256);
+    PCB c(3, 1, 0, 20, PCB::READY, nullptr, 256);
+    a.addressSpace.write(7, 77);
+    c.addressSpace.write(200, 99);
+    cpu.addProcess(&a);
+    cpu.addProcess(&b);
+    cpu.addProcess(&c);
+    std::vector<PCB *> all = {&a, &b, &c};
+
+    cpu.pauseAt(6);
+    cpu.manageTimeAndSchedule(0);
+    checkReadyCount(cpu, all);
+    cpu.setMemoryLimit(300);
+    bool sawSuspendedReady = false;
+    for (int time = 7; !cpu.isFinished(); ++time)
+    {
+        cpu.pauseAt(time);
+        cpu.manageTimeAndSchedule(0);
+        checkReadyCount(cpu, all);
+        for (const PCB *pcb : all)
+            sawSuspendedReady |= pcb->getCurrentState() == PCB::SUSPENDED_READY;
+        // 驻留且换入已完成的进程内容不变
+        CHECK(!a.resident || !a.swapSlots.empty() || wordAt(a, 7) == 77);
+        CHECK(!c.resident || !c.swapSlots.empty() || wordAt(c, 200) == 99);
+    }
+    CHECK(sawSuspendedReady);
+    CHECK(cpu.getSwapIns() >= 1);
+    CHECK_EQ(swap.used(), 0);
+    CHECK_EQ(a.getUsedRunTime() + b.getUsedRunTime() + c.getUsedRunTime(), 60);
+    CHECK_EQ(cpu.getStats().readyProcesses(), 0);
+}
+
+int main()
+{
+    RUN_TEST(testAdmissionHoldsArrivals);
+    RUN_TEST(testSwapRoundTripKeepsContents);
+    RUN_TEST(testSuspendedReadyKeepsReadyCount);
+    return testResult();
+}
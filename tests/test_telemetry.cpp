@@ -0,0 +1,176 @@
+// tests/test_telemetry.cpp
+// 监控输出：统计快照的 Prometheus 文本格式，以及监控线程写出的指标文件与 Unix 套接字返回的指标
+#include "check.h"
+#include "cpu_fixture.h"
+#include "telemetry.h"
+#include <cstring>
+#include <fstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool contains(const std::string &text, const std::string &line)
+{
+    return text.find(line) != std::string::npos;
+}
+
+static void testFormatPrometheus()
+{
+    StatsSnapshot snapshot;
+    snapshot.time = 40;
+    snapshot.processes = 5;
+    snapshot.ready = 1;
+    snapshot.terminated = 3;
+    snapshot.contextSwitches = 9;
+    snapshot.completed = 3;
+    snapshot.busyTicks = 30;
+    snapshot.idleTicks = 10;
+    snapshot.fairness = 0.5;
+    snapshot.waiting.count = 3;
+    snapshot.waiting.mean = 4;
+    snapshot.waiting.p50 = 3;
+    snapshot.waiting.p90 = 7;
+    snapshot.waiting.p99 = 8;
+    snapshot.waiting.max = 8;
+    std::string text = TelemetryReporter::formatPrometheus(snapshot, 20, 2.5);
+
+    CHECK(contains(text, "# TYPE ossim_sim_time_ticks gauge\nossim_sim_time_ticks 40\n"));
+    CHECK(contains(text, "\nossim_ready_processes 1\n"));
+    CHECK(contains(text, "\nossim_terminated_processes 3\n"));
+    // 既未就绪也未终止的进程算作阻塞
+    CHECK(contains(text, "\nossim_blocked_processes 1\n"));
+    CHECK(contains(text, "# TYPE ossim_context_switches_total counter\nossim_context_switches_total 9\n"));
+    CHECK(contains(text, "\nossim_cpu_utilization 0.75\n"));
+    CHECK(contains(text, "\nossim_fairness_jain 0.5\n"));
+    CHECK(contains(text, "\nossim_tick_rate 20\n"));
+    CHECK(contains(text, "\nossim_dispatch_rate 2.5\n"));
+    CHECK(contains(text, "\nossim_finished 0\n"));
+    CHECK(contains(text, "# TYPE ossim_waiting_time_ticks summary\n"
+                         "ossim_waiting_time_ticks{quantile=\"0.5\"} 3\n"
+                         "ossim_waiting_time_ticks{quantile=\"0.9\"} 7\n"
+                         "ossim_waiting_time_ticks{quantile=\"0.99\"} 8\n"
+                         "ossim_waiting_time_ticks{quantile=\"1\"} 8\n"
+                         "ossim_waiting_time_ticks_sum 12\n"
+                         "ossim_waiting_time_ticks_count 3\n"));
+    CHECK(contains(text, "\nossim_response_time_ticks_count 0\n"));
+
+    // 长时间模拟的计数超过 6 位有效数字，须按整数原样输出；实数量与 _sum 也不能被截成科学计数法
+    snapshot = StatsSnapshot();
+    snapshot.time = 12345678;
+    snapshot.processes = 3000000;
+    snapshot.terminated = 2999999;
+    snapshot.contextSwitches = 23456789;
+    snapshot.completed = 2999999;
+    snapshot.busyTicks = 12345677;
+    snapshot.idleTicks = 1;
+    snapshot.turnaround.count = 20;
+    snapshot.turnaround.mean = 1234567.5;
+    text = TelemetryReporter::formatPrometheus(snapshot, 1234567.25, 0.1);
+
+    CHECK(contains(text, "\nossim_sim_time_ticks 12345678\n"));
+    CHECK(contains(text, "\nossim_processes 3000000\n"));
+    CHECK(contains(text, "\nossim_terminated_processes 2999999\n"));
+    CHECK(contains(text, "\nossim_context_switches_total 23456789\n"));
+    CHECK(contains(text, "\nossim_completed_processes_total 2999999\n"));
+    CHECK(contains(text, "\nossim_busy_ticks_total 12345677\n"));
+    CHECK(contains(text, "\nossim_idle_ticks_total 1\n"));
+    CHECK(contains(text, "\nossim_cpu_utilization 0.9999999189999934\n"));
+    CHECK(contains(text, "\nossim_tick_rate 1234567.25\n"));
+    CHECK(contains(text, "\nossim_dispatch_rate 0.1\n"));
+    CHECK(contains(text, "\nossim_turnaround_time_ticks_sum 24691350\n"));
+}
+
+// 连接 Unix 套接字并读到对方关闭连接，连接失败时返回空串
+static std::string scrape(const std::string &path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    std::string text;
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0)
+    {
+        char buffer[4096];
+        ssize_t count;
+        while ((count = read(fd, buffer, sizeof(buffer))) > 0)
+            text.append(buffer, count);
+    }
+    close(fd);
+    return text;
+}
+
+static std::string readFile(const std::string &path)
+{
+    std::ifstream in(path);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+static void testReporterFileAndSocket()
+{
+    // 两个进程各运行 3 个 tick，结束后 CPU 发布的快照不再变化
+    CPU cpu(2);
+    quiet(cpu);
+    PCB a(1, 1, 0, 3), b(2, 1, 0, 3);
+    cpu.addProcess(&a);
+    cpu.addProcess(&b);
+    cpu.manageTimeAndSchedule(0);
+    CHECK(cpu.isFinished());
+
+    std::string prefix = "/tmp/ossim-test-telemetry-" + std::to_string(getpid());
+    TelemetryReporter::Options options;
+    options.intervalMs = 10;
+    options.metricsPath = prefix + ".prom";
+    options.socketPath = prefix + ".sock";
+    options.console = false;
+    std::atomic<bool> stop(false);
+    std::string served;
+    {
+        TelemetryReporter reporter(cpu, options);
+        std::thread thread([&]()
+                           { reporter.run(stop); });
+        // 一个连接后从不读取的抓取方不影响之后的连接
+        int idle = -1;
+        for (int attempt = 0; attempt < 200 && served.empty(); ++attempt)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (idle < 0 && access(options.socketPath.c_str(), F_OK) == 0)
+            {
+                idle = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                sockaddr_un address{};
+                address.sun_family = AF_UNIX;
+                std::strcpy(address.sun_path, options.socketPath.c_str());
+                CHECK_EQ(connect(idle, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+            }
+            if (idle >= 0)
+                served = scrape(options.socketPath);
+        }
+        stop = true;
+        thread.join();
+        close(idle);
+    }
+
+    for (const std::string &text : {served, readFile(options.metricsPath)})
+    {
+        CHECK(contains(text, "\nossim_sim_time_ticks 6\n"));
+        CHECK(contains(text, "\nossim_processes 2\n"));
+        CHECK(contains(text, "\nossim_terminated_processes 2\n"));
+        CHECK(contains(text, "\nossim_context_switches_total 4\n"));
+        CHECK(contains(text, "\nossim_busy_ticks_total 6\n"));
+        CHECK(contains(text, "\nossim_cpu_utilization 1\n"));
+        CHECK(contains(text, "\nossim_finished 1\n"));
+        CHECK(contains(text, "\nossim_turnaround_time_ticks_count 2\n"));
+    }
+    // 指标文件经临时文件改名写出；套接字在 TelemetryReporter 析构时删除
+    CHECK(access((options.metricsPath + ".tmp").c_str(), F_OK) != 0);
+    CHECK(access(options.socketPath.c_str(), F_OK) != 0);
+    unlink(options.metricsPath.c_str());
+}
+
+int main()
+{
+    RUN_TEST(testFormatPrometheus);
+    RUN_TEST(testReporterFileAndSocket);
+    return testResult();
+}
@@ -0,0 +1,133 @@
+// tests/test_terminal.cpp
+// 模拟终端：等待 std::cin 的进程不占用 CPU，输入到达后唤醒并把值存入该进程的上下文，输入结束时释放所有等待者
+#include "check.h"
+#include "cpu_fixture.h"
+#include <unistd.h>
+
+// 以管道作为终端：测试持有写端，在暂停期间写入输入
+struct Pipe
+{
+    Pipe()
+    {
+        CHECK_EQ(pipe(fds), 0);
+        std::string error;
+        CHECK(terminal.openScript("/proc/self/fd/" + std::to_string(fds[0]), error));
+    }
+    ~Pipe()
+    {
+        close(fds[0]);
+        closeWriter();
+    }
+
+    void send(const std::string &text) { CHECK_EQ(write(fds[1], text.data(), text.size()), static_cast<ssize_t>(text.size())); }
+
+    void closeWriter()
+    {
+        if (fds[1] >= 0)
+            close(fds[1]);
+        fds[1] = -1;
+    }
+
+    int fds[2] = {-1, -1};
+    Terminal terminal;
+};
+
+static void testBlockedReaderUsesNoCpu()
+{
+    Pipe input;
+    CPU cpu(2);
+    quiet(cpu);
+    cpu.attachTerminal(&input.terminal);
+    PCB reader(1, 1, 0, 3);
+    PCB worker(2, 1, 0, 100);
+    cpu.loadProgram(&reader, std::vector<std::string>{"std::cin >> x;"});
+    cpu.addProcess(&reader);
+    cpu.addProcess(&worker);
+
+    // 还没有输入：读进程执行读指令的那个 tick 之后一直阻塞，CPU 全部给计算进程
+    cpu.pauseAt(20);
+    cpu.manageTimeAndSchedule(0);
+    CHECK_EQ(reader.getCurrentState(), PCB::BLOCKED);
+    CHECK_EQ(reader.getUsedRunTime(), 0);
+    CHECK_EQ(worker.getUsedRunTime(), cpu.getCurrentTime() - 1);
+
+    // 输入到达后读进程被唤醒，读入的值存入它的上下文
+    input.send("7\n");
+    cpu.manageTimeAndSchedule(0);
+    CHECK(cpu.isFinished());
+    CHECK_EQ(reader.context.registers["x"], 7);
+    CHECK_EQ(reader.getUsedRunTime(), 3);
+    CHECK(reader.finishTime > 20);
+    // 读指令 1 个 tick 加两个进程的运行时间，等待期间没有空闲或被读进程占用的 tick
+    CHECK_EQ(cpu.getCurrentTime(), 1 + 3 + 100);
+}
+
+static void testInputGoesToTheBlockedReaders()
+{
+    // 两个进程先后阻塞，输入按阻塞顺序分给它们，各自的变量互不影响
+    Pipe input;
+    CPU cpu(1);
+    quiet(cpu);
+    cpu.attachTerminal(&input.terminal);
+    PCB first(1, 1, 0, 2), second(2, 1, 1, 2), worker(3, 1, 0, 50);
+    cpu.loadProgram(&first, std::vector<std::string>{"std::cin >> a;"});
+    cpu.loadProgram(&second, std::vector<std::string>{"std::cin >> a >> b;"});
+    cpu.addProcess(&first);
+    cpu.addProcess(&second);
+    cpu.addProcess(&worker);
+    cpu.pauseAt(10);
+    cpu.manageTimeAndSchedule(0);
+    CHECK_EQ(first.getCurrentState(), PCB::BLOCKED);
+    CHECK_EQ(second.getCurrentState(), PCB::BLOCKED);
+
+    // 一行只够 first 与 second 的第一个变量：second 继续等待
+    input.send("11 12\n");
+    cpu.pauseAt(20);
+    cpu.manageTimeAndSchedule(0);
+    CHECK_EQ(first.context.registers["a"], 11);
+    CHECK_EQ(second.getCurrentState(), PCB::BLOCKED);
+    CHECK_EQ(second.getUsedRunTime(), 0);
+
+    input.send("13\n");
+    cpu.manageTimeAndSchedule(0);
+    CHECK(cpu.isFinished());
+    CHECK_EQ(second.context.registers["a"], 12);
+    CHECK_EQ(second.context.registers["b"], 13);
+    CHECK(first.context.registers.count("b") == 0);
+}
+
+static void testEofReleasesReaders()
+{
+    // 输入结束时仍在等待的进程读到 0（与 std::cin 读取失败一致）并继续运行
+    Pipe input;
+    CPU cpu(1);
+    quiet(cpu);
+    cpu.attachTerminal(&input.terminal);
+    PCB first(1, 1, 0, 2), second(2, 1, 0, 2), worker(3, 1, 0, 30);
+    cpu.loadProgram(&first, std::vector<std::string>{"std::cin >> a >> b;"});
+    cpu.loadProgram(&second, std::vector<std::string>{"std::cin >> c;"});
+    cpu.addProcess(&first);
+    cpu.addProcess(&second);
+    cpu.addProcess(&worker);
+    cpu.pauseAt(10);
+    cpu.manageTimeAndSchedule(0);
+
+    input.send("5");
+    input.closeWriter();
+    cpu.manageTimeAndSchedule(0);
+    CHECK(cpu.isFinished());
+    CHECK(input.terminal.atEof());
+    // 最后不完整的一行在输入结束时也算一行
+    CHECK_EQ(first.context.registers["a"], 5);
+    CHECK_EQ(first.context.registers["b"], 0);
+    CHECK_EQ(second.context.registers["c"], 0);
+    CHECK_EQ(cpu.getTerminatedCount(), 3);
+}
+
+int main()
+{
+    RUN_TEST(testBlockedReaderUsesNoCpu);
+    RUN_TEST(testInputGoesToTheBlockedReaders);
+    RUN_TEST(testEofReleasesReaders);
+    return testResult();
+}
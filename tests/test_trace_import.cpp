@@ -0,0 +1,193 @@
+// tests/test_trace_import.cpp
+// 调度轨迹导入：ftrace 与 perf sched 两种格式的解析、唤醒与阻塞的换算、多 CPU 交错与无法解析的行，
+// 以及回放结果与 lookahead 无关
+#include "check.h"
+#include "cpu_fixture.h"
+#include "trace_import.h"
+#include <cstdio>
+#include <map>
+#include <unistd.h>
+
+// 各任务的（到达时刻, 完成时刻, 运行时间）
+using Outcome = std::map<long long, std::tuple<int, int, int>>;
+
+struct Replay
+{
+    Outcome outcome;
+    double meanTurnaround = 0;
+    long long switches = 0;
+    std::string stats;
+};
+
+static Replay replayText(const std::string &text, int policy, int lookahead)
+{
+    char path[] = "/tmp/ossim-test-trace-XXXXXX";
+    int fd = mkstemp(path);
+    Replay result;
+    CHECK(fd >= 0);
+    if (fd < 0)
+        return result;
+    CHECK_EQ(write(fd, text.data(), text.size()), static_cast<ssize_t>(text.size()));
+    close(fd);
+
+    TraceImporter::Options options;
+    options.lookahead = lookahead;
+    TraceImporter importer(options);
+    std::string error;
+    CHECK(importer.open(path, error));
+    unlink(path);
+    CPU cpu(2);
+    quiet(cpu);
+    cpu.setLotterySeed(7);
+    importer.replay(cpu, policy);
+    CHECK(cpu.isFinished());
+
+    cpu.forEachTerminated([&](const PCB *pcb)
+                          { result.outcome[pcb->getPid()] = {pcb->getArrivalTime(), pcb->finishTime, pcb->getUsedRunTime()}; });
+    result.meanTurnaround = cpu.getStats().turnaroundTimes().mean();
+    result.switches = cpu.getContextSwitches();
+    std::ostringstream out;
+    importer.displayStats(out);
+    result.stats = out.str();
+    return result;
+}
+
+// ftrace 格式的一行；time 为毫秒
+static std::string ftrace(int cpu, int ms, const std::string &event)
+{
+    char head[64];
+    std::snprintf(head, sizeof(head), "          task-1   [%03d] d..2 %5d.%06d: ", cpu, 1 + ms / 1000, ms % 1000 * 1000);
+    return head + event + "\n";
+}
+
+static std::string ftraceSwitch(int cpu, int ms, int prev, const char *state, int next)
+{
+    return ftrace(cpu, ms, "sched_switch: prev_comm=t" + std::to_string(prev) + " prev_pid=" + std::to_string(prev) + " prev_prio=120 prev_state=" +
+                               state + " ==> next_comm=t" + std::to_string(next) + " next_pid=" + std::to_string(next) + " next_prio=120");
+}
+
+static std::string ftraceWakeup(int cpu, int ms, int pid)
+{
+    return ftrace(cpu, ms, "sched_wakeup: comm=t" + std::to_string(pid) + " pid=" + std::to_string(pid) + " prio=120 target_cpu=000");
+}
+
+// perf script 旧版格式的一行
+static std::string perf(int cpu, int ms, const std::string &event)
+{
+    char head[64];
+    std::snprintf(head, sizeof(head), "         perf  1234 [%03d] %5d.%06d: sched:", cpu, 1 + ms / 1000, ms % 1000 * 1000);
+    return head + event + "\n";
+}
+
+static std::string perfSwitch(int cpu, int ms, int prev, const char *state, int next)
+{
+    return perf(cpu, ms, "sched_switch: t" + std::to_string(prev) + ":" + std::to_string(prev) + " [120] " + state + " ==> t" +
+                             std::to_string(next) + ":" + std::to_string(next) + " [120]");
+}
+
+static std::string perfWakeup(int cpu, int ms, int pid)
+{
+    return perf(cpu, ms, "sched_wakeup: t" + std::to_string(pid) + ":" + std::to_string(pid) + " [120] success=1 CPU:000");
+}
+
+// 10 运行 5 ms 后睡眠 20 ms，醒来运行 3 ms 退出；11 在 20 ms 到达，运行 10 ms 被抢占、再运行 7 ms 后
+// 等待 I/O 10 ms，醒来运行 2 ms 退出
+template <typename Switch, typename Wakeup>
+static std::string twoTasks(Switch sw, Wakeup wakeup)
+{
+    return wakeup(0, 0, 10) + sw(0, 0, 0, "R", 10) + sw(0, 5, 10, "S", 0) + wakeup(0, 20, 11) + sw(0, 20, 0, "R", 11) +
+           wakeup(0, 25, 10) + sw(0, 30, 11, "R+", 10) + sw(0, 33, 10, "X", 11) + sw(0, 40, 11, "D", 0) + wakeup(0, 50, 11) +
+           sw(0, 50, 0, "R", 11) + sw(0, 52, 11, "X", 0);
+}
+
+static void checkTwoTasks(const Replay &replay)
+{
+    CHECK_EQ(replay.outcome.size(), 2u);
+    // 唤醒的时刻即到达时刻；运行时间为轨迹中各次运行之和
+    CHECK_EQ(std::get<0>(replay.outcome.at(10)), 0);
+    CHECK_EQ(std::get<0>(replay.outcome.at(11)), 20);
+    CHECK_EQ(std::get<2>(replay.outcome.at(10)), 8);
+    CHECK_EQ(std::get<2>(replay.outcome.at(11)), 19);
+    // FCFS：10 运行 [0, 5) 后睡眠到 25；11 从 20 起连续运行 17 个 tick 到 37，再等待 I/O 到 47；
+    // 10 在 37 之后运行 3 个 tick，11 在 47 醒来运行 2 个 tick
+    CHECK_EQ(std::get<1>(replay.outcome.at(10)), 40);
+    CHECK_EQ(std::get<1>(replay.outcome.at(11)), 49);
+}
+
+static void testFtraceFormat()
+{
+    Replay replay = replayText(twoTasks(ftraceSwitch, ftraceWakeup), 1, 1000);
+    checkTwoTasks(replay);
+    CHECK(replay.stats.find("0 skipped") != std::string::npos);
+}
+
+static void testPerfSchedFormat()
+{
+    Replay replay = replayText(twoTasks(perfSwitch, perfWakeup), 1, 1000);
+    checkTwoTasks(replay);
+    CHECK(replay.stats.find("0 skipped") != std::string::npos);
+}
+
+static void testMalformedAndInterleavedLines()
+{
+    // 两个 CPU 同时运行 20 与 21，事件在文件中交错，CPU 1 的一个事件比前一行早；夹杂无法解析的行
+    std::string text = "# tracer: nop\n" + ftraceWakeup(0, 0, 20) + ftraceSwitch(0, 0, 0, "R", 20) + ftraceWakeup(1, 2, 21) +
+                       "garbage without any event\n" + ftraceSwitch(1, 2, 0, "R", 21) + ftraceSwitch(0, 10, 20, "X", 0) +
+                       ftraceSwitch(1, 8, 21, "X", 0) + ftrace(0, 11, "sched_switch: prev_pid=abc prev_state=S ==> next_pid=") +
+                       "          task-1   [000] d..2 not-a-time: sched_wakeup: comm=t pid=22 prio=120\n";
+    Replay replay = replayText(text, 1, 1000);
+    CHECK_EQ(replay.outcome.size(), 2u);
+    CHECK_EQ(std::get<0>(replay.outcome.at(20)), 0);
+    CHECK_EQ(std::get<0>(replay.outcome.at(21)), 2);
+    CHECK_EQ(std::get<2>(replay.outcome.at(20)), 10);
+    // 乱序的事件按前一行的时刻计，21 运行到 10 ms
+    CHECK_EQ(std::get<2>(replay.outcome.at(21)), 8);
+    // 注释、无事件的行、参数无法解析的行和时间戳无法解析的行
+    CHECK(replay.stats.find("4 skipped") != std::string::npos);
+    CHECK(replay.stats.find("2 tasks") != std::string::npos);
+}
+
+// 6 个一直可运行的任务在一个 CPU 上每 3 ms 轮换一次，偶尔睡眠，共约 1.2 s
+static std::string cpuBoundTrace()
+{
+    std::string text;
+    const int tasks = 6;
+    int running = 0;
+    int ms = 0;
+    text += ftraceSwitch(0, 0, 0, "R", 100);
+    for (int step = 1; step < 400; ++step)
+    {
+        ms += 3;
+        int next = step % tasks;
+        bool sleeps = step % 7 == 0;
+        text += ftraceSwitch(0, ms, 100 + running, sleeps ? "S" : "R", 100 + next);
+        if (sleeps)
+            text += ftraceWakeup(0, ms + 1, 100 + running);
+        running = next;
+    }
+    text += ftraceSwitch(0, ms + 3, 100 + running, "X", 0);
+    return text;
+}
+
+static void testReplayIndependentOfLookahead()
+{
+    std::string text = cpuBoundTrace();
+    for (int policy : {0, 7, 8, 9})
+    {
+        Replay shortWindows = replayText(text, policy, 50);
+        Replay oneWindow = replayText(text, policy, 100000);
+        CHECK_EQ(shortWindows.outcome.size(), 6u);
+        CHECK(shortWindows.outcome == oneWindow.outcome);
+        CHECK_EQ(shortWindows.meanTurnaround, oneWindow.meanTurnaround);
+        CHECK_EQ(shortWindows.switches, oneWindow.switches);
+    }
+}
+
+int main()
+{
+    RUN_TEST(testFtraceFormat);
+    RUN_TEST(testPerfSchedFormat);
+    RUN_TEST(testMalformedAndInterleavedLines);
+    RUN_TEST(testReplayIndependentOfLookahead);
+    return testResult();
+}
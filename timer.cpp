@@ -0,0 +1,23 @@
+// timer.cpp
+#include "timer.h"
+#include "telemetry.h"
+
+std::atomic<bool> stopTimer(false);
+
+void signalHandler(int signal)
+{
+    if (signal == SIGINT)
+    {
+        std::cout << "Received SIGINT, stopping the timer..." << std::endl;
+        stopTimer = true; // 设置标志，通知计时线程停止
+    }
+}
+
+void *countTime(void *arg)
+{
+    TelemetryReporter *reporter = static_cast<TelemetryReporter *>(arg);
+    reporter->run(stopTimer);
+
+    std::cout << "Timer stopped." << std::endl;
+    return nullptr;
+}
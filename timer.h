@@ -0,0 +1,18 @@
+// timer.h
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "allhead.h"
+
+class CPU;
+
+// 用于控制计时线程的标志
+extern std::atomic<bool> stopTimer;
+
+// SIGINT 处理：通知计时线程停止
+void signalHandler(int signal);
+
+// 计时线程入口，arg 为 TelemetryReporter*：按其配置定期输出监控数据，直到 stopTimer 置位
+void *countTime(void *arg);
+
+#endif // TIMER_H
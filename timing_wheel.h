@@ -0,0 +1,142 @@
+// timing_wheel.h
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include "intrusive_list.h"
+#include <algorithm>
+
+// 分层时间轮：4 层、每层 64 个槽，第 0 层的槽对应单个 tick，第 k 层的槽对应 64^k 个 tick，
+// 共覆盖 2^24 个 tick，更远的定时器放在溢出链表中，每转完一圈最高层时重新安放。
+// 定时器以元素内嵌的挂钩链入槽中，加入、取消、重设都是 O(1) 且不分配内存；
+// 推进时间时高层的槽在轮到时整体下放到低层（级联），每个 tick 只处理一个第 0 层的槽。
+// Hook 提供 static ListHook<T> &of(T *) 与 static long long &expiresOf(T *)
+template <typename T, typename Hook>
+class TimingWheel
+{
+public:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int LEVELS = 4;
+
+    explicit TimingWheel(long long start = 0) : current(start) {}
+
+    TimingWheel(const TimingWheel &) = delete;
+    TimingWheel &operator=(const TimingWheel &) = delete;
+
+    // 已处理到的时刻：到期时刻不晚于它的定时器都已触发
+    long long now() const { return current; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // 清空后从 start 开始计时（元素的挂钩随之解除）
+    void reset(long long start)
+    {
+        for (auto &level : wheel)
+            for (auto &slot : level)
+                slot.clear();
+        overflow.clear();
+        count = 0;
+        current = start;
+    }
+
+    static bool isScheduled(T *item) { return Hook::of(item).isLinked(); }
+
+    // 在 expires 时刻触发；已在轮中的定时器改到新时刻。不晚于 now() 的定时器在下一次推进时触发
+    void schedule(T *item, long long expires)
+    {
+        if (isScheduled(item))
+            cancel(item);
+        Hook::expiresOf(item) = expires;
+        place(item);
+        count++;
+    }
+
+    void cancel(T *item)
+    {
+        if (!isScheduled(item))
+            return;
+        List::unlink(item);
+        count--;
+    }
+
+    // 逐 tick 推进到 time，按 tick 顺序对每个到期的定时器调用 expire(item)；
+    // 回调中可以重新加入定时器
+    template <typename Expire>
+    void advance(long long time, Expire &&expire)
+    {
+        while (current < time)
+        {
+            current++;
+            if (count == 0)
+            {
+                // 轮中没有定时器时直接跳到目标时刻
+                current = time;
+                break;
+            }
+            cascade();
+            List &due = wheel[0][current & (SLOTS - 1)];
+            while (T *item = due.pop_front())
+            {
+                count--;
+                expire(item);
+            }
+        }
+    }
+
+private:
+    using List = IntrusiveList<T, Hook>;
+
+    // 按距当前时刻的远近放入对应层的槽
+    void place(T *item)
+    {
+        long long expires = std::max(Hook::expiresOf(item), current + 1);
+        long long delta = expires - current;
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            if (delta < (1LL << (SLOT_BITS * (level + 1))))
+            {
+                wheel[level][(expires >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back(item);
+                return;
+            }
+        }
+        overflow.push_back(item);
+    }
+
+    // 当前时刻是某一层槽的边界时，把该槽的定时器下放到更低的层
+    void cascade()
+    {
+        for (int level = 1; level < LEVELS; ++level)
+        {
+            if (current & ((1LL << (SLOT_BITS * level)) - 1))
+                return;
+            replace(wheel[level][(current >> (SLOT_BITS * level)) & (SLOTS - 1)]);
+        }
+        if ((current & ((1LL << (SLOT_BITS * LEVELS)) - 1)) == 0)
+            replace(overflow);
+    }
+
+    // 下放时以当前时刻为基准重新安放；恰好在当前时刻到期的进入第 0 层当前槽，随即触发
+    void replace(List &slot)
+    {
+        List pending;
+        while (T *item = slot.pop_front())
+            pending.push_back(item);
+        while (T *item = pending.pop_front())
+        {
+            long long expires = Hook::expiresOf(item);
+            long long delta = expires - current;
+            if (delta <= 0)
+                wheel[0][current & (SLOTS - 1)].push_back(item);
+            else
+                place(item);
+        }
+    }
+
+    List wheel[LEVELS][SLOTS];
+    List overflow;
+    long long current;
+    size_t count = 0;
+};
+
+#endif // TIMING_WHEEL_H
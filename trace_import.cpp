@@ -0,0 +1,414 @@
+// trace_import.cpp
+#include "trace_import.h"
+#include <charconv>
+
+static std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+        text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+        text.remove_suffix(1);
+    return text;
+}
+
+static bool parseNumber(std::string_view text, long long &value)
+{
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr != text.data();
+}
+
+// key=value 形式的参数中 key 的值（到下一个空格为止）；key 须在开头或空格之后
+static bool field(std::string_view args, std::string_view key, std::string_view &value)
+{
+    for (size_t at = args.find(key); at != std::string_view::npos; at = args.find(key, at + 1))
+    {
+        if (at != 0 && args[at - 1] != ' ')
+            continue;
+        value = args.substr(at + key.size());
+        value = value.substr(0, value.find(' '));
+        return true;
+    }
+    return false;
+}
+
+static bool numberField(std::string_view args, std::string_view key, long long &value)
+{
+    std::string_view text;
+    return field(args, key, text) && parseNumber(text, value);
+}
+
+// perf 旧版的 “comm:pid [prio] ...”：comm 中可能有冒号，取 “ [” 之前最后一个冒号后的数字
+static bool compactTask(std::string_view text, long long &pid, long long &prio)
+{
+    text = trim(text);
+    size_t bracket = text.find(" [");
+    std::string_view name = text.substr(0, bracket);
+    size_t colon = name.rfind(':');
+    if (colon == std::string_view::npos || !parseNumber(name.substr(colon + 1), pid))
+        return false;
+    prio = 120;
+    if (bracket != std::string_view::npos)
+        parseNumber(text.substr(bracket + 2), prio);
+    return true;
+}
+
+// “1234.567890” 秒换算为微秒，纳秒精度的时间戳截断到微秒
+static bool parseTimestamp(std::string_view text, long long &us)
+{
+    size_t dot = text.find('.');
+    long long seconds = 0;
+    if (!parseNumber(text.substr(0, dot), seconds))
+        return false;
+    long long fraction = 0;
+    if (dot != std::string_view::npos)
+    {
+        std::string_view digits = text.substr(dot + 1, 6);
+        if (!digits.empty() && !parseNumber(digits, fraction))
+            return false;
+        for (size_t i = digits.size(); i < 6; ++i)
+            fraction *= 10;
+    }
+    us = seconds * 1000000 + fraction;
+    return true;
+}
+
+// 内核优先级（普通任务 100~139，nice 0 为 120）换算为 PCB 的优先级（20 为 nice 0），实时任务取最高
+static int toPriority(long long prio)
+{
+    return static_cast<int>(std::max(1LL, std::min(40LL, 140 - prio)));
+}
+
+TraceImporter::TraceImporter(const Options &_options)
+    : options(_options)
+{
+    options.tickUs = std::max(1, options.tickUs);
+    options.lookahead = std::max(1, options.lookahead);
+}
+
+bool TraceImporter::open(const std::string &path, std::string &error)
+{
+    in.open(path);
+    if (!in)
+    {
+        error = "cannot open trace " + path;
+        return false;
+    }
+    return true;
+}
+
+// 任务的回放程序：按段运行、阻塞，缓存的段用完时让导入器继续读文件
+Program TraceImporter::program(Task &task)
+{
+    while (true)
+    {
+        while (task.segments.empty() && readLine())
+        {
+        }
+        if (task.segments.empty())
+            co_return;
+        Segment &segment = task.segments.front();
+        co_await computeFor(segment.run);
+        // 还没读到唤醒时，轨迹中至少阻塞到已读到的位置：先阻塞这么久，醒来后再看
+        long long slept = 0;
+        while (!segment.last && segment.block < 0)
+        {
+            long long known = tickOf(lastTime) - tickOf(segment.blockStart) - slept;
+            if (known <= 0)
+            {
+                readLine();
+                continue;
+            }
+            co_await (segment.io ? ioWait(static_cast<int>(known)) : sleepFor(static_cast<int>(known)));
+            slept += known;
+        }
+        bool last = segment.last;
+        bool io = segment.io;
+        long long remaining = segment.block - slept;
+        task.segments.pop_front();
+        buffered--;
+        if (last)
+            co_return;
+        if (remaining > 0)
+            co_await (io ? ioWait(static_cast<int>(remaining)) : sleepFor(static_cast<int>(remaining)));
+    }
+}
+
+// 读入并解析一行，文件已读完时结束所有任务并返回 false
+bool TraceImporter::readLine()
+{
+    if (atEnd)
+        return false;
+    if (!std::getline(in, line))
+    {
+        atEnd = true;
+        finishAll();
+        return false;
+    }
+    lines++;
+    parse(line);
+    return true;
+}
+
+void TraceImporter::parse(std::string_view text)
+{
+    enum Kind
+    {
+        Switch,
+        WakeupNew,
+        Wakeup,
+        Exit
+    };
+    static const std::pair<std::string_view, Kind> names[] = {
+        {"sched_switch:", Switch}, {"sched_wakeup_new:", WakeupNew}, {"sched_wakeup:", Wakeup}, {"sched_process_exit:", Exit}};
+
+    size_t at = std::string_view::npos;
+    Kind kind = Switch;
+    std::string_view name;
+    for (const auto &entry : names)
+    {
+        // 事件名之前是空格（ftrace）或 “sched:”（perf）
+        size_t found = text.find(entry.first);
+        if (found != std::string_view::npos && found > 0 && (text[found - 1] == ' ' || text[found - 1] == ':'))
+        {
+            at = found;
+            kind = entry.second;
+            name = entry.first;
+            break;
+        }
+    }
+    if (at == std::string_view::npos)
+    {
+        skipped++;
+        return;
+    }
+
+    // 时间戳是事件名之前以冒号结尾的最后一个字段
+    std::string_view head = trim(text.substr(0, at));
+    if (head.size() >= 6 && head.substr(head.size() - 6) == "sched:")
+        head = trim(head.substr(0, head.size() - 6));
+    size_t space = head.rfind(' ');
+    std::string_view stamp = head.substr(space == std::string_view::npos ? 0 : space + 1);
+    long long time;
+    if (stamp.empty() || stamp.back() != ':' || !parseTimestamp(stamp.substr(0, stamp.size() - 1), time))
+    {
+        skipped++;
+        return;
+    }
+    if (startTime < 0)
+        startTime = time;
+    time = std::max(time, lastTime); // 各 CPU 的事件偶尔乱序，不让时间倒退
+    lastTime = time;
+
+    std::string_view args = trim(text.substr(at + name.size()));
+    long long pid = 0;
+    long long prio = 120;
+    bool parsed = false;
+    if (kind == Switch)
+    {
+        long long nextPid = 0;
+        std::string_view state;
+        if (field(args, "prev_pid=", state))
+        {
+            parsed = numberField(args, "prev_pid=", pid) && field(args, "prev_state=", state) && numberField(args, "next_pid=", nextPid);
+            numberField(args, "next_prio=", prio);
+        }
+        else
+        {
+            size_t arrow = args.find("==>");
+            if (arrow != std::string_view::npos)
+            {
+                std::string_view left = args.substr(0, arrow);
+                long long ignored;
+                size_t close = left.find("] ");
+                parsed = compactTask(left, pid, ignored) && compactTask(args.substr(arrow + 3), nextPid, prio) && close != std::string_view::npos;
+                if (parsed)
+                    state = trim(left.substr(close + 2));
+            }
+        }
+        if (parsed)
+            onSwitch(time, pid, state, nextPid, static_cast<int>(prio));
+    }
+    else
+    {
+        if (numberField(args, "pid=", pid))
+        {
+            numberField(args, "prio=", prio);
+            parsed = true;
+        }
+        else
+            parsed = compactTask(args, pid, prio);
+        if (parsed && kind == Exit)
+            onExit(time, pid);
+        else if (parsed)
+            onWakeup(time, pid, static_cast<int>(prio));
+    }
+    if (parsed)
+        events++;
+    else
+        skipped++;
+}
+
+// 任务第一次出现时创建，到达时刻为出现的时刻
+TraceImporter::Task &TraceImporter::taskFor(long long pid, long long time, int prio)
+{
+    auto it = live.find(pid);
+    if (it != live.end())
+        return *it->second;
+    tasks.push_back(std::make_unique<Task>());
+    Task &task = *tasks.back();
+    int arrival = static_cast<int>(tickOf(time));
+    task.pcb = std::make_unique<PCB>(pid, toPriority(prio), arrival);
+    live[pid] = &task;
+    pending.push_back(&task);
+    return task;
+}
+
+void TraceImporter::onSwitch(long long time, long long prevPid, std::string_view prevState, long long nextPid, int nextPrio)
+{
+    bool dead = prevState.find_first_of("XZ") != std::string_view::npos;
+    // 退出事件之后的最后一次切换不再属于任何任务
+    if (prevPid != 0 && !(dead && !live.count(prevPid)))
+    {
+        Task &task = taskFor(prevPid, time, 120);
+        stopRunning(task, time);
+        if (dead)
+            endTask(task);
+        else if (prevState.empty() || prevState[0] != 'R') // R/R+ 表示被抢占，仍然就绪
+        {
+            Segment segment;
+            segment.run = ticks(task.runUs, task.runCarry);
+            segment.block = -1;
+            segment.blockStart = time;
+            segment.io = prevState.find('D') != std::string_view::npos;
+            segment.last = false;
+            task.segments.push_back(segment);
+            task.runUs = 0;
+            task.blocked = true;
+            segmentCount++;
+            peakBuffered = std::max(peakBuffered, ++buffered);
+        }
+    }
+    if (nextPid != 0)
+    {
+        Task &task = taskFor(nextPid, time, nextPrio);
+        wake(task, time); // 没有记录到唤醒时以换入为准
+        task.runStart = time;
+    }
+}
+
+void TraceImporter::onWakeup(long long time, long long pid, int prio)
+{
+    if (pid != 0)
+        wake(taskFor(pid, time, prio), time);
+}
+
+void TraceImporter::onExit(long long time, long long pid)
+{
+    auto it = live.find(pid);
+    if (it == live.end())
+        return;
+    stopRunning(*it->second, time);
+    endTask(*it->second);
+}
+
+void TraceImporter::stopRunning(Task &task, long long time)
+{
+    if (task.runStart < 0)
+        return;
+    task.runUs += time - task.runStart;
+    task.runStart = -1;
+}
+
+// 阻塞中的任务被唤醒，最后一段的阻塞时长确定
+void TraceImporter::wake(Task &task, long long time)
+{
+    if (!task.blocked)
+        return;
+    Segment &segment = task.segments.back();
+    segment.block = ticks(time - segment.blockStart, task.blockCarry);
+    task.blocked = false;
+}
+
+// 任务结束：运行完已累计的时间后退出；阻塞中的任务不再醒来，直接退出
+void TraceImporter::endTask(Task &task)
+{
+    if (task.blocked)
+    {
+        task.segments.back().last = true;
+        task.blocked = false;
+    }
+    else
+    {
+        Segment segment;
+        segment.run = ticks(task.runUs, task.runCarry);
+        segment.block = 0;
+        segment.blockStart = lastTime;
+        segment.io = false;
+        segment.last = true;
+        task.segments.push_back(segment);
+        segmentCount++;
+        peakBuffered = std::max(peakBuffered, ++buffered);
+    }
+    task.runUs = 0;
+    task.ended = true;
+    live.erase(task.pcb->getPid());
+}
+
+// 文件读完：仍在运行或阻塞的任务到此结束
+void TraceImporter::finishAll()
+{
+    for (const auto &task : tasks)
+    {
+        if (task->ended)
+            continue;
+        stopRunning(*task, lastTime);
+        endTask(*task);
+    }
+}
+
+int TraceImporter::ticks(long long us, long long &carry) const
+{
+    long long total = us + carry;
+    carry = total % options.tickUs;
+    return static_cast<int>(total / options.tickUs);
+}
+
+int TraceImporter::feed(CPU &cpu, long long horizon)
+{
+    while (!atEnd && (startTime < 0 || tickOf(lastTime) < horizon + options.lookahead))
+        readLine();
+    int count = static_cast<int>(pending.size());
+    for (Task *task : pending)
+        cpu.addProgram(task->pcb.get(), program(*task));
+    pending.clear();
+    return count;
+}
+
+// 暂停点之后读入的任务到达时刻不早于上次读到的位置，即下一个暂停点之后，交给 CPU 时总在它的将来。
+// 策略只构造一次，暂停时运行中的进程与就绪队列都留在策略里，结果与 lookahead 无关
+void TraceImporter::replay(CPU &cpu, int policy)
+{
+    std::unique_ptr<SchedulerPolicy> scheduler = cpu.makePolicy(policy);
+    if (!scheduler)
+    {
+        std::cerr << "Invalid scheduling algorithm selected." << std::endl;
+        return;
+    }
+    long long horizon = 0;
+    while (!exhausted())
+    {
+        horizon += options.lookahead;
+        feed(cpu, horizon);
+        cpu.pauseAt(static_cast<int>(horizon), true);
+        cpu.manageTimeAndSchedule(*scheduler);
+    }
+    cpu.manageTimeAndSchedule(*scheduler);
+}
+
+void TraceImporter::displayStats(std::ostream &out) const
+{
+    out << "Trace: " << lines << " lines, " << events << " scheduler events, " << skipped << " skipped, "
+        << tasks.size() << " tasks, " << segmentCount << " segments, span "
+        << (startTime < 0 ? 0 : tickOf(lastTime)) << " ticks, at most " << peakBuffered
+        << " segments buffered" << std::endl;
+}
@@ -0,0 +1,107 @@
+// trace_import.h
+#ifndef TRACE_IMPORT_H
+#define TRACE_IMPORT_H
+
+#include "cpu.h"
+#include <deque>
+#include <fstream>
+#include <string_view>
+
+// 流式导入 Linux 调度器轨迹，用于在别的调度策略下回放生产环境的负载。
+// 支持 ftrace（trace / trace-cmd report）与 perf script（perf sched record 之后）的文本输出，
+// 只使用 sched_switch、sched_wakeup、sched_wakeup_new 与 sched_process_exit 事件，参数可以是
+// key=value 形式，也可以是 perf 旧版的 “comm:pid [prio] S ==> comm:pid [prio]” 形式，其余行忽略。
+// 每个任务（pid，0 号 idle 除外）第一次出现的时刻为到达时刻，之后的轨迹切分为若干段：
+// 运行若干 tick（被抢占不结束一段）后以 S/D 等状态让出 CPU，阻塞到被唤醒为止（D 状态按 I/O 计）；
+// 以 X/Z 状态让出或退出时结束。多个 CPU 上的轨迹回放到一个模拟 CPU 上，录制时的 CPU 总需求都落在这一个 CPU 上。
+// 每个任务是一个协程进程，需要下一段时才从导入器取，导入器按需读文件，不会一次读入整个文件。
+// 阻塞时长要读到唤醒事件才知道，回放时先阻塞到已读到的位置，到时再看，因此读入位置只比模拟时钟超前约 lookahead；
+// 缓存的只有这段时间内的段与每个阻塞中任务的一段，内存与轨迹长度无关
+class TraceImporter
+{
+public:
+    struct Options
+    {
+        int tickUs = 1000;    // 1 个 tick 对应的轨迹时间（微秒）
+        int lookahead = 1000; // 每次读到模拟将要运行到的时刻之后多少 tick
+    };
+
+    explicit TraceImporter(const Options &options);
+
+    TraceImporter(const TraceImporter &) = delete;
+    TraceImporter &operator=(const TraceImporter &) = delete;
+
+    // 打开轨迹文件，失败时返回 false 并在 error 中说明原因
+    bool open(const std::string &path, std::string &error);
+
+    // 模拟即将运行到 horizon：读入轨迹到 horizon + lookahead，把其间出现的新任务交给 cpu（到达时刻都不早于 cpu 的当前时刻）。
+    // 返回交出的任务数。进程由导入器持有，导入器须比 cpu 后析构
+    int feed(CPU &cpu, long long horizon);
+
+    // 轨迹已读完，且所有任务都已交给 CPU
+    bool exhausted() const { return atEnd && pending.empty(); }
+
+    // 以编号为 policy 的内置策略回放整个轨迹：每 lookahead 个 tick 暂停一次，读入后续出现的任务；
+    // 策略只构造一次，暂停不打断运行中的进程
+    void replay(CPU &cpu, int policy);
+
+    // 读入的行数、事件数、任务数、段数与缓存的峰值
+    void displayStats(std::ostream &out = std::cout) const;
+
+    long long taskCount() const { return static_cast<long long>(tasks.size()); }
+
+private:
+    // 一段轨迹：运行 run 个 tick，然后阻塞 block 个 tick；last 表示任务运行完这段后结束
+    struct Segment
+    {
+        int run;
+        int block;            // -1 表示还没读到唤醒
+        long long blockStart; // 轨迹中开始阻塞的时刻（微秒）
+        bool io;
+        bool last;
+    };
+
+    struct Task
+    {
+        std::unique_ptr<PCB> pcb;
+        std::deque<Segment> segments; // 已读入、尚未回放完的段
+        long long runStart = -1;      // 轨迹中本次运行开始的时刻（微秒），-1 表示不在运行
+        long long runUs = 0;          // 下一段已累计的运行时间
+        long long runCarry = 0;       // 换算为 tick 时舍去的零头，计入下一段
+        long long blockCarry = 0;
+        bool blocked = false; // 最后一段正在阻塞，等待唤醒
+        bool ended = false;
+    };
+
+    Program program(Task &task);
+    bool readLine();
+    void parse(std::string_view text);
+    Task &taskFor(long long pid, long long time, int prio);
+    void onSwitch(long long time, long long prevPid, std::string_view prevState, long long nextPid, int nextPrio);
+    void onWakeup(long long time, long long pid, int prio);
+    void onExit(long long time, long long pid);
+    void stopRunning(Task &task, long long time);
+    void wake(Task &task, long long time);
+    void endTask(Task &task);
+    void finishAll();
+    long long tickOf(long long time) const { return (time - startTime) / options.tickUs; }
+    int ticks(long long us, long long &carry) const;
+
+    Options options;
+    std::ifstream in;
+    std::string line;
+    bool atEnd = false;
+    long long startTime = -1; // 第一个事件的时刻（微秒），对应模拟时刻 0
+    long long lastTime = 0;
+    std::vector<std::unique_ptr<Task>> tasks;         // 按出现顺序
+    std::unordered_map<long long, Task *> live;       // 尚未结束的任务，pid 被复用时指向新任务
+    std::vector<Task *> pending;                      // 已出现、尚未交给 CPU 的任务
+    long long lines = 0;
+    long long events = 0;
+    long long skipped = 0;  // 不是所用事件或无法解析的行
+    long long segmentCount = 0;
+    long long buffered = 0; // 当前缓存的段数
+    long long peakBuffered = 0;
+};
+
+#endif // TRACE_IMPORT_H
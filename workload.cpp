@@ -0,0 +1,237 @@
+// workload.cpp
+#include "workload.h"
+#include <fstream>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 按路径查找已声明的控制组，找不到时返回 -1
+static int findGroup(const std::vector<GroupSpec> &groups, const std::string &path)
+{
+    for (size_t i = 0; i < groups.size(); ++i)
+        if (groups[i].path == path)
+            return static_cast<int>(i);
+    return -1;
+}
+
+// 解析 group 行中关键字之后的部分
+static bool parseGroup(std::istringstream &iss, std::vector<GroupSpec> &groups, std::string &error)
+{
+    GroupSpec group;
+    if (!(iss >> group.path) || group.path.front() == '/' || group.path.back() == '/')
+    {
+        error = "expected 'group <path> [shares=<n>] [quota=<quota>/<period>]'";
+        return false;
+    }
+    if (findGroup(groups, group.path) >= 0)
+    {
+        error = "group " + group.path + " declared twice";
+        return false;
+    }
+    size_t slash = group.path.rfind('/');
+    if (slash != std::string::npos)
+    {
+        group.parent = findGroup(groups, group.path.substr(0, slash));
+        if (group.parent < 0)
+        {
+            error = "parent of group " + group.path + " is not declared";
+            return false;
+        }
+    }
+    std::string option;
+    while (iss >> option)
+    {
+        if (option.compare(0, 7, "shares=") == 0)
+            group.shares = std::atoi(option.c_str() + 7);
+        else if (option.compare(0, 6, "quota=") == 0 && option.find('/') != std::string::npos)
+        {
+            group.quota = std::atoi(option.c_str() + 6);
+            group.period = std::atoi(option.c_str() + option.find('/') + 1);
+        }
+        else
+        {
+            error = "unknown group option '" + option + "'";
+            return false;
+        }
+    }
+    if (group.quota > 0 && group.period <= 0)
+    {
+        error = "group " + group.path + " has a non-positive period";
+        return false;
+    }
+    groups.push_back(group);
+    return true;
+}
+
+Workload::~Workload()
+{
+    if (data)
+        munmap(const_cast<char *>(data), size);
+}
+
+bool Workload::load(const std::string &path, std::string &error)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        error = path + ": " + std::strerror(errno);
+        close(fd);
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size > 0)
+    {
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            error = path + ": " + std::strerror(errno);
+            close(fd);
+            return false;
+        }
+        data = static_cast<const char *>(mapping);
+        madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    std::string_view text(data ? data : "", size);
+    ProcessSpec *current = nullptr;
+    int lineNumber = 0;
+    while (!text.empty())
+    {
+        size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        if (current)
+        {
+            if (line == "end")
+                current = nullptr;
+            else
+                current->code.push_back(line);
+            continue;
+        }
+
+        if (line.empty() || line.front() == '#')
+            continue;
+        std::istringstream iss{std::string(line)};
+        std::string keyword;
+        if (line.compare(0, 6, "group ") == 0)
+        {
+            iss >> keyword;
+            if (!parseGroup(iss, groupSpecs, error))
+            {
+                error = path + ":" + std::to_string(lineNumber) + ": " + error;
+                return false;
+            }
+            continue;
+        }
+        ProcessSpec spec;
+        iss >> keyword >> spec.pid >> spec.priority >> spec.arrivalTime >> spec.totalRunTime;
+        if (keyword != "process" || !iss)
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": expected 'process <pid> <priority> <arrival> <totalRunTime>'";
+            return false;
+        }
+        // 可选的周期任务参数，之后可跟 mem=<words> 与 group=<path>
+        int *realTimeParams[] = {&spec.period, &spec.relativeDeadline, &spec.wcet};
+        size_t next = 0;
+        std::string option;
+        while (iss >> option)
+        {
+            if (option.compare(0, 4, "mem=") == 0)
+                spec.memoryWords = std::atoi(option.c_str() + 4);
+            else if (option.compare(0, 6, "group=") == 0)
+            {
+                spec.group = findGroup(groupSpecs, option.substr(6));
+                if (spec.group < 0)
+                {
+                    error = path + ":" + std::to_string(lineNumber) + ": group " + option.substr(6) + " is not declared";
+                    return false;
+                }
+            }
+            else if (next < 3)
+                *realTimeParams[next++] = std::atoi(option.c_str());
+        }
+        specs.push_back(spec);
+        current = &specs.back();
+    }
+    return true;
+}
+
+std::vector<std::unique_ptr<ControlGroup>> Workload::createGroups(const std::vector<GroupSpec> &groups)
+{
+    std::vector<std::unique_ptr<ControlGroup>> created;
+    for (const GroupSpec &spec : groups)
+    {
+        ControlGroup *parent = spec.parent >= 0 ? created[spec.parent].get() : nullptr;
+        created.emplace_back(new ControlGroup(spec.path.substr(spec.path.rfind('/') + 1), parent, spec.shares));
+        if (spec.quota > 0)
+            created.back()->setBandwidth(spec.quota, spec.period);
+    }
+    return created;
+}
+
+std::vector<ProcessSpec> Workload::generate(int count, unsigned long long seed)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> arrival(0, count);
+    std::uniform_int_distribution<int> runTime(1, 50);
+    std::uniform_int_distribution<int> priority(0, 40);
+
+    std::vector<ProcessSpec> workload;
+    for (int i = 0; i < count; ++i)
+    {
+        ProcessSpec spec;
+        spec.pid = i + 1;
+        spec.priority = priority(rng);
+        spec.arrivalTime = arrival(rng);
+        spec.totalRunTime = runTime(rng);
+        workload.push_back(spec);
+    }
+    return workload;
+}
+
+bool Workload::write(const std::string &path, const std::vector<ProcessSpec> &processes, const std::vector<GroupSpec> &groups)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    out << "# group <path> [shares=<n>] [quota=<quota>/<period>]\n";
+    out << "# process <pid> <priority> <arrival> <totalRunTime> [<period> <deadline> <wcet>] [mem=<words>] [group=<path>]\n";
+    for (const auto &group : groups)
+    {
+        out << "group " << group.path << " shares=" << group.shares;
+        if (group.quota > 0)
+            out << " quota=" << group.quota << "/" << group.period;
+        out << "\n";
+    }
+    for (const auto &spec : processes)
+    {
+        out << "process " << spec.pid << " " << spec.priority << " " << spec.arrivalTime << " " << spec.totalRunTime;
+        if (spec.period > 0)
+            out << " " << spec.period << " " << spec.relativeDeadline << " " << spec.wcet;
+        if (spec.memoryWords > 0)
+            out << " mem=" << spec.memoryWords;
+        if (spec.group >= 0)
+            out << " group=" << groups[spec.group].path;
+        out << "\n";
+        for (const auto &line : spec.code)
+            out << line << "\n";
+        out << "end\n";
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,82 @@
+// workload.h
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "allhead.h"
+#include "pcb.h"
+#include "control_group.h"
+#include <memory>
+#include <string_view>
+
+// 工作负载中一个进程的描述；code 指向工作负载文件映射中的指令行，不拷贝
+struct ProcessSpec
+{
+    long long pid = 0;
+    int priority = 0;
+    int arrivalTime = 0;
+    int totalRunTime = 0;
+    int period = 0; // 周期任务参数，period 为 0 表示非周期进程
+    int relativeDeadline = 0;
+    int wcet = 0;
+    int memoryWords = 0; // 地址空间大小，用于准入控制与交换
+    int group = -1;      // 所属控制组在 Workload::groups() 中的下标，-1 表示不属于任何组
+    std::vector<std::string_view> code;
+
+    // 按描述创建一个新的 PCB，每个模拟各自持有自己的 PCB
+    PCB *createPCB() const
+    {
+        PCB *pcb = new PCB(pid, priority, arrivalTime, totalRunTime, PCB::READY, nullptr, memoryWords);
+        if (period > 0)
+            pcb->setRealTimeParams(period, relativeDeadline, wcet);
+        return pcb;
+    }
+};
+
+// 工作负载中一个控制组的描述；path 以 / 分隔，父组须先于子组声明
+struct GroupSpec
+{
+    std::string path;
+    int parent = -1; // 父组的下标，-1 表示顶层组
+    int shares = ControlGroup::DEFAULT_SHARES;
+    int quota = 0; // 不大于 0 表示不限带宽
+    int period = 100;
+};
+
+// 只读的工作负载文件，以 mmap 映射后解析，可被多个并行模拟共享。文件格式：
+//   # 注释
+//   group <path> [shares=<n>] [quota=<quota>/<period>]
+//   process <pid> <priority> <arrival> <totalRunTime> [<period> <deadline> <wcet>] [mem=<words>] [group=<path>]
+//   <指令行>...
+//   end
+class Workload
+{
+public:
+    Workload() {}
+    ~Workload();
+
+    Workload(const Workload &) = delete;
+    Workload &operator=(const Workload &) = delete;
+
+    // 映射并解析文件，失败时返回 false 并在 error 中说明原因
+    bool load(const std::string &path, std::string &error);
+
+    const std::vector<ProcessSpec> &processes() const { return specs; }
+    const std::vector<GroupSpec> &groups() const { return groupSpecs; }
+
+    // 控制组有运行时状态，每个模拟按描述各自创建一棵，下标与 groups 一致
+    static std::vector<std::unique_ptr<ControlGroup>> createGroups(const std::vector<GroupSpec> &groups);
+
+    // 生成确定性的随机工作负载：到达时间均匀分布在 [0, count]，运行时间 1~50
+    static std::vector<ProcessSpec> generate(int count, unsigned long long seed);
+
+    // 将控制组与进程描述写成工作负载文件
+    static bool write(const std::string &path, const std::vector<ProcessSpec> &processes, const std::vector<GroupSpec> &groups = {});
+
+private:
+    const char *data = nullptr;
+    size_t size = 0;
+    std::vector<ProcessSpec> specs;
+    std::vector<GroupSpec> groupSpecs;
+};
+
+#endif // WORKLOAD_H